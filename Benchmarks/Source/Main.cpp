@@ -0,0 +1,1225 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Throughput benchmarks for the RCA filter. Build the Release configuration,
+    run with no arguments, or pass a section name to run just that section.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/RCA_MKII_SEF.h"
+#include "../../Source/RCA_OfflineRender.h"
+#include "../../Source/RCA_MK2_SEF_Bank.h"
+#include "../../Source/RCA_CoefficientCache.h"
+#include "../../Source/RCA_EnvelopeModulation.h"
+#include "../../Source/RCA_WdfNetlist.h"
+#include "../../Source/RCA_ToleranceAnalysis.h"
+#include "../../Source/RCA_ComponentFit.h"
+#include "../../Source/RCA_FixedPointLadder.h"
+#include "../../Source/RCA_ChannelWorkers.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+
+namespace
+{
+    constexpr float sampleRate = 48000.f;
+    constexpr int numSamples = 1 << 18;
+    constexpr int numRuns = 5;
+
+    std::vector<float> makeNoise (int length)
+    {
+        std::mt19937 rng (1234);
+        std::uniform_real_distribution<float> dist (-1.f, 1.f);
+
+        std::vector<float> noise ((size_t) length);
+        for (auto& x : noise)
+            x = dist (rng);
+
+        return noise;
+    }
+
+    /** Best of numRuns, in nanoseconds per item */
+    double timePerItem (int itemsPerRun, const std::function<void()>& run)
+    {
+        double best = 1.0e30;
+
+        for (int i = 0; i < numRuns; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const auto end = std::chrono::steady_clock::now();
+
+            best = std::min (best, std::chrono::duration<double, std::nano> (end - start).count() / itemsPerRun);
+        }
+
+        return best;
+    }
+
+    void printResult (const char* name, double ns, const char* unit)
+    {
+        std::printf ("  %-44s %10.2f ns/%s\n", name, ns, unit);
+    }
+
+    /** Keeps the optimiser from throwing the output away */
+    volatile float sink = 0.f;
+
+    void setUpFilter (RCA_MK2_SEF& filter, RCA_MK2_SEF::Engine engine)
+    {
+        filter.prepare (sampleRate);
+        filter.setEngine (engine);
+        filter.setHighPassCutoff (300.f);
+        filter.setLowPassCutoff (3000.f);
+    }
+
+    //==============================================================================
+    void benchmarkEngines()
+    {
+        std::printf ("engines (processSample, HP 300 Hz, LP 3 kHz)\n");
+
+        const auto input = makeNoise (numSamples);
+
+        auto run = [&] (const char* name, RCA_MK2_SEF::Engine engine)
+        {
+            RCA_MK2_SEF filter;
+            setUpFilter (filter, engine);
+
+            printResult (name, timePerItem (numSamples, [&]
+            {
+                float acc = 0.f;
+                for (auto x : input)
+                    acc += filter.processSample (x);
+                sink = acc;
+            }), "sample");
+        };
+
+        run ("wdft tree (S0..S8, P1..P4)", RCA_MK2_SEF::Engine::wdfTree);
+        run ("single R-type junction", RCA_MK2_SEF::Engine::rtype);
+        run ("flat equations", RCA_MK2_SEF::Engine::flat);
+        run ("alpha transform, prewarped", RCA_MK2_SEF::Engine::alpha);
+        run ("generated kernel (Tools/WdfCodegen)", RCA_MK2_SEF::Engine::generated);
+        run ("alpha transform, double (offline)", RCA_MK2_SEF::Engine::precise);
+    }
+
+    void benchmarkParameterUpdates()
+    {
+        std::printf ("parameter updates (setHighPassCutoff + setLowPassCutoff)\n");
+
+        constexpr int numUpdates = 1 << 14;
+
+        auto run = [&] (const char* name, RCA_MK2_SEF::Engine engine)
+        {
+            RCA_MK2_SEF filter;
+            setUpFilter (filter, engine);
+
+            printResult (name, timePerItem (numUpdates, [&]
+            {
+                for (int i = 0; i < numUpdates; ++i)
+                {
+                    filter.setHighPassCutoff (200.f + float (i & 255));
+                    filter.setLowPassCutoff (2000.f + float (i & 255));
+                }
+            }), "update");
+        };
+
+        run ("wdft tree", RCA_MK2_SEF::Engine::wdfTree);
+        run ("single R-type junction", RCA_MK2_SEF::Engine::rtype);
+        run ("flat equations", RCA_MK2_SEF::Engine::flat);
+        run ("alpha transform, prewarped", RCA_MK2_SEF::Engine::alpha);
+        run ("generated kernel", RCA_MK2_SEF::Engine::generated);
+        run ("alpha transform, double (offline)", RCA_MK2_SEF::Engine::precise);
+    }
+
+    void benchmarkAnalogMatch()
+    {
+        constexpr float baseRate = 44100.f;
+        constexpr int numFrequencies = 256;
+
+        std::printf ("analog match at %.1f kHz, HP 40 Hz, mod on: worst error within 24 dB of the passband, cost per base-rate sample\n",
+                     baseRate / 1000.f);
+
+        const auto input = makeNoise (numSamples);
+
+        for (float lowPassCutoff : { 10000.f, 15000.f, 20000.f })
+        {
+            auto run = [&] (const char* name, RCA_MK2_SEF::Engine engine, int oversampling)
+            {
+                RCA_MK2_SEF filter;
+                filter.prepare (baseRate * float (oversampling));
+                filter.setEngine (engine);
+                filter.setHighPassCutoff (40.f);
+                filter.setLowPassCutoff (lowPassCutoff);
+
+                double worstDb = 0.0;
+
+                for (int i = 0; i < numFrequencies; ++i)
+                {
+                    const float f = 20.f * std::pow (0.95f * baseRate * 0.5f / 20.f, float (i) / float (numFrequencies - 1));
+                    const auto s = std::complex<double> (0.0, LadderComponents::twoPi * f);
+                    const double analogDb = 20.0 * std::log10 (std::abs (ladderTransferFunction (filter.getComponentValues(), s)));
+
+                    float mag = 0.f;
+                    filter.computeMagnitudeResponse (&f, &mag, 1);
+
+                    if (analogDb > -24.0)
+                        worstDb = std::max (worstDb, std::abs (20.0 * std::log10 (double (mag)) - analogDb));
+                }
+
+                // the resampling filters an oversampled version would also need aren't counted
+                const double ns = timePerItem (numSamples, [&]
+                {
+                    float acc = 0.f;
+                    for (auto x : input)
+                        for (int k = 0; k < oversampling; ++k)
+                            acc += filter.processSample (k == 0 ? x : 0.f);
+                    sink = acc;
+                });
+
+                char label[64];
+                std::snprintf (label, sizeof (label), "LP %2.0f kHz  %-28s %6.2f dB", lowPassCutoff / 1000.f, name, worstDb);
+                printResult (label, ns, "sample");
+            };
+
+            run ("bilinear", RCA_MK2_SEF::Engine::flat, 1);
+            run ("bilinear, 2x oversampled", RCA_MK2_SEF::Engine::flat, 2);
+            run ("bilinear, 4x oversampled", RCA_MK2_SEF::Engine::flat, 4);
+            run ("alpha transform, prewarped", RCA_MK2_SEF::Engine::alpha, 1);
+        }
+    }
+
+    void benchmarkOfflineQuality()
+    {
+        std::printf ("offline quality: realtime engines against Engine::precise, which the plugin runs when isNonRealtime()\n");
+
+        const auto input = makeNoise (numSamples);
+
+        struct Setting { float rate, highPass, lowPass; };
+
+        for (const auto& setting : { Setting { 48000.f, 300.f, 3000.f }, Setting { 48000.f, 20.f, 20000.f },
+                                     Setting { 192000.f, 20.f, 20000.f } })
+        {
+            std::printf ("  %.0f kHz, HP %.0f Hz, LP %.0f kHz, mod on\n", setting.rate / 1000.f, setting.highPass, setting.lowPass / 1000.f);
+
+            auto render = [&] (RCA_MK2_SEF::Engine engine, std::vector<float>& output)
+            {
+                RCA_MK2_SEF filter;
+                filter.prepare (setting.rate);
+                filter.setEngine (engine);
+                filter.setHighPassCutoff (setting.highPass);
+                filter.setLowPassCutoff (setting.lowPass);
+
+                output.resize (input.size());
+
+                return timePerItem (numSamples, [&]
+                {
+                    filter.reset();
+                    for (size_t n = 0; n < input.size(); ++n)
+                        output[n] = filter.processSample (input[n]);
+                });
+            };
+
+            std::vector<float> reference, output;
+            const double referenceNs = render (RCA_MK2_SEF::Engine::precise, reference);
+
+            // alpha runs the same equations as precise, so what's left is float rounding
+            const double alphaNs = render (RCA_MK2_SEF::Engine::alpha, output);
+
+            double signal = 0.0, error = 0.0;
+
+            for (size_t n = 0; n < reference.size(); ++n)
+            {
+                signal += (double) reference[n] * reference[n];
+                error += ((double) output[n] - reference[n]) * ((double) output[n] - reference[n]);
+            }
+
+            char label[64];
+            std::snprintf (label, sizeof (label), "alpha, float (realtime)   %7.1f dB", 10.0 * std::log10 (error / signal));
+            printResult (label, alphaNs, "sample");
+
+            printResult ("flat, float (realtime, bilinear)", render (RCA_MK2_SEF::Engine::flat, output), "sample");
+            printResult ("precise, double (offline)", referenceNs, "sample");
+        }
+    }
+
+    /**
+     * The ladder in double, keeping the largest value anywhere FixedPoint::Ladder saturates:
+     * the states, and the operands of the multiplies that don't round to 0.
+     */
+    struct PeakWave
+    {
+        double value = 0.0;
+
+        static inline double peak = 0.0;
+
+        static PeakWave keep (double x) noexcept
+        {
+            peak = std::max (peak, std::abs (x));
+            return { x };
+        }
+
+        PeakWave() = default;
+        PeakWave (double x) : value (x) {}
+        explicit PeakWave (int x) : value (x) {}
+
+        friend PeakWave operator+ (PeakWave a, PeakWave b) { return { a.value + b.value }; }
+        friend PeakWave operator- (PeakWave a, PeakWave b) { return { a.value - b.value }; }
+        friend PeakWave operator- (PeakWave a)             { return { -a.value }; }
+        friend PeakWave operator* (PeakWave a, PeakWave b) { return { keep (a.value).value * b.value }; }
+
+        friend PeakWave operator* (double c, PeakWave w)
+        {
+            if (FixedPoint::Coefficient::fromDouble (c).raw != 0)
+                keep (w.value);
+
+            return { c * w.value };
+        }
+    };
+
+    struct FixedPointError
+    {
+        double fixed = -1000.0, flat = -1000.0, peak = 0.0;
+        int headroomBits = 0;
+
+        void keepWorst (const FixedPointError& other) noexcept
+        {
+            fixed = std::max (fixed, other.fixed);
+            flat = std::max (flat, other.flat);
+            peak = std::max (peak, other.peak);
+            headroomBits = std::max (headroomBits, other.headroomBits);
+        }
+    };
+
+    /** Error of the fixed-point and float ladders against the same ladder in double, in dB relative to the input */
+    FixedPointError measureFixedPoint (RCA_MK2_SEF& filter, const std::vector<float>& input)
+    {
+        filter.reset();
+
+        FixedPoint::Ladder<> fixed;
+        fixed.copySettingsFrom (filter);
+
+        const auto rate = (double) filter.getSampleRate();
+        const auto coefficients = LadderCoefficientsT<double>::fromComponents (filter.getComponentValues().convertTo<double>(), rate);
+        std::array<double, RCA_MK2_SEF::numStates> z {};
+
+        double inputPower = 0.0, fixedError = 0.0, floatError = 0.0;
+        int headroomBits = 0;
+        PeakWave::peak = 0.0;
+
+        for (auto x : input)
+        {
+            const auto reference = processLadderSample<PeakWave> ([&] (int i) { return PeakWave (z[(size_t) i]); },
+                                                                  [&] (int i) { return coefficients.series[(size_t) i]; },
+                                                                  [&] (int i) { return coefficients.parallel[(size_t) i - 1]; },
+                                                                  PeakWave (x),
+                                                                  [&] (int i, PeakWave a) { z[(size_t) i] = PeakWave::keep (a.value).value; }).value;
+
+            const double fixedOut = FixedPoint::fromQ31 (fixed.processSample (FixedPoint::toQ31 (x)));
+            const double floatOut = filter.processSample (x);
+
+            headroomBits = std::max (headroomBits, fixed.getHeadroomBits());
+            inputPower += (double) x * x;
+            fixedError += (fixedOut - reference) * (fixedOut - reference);
+            floatError += (floatOut - reference) * (floatOut - reference);
+        }
+
+        return { 10.0 * std::log10 (fixedError / inputPower), 10.0 * std::log10 (floatError / inputPower), PeakWave::peak, headroomBits };
+    }
+
+    /** The integer bits the worst wave needed, and the most FixedPoint::Ladder<> ranged itself up to */
+    void printHeadroom (const FixedPointError& e)
+    {
+        constexpr int integerBits = 32 - FixedPoint::Ladder<>::WaveType::numFractionBits;
+        const int bitsNeeded = (int) std::ceil (std::log2 (std::max (e.peak, 1.0))) + 1;
+
+        std::printf (" peak wave %6.0f, %2d integer bits needed, ran at up to Q%d.%d\n",
+                     e.peak, bitsNeeded, integerBits + e.headroomBits, 32 - integerBits - e.headroomBits);
+    }
+
+    void benchmarkFixedPoint()
+    {
+        std::printf ("fixed point (Q1.31 audio and coefficients, Q9.23 waves ranging up as needed) against float\n");
+        std::printf ("  error is relative to the input, against the same ladder in double, worst over MOD on and off\n");
+
+        constexpr int numTestSamples = 1 << 15;
+
+        auto noise = makeNoise (numTestSamples);
+
+        for (auto& x : noise)
+            x *= 0.5f;
+
+        for (float rate : { 48000.f, 192000.f })
+        {
+            FixedPointError worst;
+
+            for (int mod = 0; mod < 2; ++mod)
+            {
+                for (int hp = 1; hp <= 11; ++hp)
+                {
+                    for (int lp = 1; lp <= 11; ++lp)
+                    {
+                        RCA_MK2_SEF filter;
+                        filter.prepare (rate);
+                        filter.setEngine (RCA_MK2_SEF::Engine::flat);
+                        filter.setHighPassMod (mod);
+                        filter.setLowPassMod (mod);
+                        filter.setHighPassKnobPos (hp);
+                        filter.setLowPassKnobPos (lp);
+
+                        worst.keepWorst (measureFixedPoint (filter, noise));
+                    }
+                }
+            }
+
+            std::printf ("  %3.0f kHz, -6 dBFS noise, every knob position:   fixed point %6.1f dB, float %6.1f dB,", rate / 1000.f, worst.fixed, worst.flat);
+            printHeadroom (worst);
+        }
+
+        // full scale at the bottom of the range, where the waves are biggest: a wave is v + R i,
+        // and the inductors' R = 2 fs L are largest with the cutoffs low
+        struct LowFrequencyCase { const char* name; double frequency; bool isSquare; };
+
+        const LowFrequencyCase lowFrequencyCases[] = { { "sine   20 Hz", 20.0, false },
+                                                       { "sine   30 Hz", 30.0, false },
+                                                       { "square 20 Hz", 20.0, true } };
+
+        // Rin at the bottom of the impedance range, where the ladder is least damped
+        const std::pair<float, float> terminations[] = { { 560.f, 560.f }, { 1.f, 560.f }, { 0.001f, 560.f } };
+
+        for (float rate : { 48000.f, 192000.f })
+        {
+            const int length = (int) rate;
+
+            for (const auto& [rin, rt] : terminations)
+            {
+                for (const auto& test : lowFrequencyCases)
+                {
+                    std::vector<float> signal ((size_t) length);
+
+                    for (int n = 0; n < length; ++n)
+                    {
+                        const auto phase = std::sin (juce::MathConstants<double>::twoPi * test.frequency * n / rate);
+                        signal[(size_t) n] = 0.99f * (float) (test.isSquare ? (phase >= 0.0 ? 1.0 : -1.0) : phase);
+                    }
+
+                    FixedPointError worst;
+
+                    for (int mod = 0; mod < 2; ++mod)
+                    {
+                        RCA_MK2_SEF filter;
+                        filter.prepare (rate);
+                        filter.setEngine (RCA_MK2_SEF::Engine::flat);
+                        filter.setHighPassMod (mod);
+                        filter.setLowPassMod (mod);
+                        filter.setHighPassCutoff (20.f);
+                        filter.setLowPassCutoff (20.f);
+                        filter.setInputImpedance (rin);
+                        filter.setOutputImpedance (rt);
+
+                        worst.keepWorst (measureFixedPoint (filter, signal));
+                    }
+
+                    std::printf ("  %3.0f kHz, %s, HP/LP 20 Hz, Rin %5g: fixed point %6.1f dB, float %6.1f dB,",
+                                 rate / 1000.f, test.name, rin, worst.fixed, worst.flat);
+                    printHeadroom (worst);
+                }
+            }
+        }
+
+        // both terminations near 0 leave the ladder almost lossless: past any fixed format, so it should clip, not wrap
+        {
+            RCA_MK2_SEF filter;
+            filter.prepare (sampleRate);
+            filter.setEngine (RCA_MK2_SEF::Engine::flat);
+            filter.setHighPassCutoff (20.f);
+            filter.setLowPassCutoff (20000.f);
+            filter.setInputImpedance (0.001f);
+            filter.setOutputImpedance (0.001f);
+
+            const auto e = measureFixedPoint (filter, noise);
+
+            std::printf ("   48 kHz, -6 dBFS noise, Rin = Rt = 0.001 ohms:   fixed point %6.1f dB, float %6.1f dB,", e.fixed, e.flat);
+            printHeadroom (e);
+        }
+
+        const auto input = makeNoise (numSamples);
+        std::vector<int32_t> fixedInput (input.size()), fixedOutput (input.size());
+
+        for (size_t n = 0; n < input.size(); ++n)
+            fixedInput[n] = FixedPoint::toQ31 (input[n]);
+
+        RCA_MK2_SEF filter;
+        setUpFilter (filter, RCA_MK2_SEF::Engine::flat);
+
+        FixedPoint::Ladder<> fixed;
+        fixed.copySettingsFrom (filter);
+
+        printResult ("float, flat processSample", timePerItem (numSamples, [&]
+        {
+            float acc = 0.f;
+            for (auto x : input)
+                acc += filter.processSample (x);
+            sink = acc;
+        }), "sample");
+
+        printResult ("fixed point processSample", timePerItem (numSamples, [&]
+        {
+            std::copy (fixedInput.begin(), fixedInput.end(), fixedOutput.begin());
+            fixed.process (fixedOutput.data(), numSamples);
+        }), "sample");
+
+        sink = FixedPoint::fromQ31 (fixedOutput.back());
+    }
+
+    void benchmarkNetlist()
+    {
+        std::printf ("netlist circuits (the RCA ladder, HP 300 Hz, LP 3 kHz)\n");
+
+        RCA_MK2_SEF tree;
+        setUpFilter (tree, RCA_MK2_SEF::Engine::wdfTree);
+
+        WdfNetlist::Circuit circuit;
+        std::string error;
+
+        printResult ("compile", timePerItem (1, [&] { circuit.compile (WdfNetlist::rcaLadder, error); }), "netlist");
+
+        circuit.prepare (sampleRate);
+
+        const auto& c = tree.getComponentValues();
+
+        const std::pair<const char*, float> values[] = {
+            { "Rin", c.Rin }, { "Rt", c.Rt },
+            { "C_HPm1", c.C_HPm1 }, { "L_HPm", c.L_HPm }, { "C_HPm2", c.C_HPm2 },
+            { "C_HP1", c.C_HP1 }, { "L_HP1", c.L_HP1 }, { "C_HP2", c.C_HP2 },
+            { "L_LP1", c.L_LP1 }, { "C_LP1", c.C_LP1 }, { "L_LP2", c.L_LP2 },
+            { "L_LPm1", c.L_LPm1 }, { "C_LPm1", c.C_LPm1 }, { "L_LPm2", c.L_LPm2 } };
+
+        for (const auto& [name, value] : values)
+            circuit.setValue (name, value);
+
+        const auto input = makeNoise (numSamples);
+
+        // same input, same state: the interpreter should land on exactly the tree's samples
+        float worstDifference = 0.f;
+
+        for (auto x : input)
+            worstDifference = std::max (worstDifference, std::abs (tree.processSample (x) - circuit.processSample (x)));
+
+        std::printf ("  %d nodes, %d instructions, worst difference from the wdft tree %g\n",
+                     circuit.getNumNodes(), circuit.getNumInstructions(), (double) worstDifference);
+
+        auto run = [&] (const char* name, auto& filter)
+        {
+            printResult (name, timePerItem (numSamples, [&]
+            {
+                float acc = 0.f;
+                for (auto x : input)
+                    acc += filter.processSample (x);
+                sink = acc;
+            }), "sample");
+        };
+
+        run ("wdft tree", tree);
+        run ("netlist, instruction list", circuit);
+
+        RCA_MK2_SEF flat;
+        setUpFilter (flat, RCA_MK2_SEF::Engine::flat);
+        run ("flat equations (hand-flattened)", flat);
+
+        RCA_MK2_SEF generated;
+        setUpFilter (generated, RCA_MK2_SEF::Engine::generated);
+        run ("generated from the netlist", generated);
+
+        // the generated kernel should match the tree bit for bit, whatever the settings
+        int differingSamples = 0;
+
+        for (auto rate : { 44100.f, 48000.f, 96000.f })
+        {
+            for (int mod = 0; mod < 2; ++mod)
+            {
+                RCA_MK2_SEF reference, candidate;
+
+                for (auto* filter : { &reference, &candidate })
+                {
+                    filter->prepare (rate);
+                    filter->setEngine (filter == &reference ? RCA_MK2_SEF::Engine::wdfTree : RCA_MK2_SEF::Engine::generated);
+                    filter->setHighPassMod (mod);
+                    filter->setLowPassMod (mod);
+                }
+
+                for (size_t i = 0; i < input.size(); ++i)
+                {
+                    if (i % 4096 == 0)
+                    {
+                        for (auto* filter : { &reference, &candidate })
+                        {
+                            filter->setHighPassCutoff (40.f + float (i % 3000));
+                            filter->setLowPassCutoff (500.f + float (i % 15000));
+                        }
+                    }
+
+                    const float expected = reference.processSample (input[i]);
+                    const float actual = candidate.processSample (input[i]);
+                    differingSamples += std::memcmp (&expected, &actual, sizeof (float)) != 0 ? 1 : 0;
+                }
+            }
+        }
+
+        std::printf ("  generated kernel, samples not bit-identical to the wdft tree: %d of %d\n",
+                     differingSamples, 6 * (int) input.size());
+
+        const int index = circuit.getIndex ("C_LP1");
+        constexpr int numUpdates = 1 << 14;
+
+        printResult ("netlist, one value change", timePerItem (numUpdates, [&]
+        {
+            for (int i = 0; i < numUpdates; ++i)
+                circuit.setValue (index, c.C_LP1 * (1.f + float (i & 255) / 256.f));
+        }), "update");
+    }
+
+    void benchmarkCoefficientCache()
+    {
+        constexpr int numKeys = 256;
+        constexpr int numUpdates = 1 << 14;
+
+        std::printf ("coefficient cache (%d distinct settings, one full filter update each)\n", numKeys);
+
+        auto cachePointer = std::make_unique<CoefficientCache>();
+        auto& cache = *cachePointer;
+        std::vector<CoefficientCache::Key> keys ((size_t) numKeys);
+
+        for (int i = 0; i < numKeys; ++i)
+        {
+            auto& key = keys[(size_t) i];
+            key.sampleRate = sampleRate;
+            key.setHighPassCutoff (200.f + float (i));
+            key.setLowPassKnobPos (1 + i % 11);
+        }
+
+        LadderComponents components;
+        LadderCoefficients coefficients;
+
+        {
+            RCA_MK2_SEF filter;
+            setUpFilter (filter, RCA_MK2_SEF::Engine::wdfTree);
+
+            printResult ("wdft tree, components from the key", timePerItem (numUpdates, [&]
+            {
+                for (int i = 0; i < numUpdates; ++i)
+                    filter.setComponentValues (keys[(size_t) (i % numKeys)].getComponents());
+            }), "update");
+        }
+
+        RCA_MK2_SEF filter;
+        setUpFilter (filter, RCA_MK2_SEF::Engine::flat);
+
+        for (const auto& key : keys)
+            cache.add (key);
+
+        printResult ("flat, hit", timePerItem (numUpdates, [&]
+        {
+            for (int i = 0; i < numUpdates; ++i)
+            {
+                cache.resolve (keys[(size_t) (i % numKeys)], components, coefficients);
+                filter.setComponentValues (components, coefficients);
+            }
+        }), "update");
+
+        // a k no key has used yet, so every lookup misses even once the fill thread catches up
+        float unusedK = 1000.f;
+
+        printResult ("flat, miss (resolved on the calling thread)", timePerItem (numUpdates, [&]
+        {
+            for (int i = 0; i < numUpdates; ++i)
+            {
+                auto key = keys[(size_t) (i % numKeys)];
+                key.k = unusedK++;
+                cache.resolve (key, components, coefficients);
+                filter.setComponentValues (components, coefficients);
+            }
+        }), "update");
+    }
+
+    void benchmarkEnvelopeModulation()
+    {
+        constexpr int numUpdates = 1 << 14;
+        constexpr int numChannels = 2;
+        constexpr int chunkSize = EnvelopeModulation::Modulator::chunkSize;
+
+        std::printf ("envelope modulation (flat engine, HP 300 Hz, LP 3 kHz, LP +3 oct, HP -1.5 oct)\n");
+
+        std::vector<float> inputs[numChannels] = { makeNoise (numSamples), makeNoise (numSamples) };
+        std::vector<float> envelope ((size_t) chunkSize);
+
+        {
+            EnvelopeModulation::Follower follower;
+            follower.prepare (sampleRate);
+
+            printResult ("follower, 2 channels linked", timePerItem (numSamples, [&]
+            {
+                for (int start = 0; start < numSamples; start += chunkSize)
+                {
+                    const float* chunk[] = { inputs[0].data() + start, inputs[1].data() + start };
+                    follower.process (chunk, numChannels, chunkSize, envelope.data());
+                }
+
+                sink = envelope.back();
+            }), "sample");
+        }
+
+        std::vector<float> highPassRatios ((size_t) numUpdates), lowPassRatios ((size_t) numUpdates);
+
+        for (int i = 0; i < numUpdates; ++i)
+        {
+            highPassRatios[(size_t) i] = std::exp2 (-1.5f * float (i & 255) / 255.f);
+            lowPassRatios[(size_t) i] = std::exp2 (3.f * float (i & 255) / 255.f);
+        }
+
+        {
+            RCA_MK2_SEF filter;
+            setUpFilter (filter, RCA_MK2_SEF::Engine::flat);
+
+            printResult ("cutoff update through the setters", timePerItem (numUpdates, [&]
+            {
+                for (int i = 0; i < numUpdates; ++i)
+                {
+                    filter.setHighPassCutoff (300.f * highPassRatios[(size_t) i]);
+                    filter.setLowPassCutoff (3000.f * lowPassRatios[(size_t) i]);
+                }
+            }), "update");
+
+            EnvelopeModulation::CoefficientPath path;
+            path.setBase (filter.getComponentValues(), sampleRate);
+
+            std::vector<LadderCoefficients> coefficients ((size_t) numUpdates);
+
+            printResult ("cutoff update, fast path, one at a time", timePerItem (numUpdates, [&]
+            {
+                for (int i = 0; i < numUpdates; ++i)
+                    path.compute (&highPassRatios[(size_t) i], &lowPassRatios[(size_t) i], 1, &coefficients[(size_t) i]);
+
+                sink = coefficients.back().series[0];
+            }), "update");
+
+            printResult ("cutoff update, fast path, a chunk at a time", timePerItem (numUpdates, [&]
+            {
+                for (int start = 0; start < numUpdates; start += chunkSize)
+                    path.compute (&highPassRatios[(size_t) start], &lowPassRatios[(size_t) start], chunkSize, &coefficients[(size_t) start]);
+
+                sink = coefficients.back().series[0];
+            }), "update");
+        }
+
+        {
+            RCA_MK2_SEF filters[numChannels];
+
+            for (auto& filter : filters)
+                setUpFilter (filter, RCA_MK2_SEF::Engine::flat);
+
+            std::vector<float> data ((size_t) numSamples);
+
+            printResult ("static, 2 channels", timePerItem (numSamples * numChannels, [&]
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int n = 0; n < numSamples; ++n)
+                        data[(size_t) n] = filters[channel].processSample (inputs[channel][(size_t) n]);
+
+                sink = data.back();
+            }), "channel-sample");
+        }
+
+        for (int interval : { 1, 4, 16, 64 })
+        {
+            RCA_MK2_SEF filters[numChannels];
+
+            for (auto& filter : filters)
+                setUpFilter (filter, RCA_MK2_SEF::Engine::flat);
+
+            EnvelopeModulation::Modulator modulator;
+            modulator.prepare (sampleRate);
+            modulator.setBase (filters[0].getComponentValues());
+            modulator.setLowPassDepth (3.f);
+            modulator.setHighPassDepth (-1.5f);
+            modulator.setUpdateInterval (interval);
+
+            std::vector<float> data[numChannels] = { inputs[0], inputs[1] };
+
+            char label[64];
+            std::snprintf (label, sizeof (label), "modulated, update every %d samples", interval);
+
+            printResult (label, timePerItem (numSamples * numChannels, [&]
+            {
+                for (int start = 0; start < numSamples; start += chunkSize)
+                {
+                    const float* detector[] = { inputs[0].data() + start, inputs[1].data() + start };
+                    modulator.analyse (detector, numChannels, chunkSize);
+
+                    for (int channel = 0; channel < numChannels; ++channel)
+                        modulator.process (filters[channel], data[channel].data() + start);
+                }
+
+                sink = data[0].back();
+            }), "channel-sample");
+        }
+    }
+
+    void benchmarkBank()
+    {
+        constexpr int numVoices = 64;
+        constexpr int blockSize = 256;
+
+        std::printf ("%d voices, %d-sample blocks, per-voice cutoffs\n", numVoices, blockSize);
+
+        const auto noise = makeNoise (numVoices * blockSize);
+        std::vector<float> output (noise.size());
+
+        std::vector<const float*> inputs;
+        std::vector<float*> outputs;
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            inputs.push_back (noise.data() + v * blockSize);
+            outputs.push_back (output.data() + v * blockSize);
+        }
+
+        constexpr int numBlocks = 256;
+
+        {
+            std::vector<std::unique_ptr<RCA_MK2_SEF>> filters;
+
+            for (int v = 0; v < numVoices; ++v)
+            {
+                filters.push_back (std::make_unique<RCA_MK2_SEF>());
+                setUpFilter (*filters.back(), RCA_MK2_SEF::Engine::wdfTree);
+                filters.back()->setHighPassCutoff (100.f + 10.f * float (v));
+            }
+
+            printResult ("separate RCA_MK2_SEF objects", timePerItem (numBlocks * numVoices * blockSize, [&]
+            {
+                for (int i = 0; i < numBlocks; ++i)
+                    for (int v = 0; v < numVoices; ++v)
+                        for (int n = 0; n < blockSize; ++n)
+                            outputs[(size_t) v][n] = filters[(size_t) v]->processSample (inputs[(size_t) v][n]);
+            }), "voice-sample");
+        }
+
+        {
+            RCA_MK2_SEF_Bank bank (numVoices);
+            bank.prepare (sampleRate);
+
+            for (int v = 0; v < numVoices; ++v)
+            {
+                bank.setHighPassCutoff (v, 100.f + 10.f * float (v));
+                bank.setLowPassCutoff (v, 3000.f);
+            }
+
+            printResult ("RCA_MK2_SEF_Bank", timePerItem (numBlocks * numVoices * blockSize, [&]
+            {
+                for (int i = 0; i < numBlocks; ++i)
+                    bank.process (inputs.data(), outputs.data(), blockSize);
+            }), "voice-sample");
+        }
+
+        sink = output[0];
+    }
+
+    void benchmarkChannelWorkers()
+    {
+        // at least one, so the pool's own overhead shows up even on a single core
+        const int numWorkers = (int) std::max (1u, std::thread::hardware_concurrency()) - 1;
+        const int numThreadsUsed = std::max (1, numWorkers);
+
+        std::printf ("channel workers (flat engine, HP 300 Hz, LP 3 kHz, %d worker%s + the caller)\n",
+                     numThreadsUsed, numThreadsUsed > 1 ? "s" : "");
+
+        struct alignas (ChannelWorkers::cacheLineSize) Channel
+        {
+            RCA_MK2_SEF filter;
+            float* data = nullptr;
+        };
+
+        // the caller stands in for a host's audio thread, so it asks for the same scheduling
+        const bool callerIsRealtime = ChannelWorkers::setCurrentThreadRealtime();
+
+        ChannelWorkers::Pool pool (numThreadsUsed);
+        constexpr int samplesPerRun = 1 << 14;
+
+        for (int numChannels : { 16, 64 })
+        {
+            for (int blockSize : { 64, 512 })
+            {
+                const auto input = makeNoise (numChannels * samplesPerRun);
+                std::vector<float> serialOut (input.size()), pooledOut (input.size());
+
+                auto channels = std::make_unique<Channel[]> ((size_t) numChannels);
+
+                for (int c = 0; c < numChannels; ++c)
+                    setUpFilter (channels[(size_t) c].filter, RCA_MK2_SEF::Engine::flat);
+
+                auto processChannel = [&] (int c)
+                {
+                    auto& channel = channels[(size_t) c];
+
+                    for (int n = 0; n < blockSize; ++n)
+                        channel.data[n] = channel.filter.processSample (channel.data[n]);
+                };
+
+                auto render = [&] (std::vector<float>& output, bool pooled)
+                {
+                    output = input;
+
+                    for (int c = 0; c < numChannels; ++c)
+                        channels[(size_t) c].filter.reset();
+
+                    for (int start = 0; start < samplesPerRun; start += blockSize)
+                    {
+                        for (int c = 0; c < numChannels; ++c)
+                            channels[(size_t) c].data = output.data() + (size_t) c * samplesPerRun + (size_t) start;
+
+                        if (pooled)
+                        {
+                            pool.run (numChannels, processChannel);
+                        }
+                        else
+                        {
+                            for (int c = 0; c < numChannels; ++c)
+                                processChannel (c);
+                        }
+                    }
+                };
+
+                char name[64];
+
+                std::snprintf (name, sizeof (name), "%d channels, %d-sample blocks, serial", numChannels, blockSize);
+                printResult (name, timePerItem (numChannels * samplesPerRun, [&] { render (serialOut, false); }), "channel-sample");
+
+                std::snprintf (name, sizeof (name), "%d channels, %d-sample blocks, pool", numChannels, blockSize);
+                printResult (name, timePerItem (numChannels * samplesPerRun, [&] { render (pooledOut, true); }), "channel-sample");
+
+                std::printf ("  %s\n", serialOut == pooledOut ? "identical to serial" : "DIFFERENT from serial");
+                sink = pooledOut.back();
+            }
+        }
+
+        // what a block pays just to go through the pool
+        constexpr int numEmptyRuns = 1 << 12;
+        auto nothing = [] (int) {};
+
+        printResult ("64 empty jobs", timePerItem (numEmptyRuns, [&]
+        {
+            for (int i = 0; i < numEmptyRuns; ++i)
+                pool.run (64, nothing);
+        }), "run");
+
+        // a worker whose runs the caller always beat may not have been scheduled yet
+        std::this_thread::sleep_for (std::chrono::milliseconds (10));
+
+        std::printf ("  real-time priority: caller %s, %d of %d workers\n",
+                     callerIsRealtime ? "yes" : "no", pool.getNumRealtimeWorkers(), pool.getNumWorkers());
+    }
+
+    void benchmarkOfflineRender()
+    {
+        const auto numThreads = (int) std::max (1u, std::thread::hardware_concurrency());
+        std::printf ("offline render (HP 300 Hz, LP 3 kHz, %d threads)\n", numThreads);
+
+        const int length = 1 << 22;
+        const auto input = makeNoise (length);
+
+        std::vector<float> serialOut ((size_t) length), parallelOut ((size_t) length);
+
+        auto serial = std::make_unique<RCA_MK2_SEF>();
+        auto parallel = std::make_unique<RCA_MK2_SEF>();
+        setUpFilter (*serial, RCA_MK2_SEF::Engine::wdfTree);
+        setUpFilter (*parallel, RCA_MK2_SEF::Engine::wdfTree);
+
+        printResult ("serial processSample", timePerItem (length, [&]
+        {
+            serial->reset();
+            for (int n = 0; n < length; ++n)
+                serialOut[(size_t) n] = serial->processSample (input[(size_t) n]);
+        }), "sample");
+
+        printResult ("state-space prefix scan", timePerItem (length, [&]
+        {
+            parallel->reset();
+            OfflineRender::renderParallel (*parallel, input.data(), parallelOut.data(), length, numThreads);
+        }), "sample");
+
+        float maxError = 0.f;
+        for (int n = 0; n < length; ++n)
+            maxError = std::max (maxError, std::abs (serialOut[(size_t) n] - parallelOut[(size_t) n]));
+
+        std::printf ("  max difference from serial: %g\n", maxError);
+
+        OfflineRender::SegmentedRenderResult segmented;
+
+        printResult ("segments with pre-roll (-100 dB)", timePerItem (length, [&]
+        {
+            parallel->reset();
+            segmented = OfflineRender::renderSegmented (*parallel, input.data(), parallelOut.data(), length, -100.0, numThreads);
+        }), "sample");
+
+        maxError = 0.f;
+        for (int n = 0; n < length; ++n)
+            maxError = std::max (maxError, std::abs (serialOut[(size_t) n] - parallelOut[(size_t) n]));
+
+        std::printf ("  pre-roll %lld samples, bound %.1f dB, max difference from serial: %g\n",
+                     (long long) segmented.preRollLength, segmented.worstCaseErrorDb, maxError);
+
+        // the low cut's bypass position leaves a tail no pre-roll covers, so this one goes to renderParallel()
+        serial->reset();
+        serial->setHighPassKnobPos (1);
+        parallel->setHighPassKnobPos (1);
+
+        for (int n = 0; n < length; ++n)
+            serialOut[(size_t) n] = serial->processSample (input[(size_t) n]);
+
+        printResult ("segments, low cut bypassed", timePerItem (length, [&]
+        {
+            parallel->reset();
+            segmented = OfflineRender::renderSegmented (*parallel, input.data(), parallelOut.data(), length, -100.0, numThreads);
+        }), "sample");
+
+        maxError = 0.f;
+        for (int n = 0; n < length; ++n)
+            maxError = std::max (maxError, std::abs (serialOut[(size_t) n] - parallelOut[(size_t) n]));
+
+        std::printf ("  %s, max difference from serial: %g\n",
+                     segmented.usedParallelRender ? "fell back to the state-space scan" : "segmented", maxError);
+    }
+
+    void benchmarkCheckpointedRender()
+    {
+        std::printf ("checkpointed render (2 streams, 64k-sample chunks, local farm)\n");
+
+        const int length = 1 << 22;
+        const auto input = makeNoise (length);
+
+        std::vector<float> serialOut ((size_t) length);
+        std::vector<std::vector<float>> farmOut (2, std::vector<float> ((size_t) length));
+
+        auto serial = std::make_unique<RCA_MK2_SEF>();
+        setUpFilter (*serial, RCA_MK2_SEF::Engine::wdfTree);
+
+        for (int n = 0; n < length; ++n)
+            serialOut[(size_t) n] = serial->processSample (input[(size_t) n]);
+
+        OfflineRender::LocalRenderFarm farm;
+
+        printResult ("farm, per sample per stream", timePerItem (2 * length, [&]
+        {
+            std::vector<std::future<void>> streams;
+
+            for (auto& out : farmOut)
+            {
+                streams.push_back (std::async (std::launch::async, [&]
+                {
+                    auto filter = std::make_unique<RCA_MK2_SEF>();
+                    setUpFilter (*filter, RCA_MK2_SEF::Engine::wdfTree);
+                    OfflineRender::renderCheckpointed (*filter, input.data(), out.data(), length, 1 << 16, farm);
+                }));
+            }
+
+            for (auto& stream : streams)
+                stream.get();
+        }), "sample");
+
+        bool identical = true;
+        for (const auto& out : farmOut)
+            identical = identical && std::memcmp (out.data(), serialOut.data(), sizeof (float) * (size_t) length) == 0;
+
+        std::printf ("  identical to an uninterrupted run: %s\n", identical ? "yes" : "NO");
+    }
+
+    void benchmarkToleranceAnalysis()
+    {
+        const auto numThreads = (int) std::max (1u, std::thread::hardware_concurrency());
+        std::printf ("tolerance analysis (HP 300 Hz, LP 3 kHz, 2048 trials x 128 points, 5/50/95%%)\n");
+
+        RCA_MK2_SEF filter;
+        setUpFilter (filter, RCA_MK2_SEF::Engine::wdfTree);
+
+        constexpr int numPoints = 128;
+        std::vector<float> freqs ((size_t) numPoints);
+
+        for (int i = 0; i < numPoints; ++i)
+            freqs[(size_t) i] = 20.f * std::pow (1000.f, float (i) / float (numPoints - 1));
+
+        const float percentiles[] = { 5.f, 50.f, 95.f };
+
+        ToleranceAnalysis::Settings settings;
+        settings.nominal = filter.getComponentValues();
+        settings.sampleRate = sampleRate;
+
+        ToleranceAnalysis::Analyser analyser;
+
+        std::vector<int> threadCounts { 1 };
+        if (numThreads > 1)
+            threadCounts.push_back (numThreads);
+
+        for (int threads : threadCounts)
+        {
+            settings.numThreads = threads;
+
+            char name[64];
+            std::snprintf (name, sizeof (name), "10%% parts, %d thread%s", threads, threads > 1 ? "s" : "");
+
+            printResult (name, timePerItem (settings.numTrials * numPoints, [&]
+            {
+                analyser.run (settings, freqs.data(), numPoints, percentiles, 3);
+            }), "trial-point");
+        }
+
+        std::printf ("  spread at %.0f Hz: %.2f dB to %.2f dB\n", (double) freqs[numPoints / 2],
+                     (double) juce::Decibels::gainToDecibels (analyser.getEnvelope (0, numPoints / 2)),
+                     (double) juce::Decibels::gainToDecibels (analyser.getEnvelope (2, numPoints / 2)));
+
+        // with no tolerance every trial is the nominal ladder
+        settings.capacitorTolerance = 0.f;
+        settings.inductorTolerance = 0.f;
+        analyser.run (settings, freqs.data(), numPoints, percentiles, 3);
+
+        std::vector<float> nominal ((size_t) numPoints);
+        filter.computeMagnitudeResponse (freqs.data(), nominal.data(), numPoints);
+
+        float maxError = 0.f;
+        for (int i = 0; i < numPoints; ++i)
+            for (int p = 0; p < 3; ++p)
+                maxError = std::max (maxError, std::abs (juce::Decibels::gainToDecibels (analyser.getEnvelope (p, i), -200.f)
+                                                         - juce::Decibels::gainToDecibels (nominal[(size_t) i], -200.f)));
+
+        std::printf ("  0%% tolerance, max difference from computeMagnitudeResponse: %g dB\n", (double) maxError);
+    }
+
+    void benchmarkComponentFit()
+    {
+        const auto numThreads = (int) std::max (1u, std::thread::hardware_concurrency());
+        std::printf ("component fit (22 knob positions, +-20%% parts, 300 points each)\n");
+
+        // a made-up unit: every C and L off by up to 20%, measured with 0.05 dB of noise
+        std::mt19937 rng (99);
+        std::uniform_real_distribution<double> spread (0.8, 1.2);
+        std::normal_distribution<double> noise (0.0, 0.05);
+
+        std::vector<ComponentFit::Problem> problems;
+        std::vector<std::pair<double, double>> truth;
+
+        for (auto section : { ComponentFit::Section::highPass, ComponentFit::Section::lowPass })
+        {
+            const bool isHighPass = section == ComponentFit::Section::highPass;
+            const auto& positions = isHighPass ? RCA_MK2_SEF::highPassKnobPositions : RCA_MK2_SEF::lowPassKnobPositions;
+
+            for (int pos = 1; pos <= 11; ++pos)
+            {
+                const auto& nominal = positions[(size_t) pos - 1];
+
+                ComponentFit::Problem problem;
+                problem.section = section;
+                problem.position = pos;
+                problem.C = nominal.C;
+                problem.L = nominal.L;
+                problem.fitValues = isHighPass ? pos != 1 : pos != 11;
+
+                const double C = problem.fitValues ? nominal.C * spread (rng) : nominal.C;
+                const double L = problem.fitValues ? nominal.L * spread (rng) : nominal.L;
+
+                LadderComponentsT<double> unit;
+                unit.setHighPass (isHighPass ? C : RCA_MK2_SEF::highPassKnobPositions.front().C,
+                                  isHighPass ? L : RCA_MK2_SEF::highPassKnobPositions.front().L, false, 560.0);
+                unit.setLowPass (isHighPass ? RCA_MK2_SEF::lowPassKnobPositions.back().C : C,
+                                 isHighPass ? RCA_MK2_SEF::lowPassKnobPositions.back().L : L, false, 560.0);
+
+                for (int i = 0; i < 300; ++i)
+                {
+                    const double f = 20.0 * std::pow (1000.0, i / 299.0);
+                    const auto h = ladderTransferFunction (unit, std::complex<double> (0.0, LadderComponentsT<double>::twoPi * f));
+
+                    problem.measurement.frequencies.push_back (f);
+                    problem.measurement.magnitudesDb.push_back (20.0 * std::log10 (std::abs (h)) + noise (rng));
+                }
+
+                problems.push_back (std::move (problem));
+                truth.emplace_back (C, L);
+            }
+        }
+
+        std::vector<ComponentFit::Result> results;
+
+        std::vector<int> threadCounts { 1 };
+        if (numThreads > 1)
+            threadCounts.push_back (numThreads);
+
+        for (int threads : threadCounts)
+        {
+            char name[64];
+            std::snprintf (name, sizeof (name), "all 22, %d thread%s", threads, threads > 1 ? "s" : "");
+
+            const double ns = timePerItem ((int) problems.size(), [&]
+            {
+                results = ComponentFit::fitAll (problems, threads);
+            });
+
+            std::printf ("  %-44s %10.2f ms/fit\n", name, ns * 1.0e-6);
+        }
+
+        double worstValue = 0.0, worstRms = 0.0;
+
+        for (size_t i = 0; i < problems.size(); ++i)
+        {
+            worstRms = std::max (worstRms, results[i].rmsErrorDb);
+
+            if (problems[i].fitValues)
+                worstValue = std::max ({ worstValue, std::abs (results[i].C / truth[i].first - 1.0),
+                                         std::abs (results[i].L / truth[i].second - 1.0) });
+        }
+
+        std::printf ("  worst C or L error %.2f%%, worst rms fit error %.3f dB\n", worstValue * 100.0, worstRms);
+    }
+
+    struct Section
+    {
+        const char* name;
+        std::function<void()> run;
+    };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    const std::vector<Section> sections =
+    {
+        { "engines", benchmarkEngines },
+        { "updates", benchmarkParameterUpdates },
+        { "analog", benchmarkAnalogMatch },
+        { "precision", benchmarkOfflineQuality },
+        { "fixed", benchmarkFixedPoint },
+        { "netlist", benchmarkNetlist },
+        { "cache", benchmarkCoefficientCache },
+        { "envelope", benchmarkEnvelopeModulation },
+        { "bank", benchmarkBank },
+        { "channels", benchmarkChannelWorkers },
+        { "offline", benchmarkOfflineRender },
+        { "checkpoint", benchmarkCheckpointedRender },
+        { "tolerance", benchmarkToleranceAnalysis },
+        { "fit", benchmarkComponentFit },
+    };
+
+    for (const auto& section : sections)
+        if (argc < 2 || std::strcmp (argv[1], section.name) == 0)
+            section.run();
+
+    return 0;
+}
@@ -16,13 +16,16 @@ RCAMKIISoundEffectsFilterAudioProcessorEditor::RCAMKIISoundEffectsFilterAudioPro
     initialiseHighPassParams(p);
     initialiseLowPassParams(p);
     initialiseMasterParams(p);
+    initialiseEnvelopeParams(p);
     initialiseTopBar(p);
+    syncToggles();
+    p.addChangeListener(this);
     
     Container.setBackgroundColor(juce::Colour::fromRGB(15, 15, 15));
     addAndMakeVisible(Container);
     addAndMakeVisible(topBar);
     
-    setSize (950, 500);
+    setSize (1250, 500);
     setResizable(true, true);
 
 }
@@ -54,11 +57,40 @@ void RCAMKIISoundEffectsFilterAudioProcessorEditor::initialiseTopBar(RCAMKIISoun
     
     topBar.responseCurveToggle.setToggleState(true, juce::NotificationType::dontSendNotification);
     
+    topBar.knobTableButton.onClick = [this]() { showKnobTableMenu(); };
+    
     addAndMakeVisible(responseCurve);
     responseCurve.responseCurveChanged(true);
 
 }
 
+void RCAMKIISoundEffectsFilterAudioProcessorEditor::showKnobTableMenu()
+{
+    juce::PopupMenu menu;
+    
+    menu.addItem("Load fitted table...", [this]()
+    {
+        knobTableChooser = std::make_unique<juce::FileChooser>("Knob table", juce::File(), "*.txt");
+        
+        knobTableChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                      [this](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+            juce::String error;
+            
+            if (file != juce::File() && ! audioProcessor.loadKnobTable(file, error))
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Knob table", error);
+        });
+    });
+    
+    menu.addItem("Built-in values", true, ! audioProcessor.hasCustomKnobTable(), [this]()
+    {
+        audioProcessor.resetKnobTable();
+    });
+    
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&topBar.knobTableButton));
+}
+
 void RCAMKIISoundEffectsFilterAudioProcessorEditor::initialiseHighPassParams(RCAMKIISoundEffectsFilterAudioProcessor& p)
 {
     /** Attachments & Sliders ... */
@@ -84,34 +116,22 @@ void RCAMKIISoundEffectsFilterAudioProcessorEditor::initialiseHighPassParams(RCA
         p.isHighPassContinuous = state;
         p.highPassControlsChanged = true;
         
-        for (auto& filter : p.getFilters())
-        {
-            filter.setHighPassMod(state);
-            filter.reset();
-        }
+        p.resetFilters();
 
-        p.updateFilters();
         responseCurve.responseCurveChanged(true);
 
     };
     
-    highPassControls.getToggleButton().setToggleState(true, juce::NotificationType::dontSendNotification);
-    
     highPassModToggle.getToggleButton().onClick = [&]()
     {
         int state = highPassModToggle.getToggleButton().getToggleState();
 
-        for (auto& filter : p.getFilters())
-        {
-            filter.setHighPassMod(state);
-            filter.reset();
-        }
+        p.resetFilters();
             
-        p.getDummy().setHighPassMod(state);
+        p.highPassMod = state;
         responseCurve.responseCurveChanged(true);
 
     };
-    highPassModToggle.getToggleButton().setToggleState(true, juce::NotificationType::dontSendNotification);
 }
 
 void RCAMKIISoundEffectsFilterAudioProcessorEditor::initialiseLowPassParams(RCAMKIISoundEffectsFilterAudioProcessor& p)
@@ -139,37 +159,22 @@ void RCAMKIISoundEffectsFilterAudioProcessorEditor::initialiseLowPassParams(RCAM
         p.isLowPassContinuous = state;
         p.lowPassControlsChanged = true;
         
-        for (auto& filter : p.getFilters())
-        {
-            filter.setLowPassMod(state);
-            filter.reset();
-        }
+        p.resetFilters();
         
-        p.updateFilters();
         responseCurve.responseCurveChanged(true);
 
     };
     
-    lowPassControls.getToggleButton().setToggleState(true, juce::NotificationType::dontSendNotification);
-    
     lowPassModToggle.getToggleButton().onClick = [&]()
     {
         int state = lowPassModToggle.getToggleButton().getToggleState();
 
-        for (auto& filter : p.getFilters())
-        {
-            filter.setLowPassMod(state);
-            filter.reset();
-        }
+        p.resetFilters();
                 
-        p.getDummy().setLowPassMod(state);
-        p.updateFilters();
+        p.lowPassMod = state;
 
         responseCurve.responseCurveChanged(true);
     };
-    
-    lowPassModToggle.getToggleButton().setToggleState(true, juce::NotificationType::dontSendNotification);
-
 }
 
 void RCAMKIISoundEffectsFilterAudioProcessorEditor::initialiseMasterParams(RCAMKIISoundEffectsFilterAudioProcessor& p)
@@ -190,13 +195,82 @@ void RCAMKIISoundEffectsFilterAudioProcessorEditor::initialiseMasterParams(RCAMK
     OutputGainSlider->setNumDecimals(1);
     OutputGainSlider->setTextValueSuffix(" dB");
     
+    // shades the spread of units built from parts this far off around the response curve;
+    // display only, so it's the processor's to keep rather than a parameter
+    ToleranceSlider->setRange(0, 20);
+    ToleranceSlider->setNumDecimals(1);
+    ToleranceSlider->setTextValueSuffix(" %");
+    
+    ToleranceSlider->onValueChange = [&]()
+    {
+        p.tolerance = (float) ToleranceSlider->getValue();
+        responseCurve.responseCurveChanged(true);
+    };
+    
+    // alpha-transform engine with the prewarp fitted to the hardware
+    analogMatchAttachment = std::make_unique<apvts::ButtonAttachment>(p.apvts, "ANALOG_MATCH", analogMatchToggle.getToggleButton());
+    
+    // the session keeps the filters' wave state, so a render carries on where the last stopped
+    saveStateToggle.getToggleButton().onClick = [&]()
+    {
+        p.storeWaveState = saveStateToggle.getToggleButton().getToggleState();
+    };
+    
     MasterParams.setLabelText("MASTER");
 
 }
 
+void RCAMKIISoundEffectsFilterAudioProcessorEditor::initialiseEnvelopeParams(RCAMKIISoundEffectsFilterAudioProcessor& p)
+{
+    envelopeHighPassAttachment = std::make_unique<apvts::SliderAttachment>(p.apvts, "ENV_HIGH_PASS", EnvelopeHighPassSlider.getSlider());
+    envelopeLowPassAttachment = std::make_unique<apvts::SliderAttachment>(p.apvts, "ENV_LOW_PASS", EnvelopeLowPassSlider.getSlider());
+    envelopeAttackAttachment = std::make_unique<apvts::SliderAttachment>(p.apvts, "ENV_ATTACK", EnvelopeAttackSlider.getSlider());
+    envelopeReleaseAttachment = std::make_unique<apvts::SliderAttachment>(p.apvts, "ENV_RELEASE", EnvelopeReleaseSlider.getSlider());
+    envelopeSensitivityAttachment = std::make_unique<apvts::SliderAttachment>(p.apvts, "ENV_SENSITIVITY", EnvelopeSensitivitySlider.getSlider());
+    envelopeSidechainAttachment = std::make_unique<apvts::ButtonAttachment>(p.apvts, "ENV_SIDECHAIN", envelopeSidechainToggle.getToggleButton());
+    
+    EnvelopeHighPassSlider->setNumDecimals(1);
+    EnvelopeHighPassSlider->setTextValueSuffix(" oct");
+    
+    EnvelopeLowPassSlider->setNumDecimals(1);
+    EnvelopeLowPassSlider->setTextValueSuffix(" oct");
+    
+    EnvelopeAttackSlider->setNumDecimals(1);
+    EnvelopeAttackSlider->setTextValueSuffix(" ms");
+    
+    EnvelopeReleaseSlider->setNumDecimals(0);
+    EnvelopeReleaseSlider->setTextValueSuffix(" ms");
+    
+    EnvelopeSensitivitySlider->setNumDecimals(1);
+    EnvelopeSensitivitySlider->setTextValueSuffix(" dB");
+    
+    EnvelopeParams.setLabelText("ENVELOPE");
+}
+
 
 RCAMKIISoundEffectsFilterAudioProcessorEditor::~RCAMKIISoundEffectsFilterAudioProcessorEditor()
 {
+    audioProcessor.removeChangeListener(this);
+}
+
+void RCAMKIISoundEffectsFilterAudioProcessorEditor::syncToggles()
+{
+    highPassControls.getToggleButton().setToggleState(audioProcessor.isHighPassContinuous, juce::NotificationType::dontSendNotification);
+    highPassModToggle.getToggleButton().setToggleState(audioProcessor.highPassMod != 0, juce::NotificationType::dontSendNotification);
+    highPassParams.setContinuous(audioProcessor.isHighPassContinuous);
+    
+    lowPassControls.getToggleButton().setToggleState(audioProcessor.isLowPassContinuous, juce::NotificationType::dontSendNotification);
+    lowPassModToggle.getToggleButton().setToggleState(audioProcessor.lowPassMod != 0, juce::NotificationType::dontSendNotification);
+    lowPassParams.setContinuous(audioProcessor.isLowPassContinuous);
+    
+    ToleranceSlider->setValue(audioProcessor.tolerance, juce::NotificationType::dontSendNotification);
+    saveStateToggle.getToggleButton().setToggleState(audioProcessor.storeWaveState, juce::NotificationType::dontSendNotification);
+}
+
+void RCAMKIISoundEffectsFilterAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    syncToggles();
+    responseCurve.responseCurveChanged(true);
 }
 
 //==============================================================================
@@ -19,7 +19,8 @@
 //==============================================================================
 /**
 */
-class RCAMKIISoundEffectsFilterAudioProcessorEditor  : public juce::AudioProcessorEditor
+class RCAMKIISoundEffectsFilterAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                                       private juce::ChangeListener
 {
 public:
     RCAMKIISoundEffectsFilterAudioProcessorEditor (RCAMKIISoundEffectsFilterAudioProcessor&);
@@ -68,22 +69,58 @@ private:
     
     SliderWithLabel OutputGainSlider {"OUTPUT GAIN"};
     std::unique_ptr<apvts::SliderAttachment> outputGainSliderAttachment;
+    
+    SliderWithLabel ToleranceSlider {"TOLERANCE"};
+    
+    CustomToggle analogMatchToggle {"ANALOG"};
+    std::unique_ptr<apvts::ButtonAttachment> analogMatchAttachment;
+    
+    CustomToggle saveStateToggle {"SAVE STATE"};
 
-    ParameterPanel MasterParams {juce::Array<juce::Component*>{&ZInputSlider, &ZOutputSlider, &OutputGainSlider}};
+    ParameterPanel MasterParams {juce::Array<juce::Component*>{&ZInputSlider, &ZOutputSlider, &OutputGainSlider, &ToleranceSlider, &analogMatchToggle, &saveStateToggle}};
+    
+    /** Envelope panel */
+    SliderWithLabel EnvelopeHighPassSlider {"TO HP"};
+    SliderWithLabel EnvelopeLowPassSlider {"TO LP"};
+    SliderWithLabel EnvelopeAttackSlider {"ATTACK"};
+    SliderWithLabel EnvelopeReleaseSlider {"RELEASE"};
+    std::unique_ptr<apvts::SliderAttachment> envelopeHighPassAttachment;
+    std::unique_ptr<apvts::SliderAttachment> envelopeLowPassAttachment;
+    std::unique_ptr<apvts::SliderAttachment> envelopeAttackAttachment;
+    std::unique_ptr<apvts::SliderAttachment> envelopeReleaseAttachment;
+    
+    SliderWithLabel EnvelopeSensitivitySlider {"SENSITIVITY"};
+    std::unique_ptr<apvts::SliderAttachment> envelopeSensitivityAttachment;
+    
+    CustomToggle envelopeSidechainToggle {"SIDECHAIN"};
+    std::unique_ptr<apvts::ButtonAttachment> envelopeSidechainAttachment;
+    
+    ParameterPanel EnvelopeParams {juce::Array<juce::Component*>{&EnvelopeHighPassSlider, &EnvelopeLowPassSlider, &EnvelopeAttackSlider, &EnvelopeReleaseSlider, &EnvelopeSensitivitySlider, &envelopeSidechainToggle}};
     
     /** Main container */
-    ParameterPanel Container {juce::Array<juce::Component*>{&highPassParams, &MasterParams, &lowPassParams}};
+    ParameterPanel Container {juce::Array<juce::Component*>{&highPassParams, &MasterParams, &lowPassParams, &EnvelopeParams}};
     
     /** Response curve */
     ResponseCurveComponent responseCurve;
     juce::ToggleButton responseCurveToggle;
     const float curveToParamsRatio = 1.5f;
+    
+    /** Loads a fitted knob table (Tools/ComponentFit) or goes back to the built-in one */
+    std::unique_ptr<juce::FileChooser> knobTableChooser;
+    void showKnobTableMenu();
 
 
     void initialiseHighPassParams(RCAMKIISoundEffectsFilterAudioProcessor& p);
     void initialiseLowPassParams(RCAMKIISoundEffectsFilterAudioProcessor& p);
     void initialiseMasterParams(RCAMKIISoundEffectsFilterAudioProcessor& p);
+    void initialiseEnvelopeParams(RCAMKIISoundEffectsFilterAudioProcessor& p);
     void initialiseTopBar(RCAMKIISoundEffectsFilterAudioProcessor& p);
     
+    /** Brings the CONTROLS, MOD and SAVE STATE toggles, and the tolerance, into line with the processor */
+    void syncToggles();
+    
+    /** A state was restored while the editor was open */
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RCAMKIISoundEffectsFilterAudioProcessorEditor)
 };
@@ -16,12 +16,31 @@ RCAMKIISoundEffectsFilterAudioProcessor::RCAMKIISoundEffectsFilterAudioProcessor
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        ), apvts(*this, nullptr, "Parameters", createParameters())
 #endif
 {
+    highPassCutoffParam = apvts.getRawParameterValue("HIGH_PASS_CUTOFF");
+    lowPassCutoffParam = apvts.getRawParameterValue("LOW_PASS_CUTOFF");
+    highPassKnobParam = apvts.getRawParameterValue("DISC_HIGH_PASS");
+    lowPassKnobParam = apvts.getRawParameterValue("DISC_LOW_PASS");
+    inputImpedanceParam = apvts.getRawParameterValue("Z_INPUT");
+    outputImpedanceParam = apvts.getRawParameterValue("Z_OUTPUT");
+    outputGainParam = apvts.getRawParameterValue("OUTPUT_GAIN");
+    analogMatchParam = apvts.getRawParameterValue("ANALOG_MATCH");
+    envelopeHighPassParam = apvts.getRawParameterValue("ENV_HIGH_PASS");
+    envelopeLowPassParam = apvts.getRawParameterValue("ENV_LOW_PASS");
+    envelopeAttackParam = apvts.getRawParameterValue("ENV_ATTACK");
+    envelopeReleaseParam = apvts.getRawParameterValue("ENV_RELEASE");
+    envelopeSensitivityParam = apvts.getRawParameterValue("ENV_SENSITIVITY");
+    envelopeSidechainParam = apvts.getRawParameterValue("ENV_SIDECHAIN");
+    
+    modulator.setUpdateInterval(envelopeUpdateInterval);
+    
+    filterKey.sampleRate = 0;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout RCAMKIISoundEffectsFilterAudioProcessor::createParameters()
@@ -47,6 +66,27 @@ juce::AudioProcessorValueTreeState::ParameterLayout RCAMKIISoundEffectsFilterAud
     params.add(std::make_unique<juce::AudioParameterFloat>(ParameterID{"Z_OUTPUT", 1}, "Z output", -100.f, 100.f, 0.f));
     
     params.add(std::make_unique<juce::AudioParameterFloat>(ParameterID{"OUTPUT_GAIN", 1}, "Output gain", 0., 20., 6.));
+    
+    params.add(std::make_unique<juce::AudioParameterBool>(ParameterID{"ANALOG_MATCH", 1}, "Analog match", false));
+    
+    juce::NormalisableRange<float> attackRange(0.1f, 100.f);
+    attackRange.setSkewForCentre(10.f);
+    
+    juce::NormalisableRange<float> releaseRange(5.f, 2000.f);
+    releaseRange.setSkewForCentre(200.f);
+    
+    // envelope depths are in octaves of cutoff movement at full envelope
+    params.add(std::make_unique<juce::AudioParameterFloat>(ParameterID{"ENV_HIGH_PASS", 1}, "Envelope to high pass", -4.f, 4.f, 0.f));
+    
+    params.add(std::make_unique<juce::AudioParameterFloat>(ParameterID{"ENV_LOW_PASS", 1}, "Envelope to low pass", -4.f, 4.f, 0.f));
+    
+    params.add(std::make_unique<juce::AudioParameterFloat>(ParameterID{"ENV_ATTACK", 1}, "Envelope attack", attackRange, 5.f));
+    
+    params.add(std::make_unique<juce::AudioParameterFloat>(ParameterID{"ENV_RELEASE", 1}, "Envelope release", releaseRange, 200.f));
+    
+    params.add(std::make_unique<juce::AudioParameterFloat>(ParameterID{"ENV_SENSITIVITY", 1}, "Envelope sensitivity", 0.f, 24.f, 0.f));
+    
+    params.add(std::make_unique<juce::AudioParameterBool>(ParameterID{"ENV_SIDECHAIN", 1}, "Envelope from sidechain", false));
 
     return params;
 }
@@ -120,14 +160,52 @@ void RCAMKIISoundEffectsFilterAudioProcessor::changeProgramName (int index, cons
 //==============================================================================
 void RCAMKIISoundEffectsFilterAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Use this method as the place to do any pre-playback
-    // initialisation that you need..
+    const int numChannels = juce::jlimit(1, maxChannels, getMainBusNumInputChannels());
+    
+    if (numChannels != numChannelsPrepared)
+    {
+        channels = std::make_unique<Channel[]>(size_t(numChannels));
+        numChannelsPrepared = numChannels;
+    }
+    
+    // the cached coefficients are only valid for a filter at the key's sample rate
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto& filter = channels[channel].filter;
+        filter.prepare(float(sampleRate));
+        filter.setEngine(filterEngine);
+        filter.reset();
+    }
+    
+    filtersNeedReset.store(false);
+    
+    // a stereo instance never starts a thread; a wide one gets a worker per spare core
+    const int numWorkers = juce::jmin(numChannels, juce::SystemStats::getNumCpus()) - 1;
+    
+    if (numChannels < minChannelsForWorkers || numWorkers < 1)
+        workers.reset();
+    else if (workers == nullptr || workers->getNumWorkers() != numWorkers)
+        workers = std::make_unique<ChannelWorkers::Pool>(numWorkers);
+    
+    modulator.prepare(float(sampleRate));
+    
+    // offline quality only comes and goes here, where the filters start again from rest anyway
+    isRenderingOffline = isNonRealtime();
+    
+    prevHighPassKnobPos = int(highPassKnobParam->load());
+    prevLowPassKnobPos = int(lowPassKnobParam->load());
+    
+    // the coefficients are built here rather than in setStateInformation(), so a session
+    // full of instances doesn't work every ladder out on the message thread as it loads
+    filterKey.sampleRate = 0;
+    coefficientsDirty.store(false);
+    updateFilters();
 }
 
 void RCAMKIISoundEffectsFilterAudioProcessor::releaseResources()
 {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    // prepareToPlay() starts them again if the bus still wants them
+    workers.reset();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -137,18 +215,26 @@ bool RCAMKIISoundEffectsFilterAudioProcessor::isBusesLayoutSupported (const Buse
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // every channel gets its own filter, so any layout works: mono, stereo, surround,
+    // ambisonic or a discrete immersive bus, up to maxChannels
+    const auto mainOutput = layouts.getMainOutputChannelSet();
+    
+    if (mainOutput.isDisabled() || mainOutput.size() > maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+    
+    // the sidechain only feeds the envelope follower, which takes whatever it's given
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto sidechain = layouts.getChannelSet(true, 1);
+        
+        if (sidechain.size() > maxChannels)
+            return false;
+    }
    #endif
 
     return true;
@@ -159,132 +245,310 @@ bool RCAMKIISoundEffectsFilterAudioProcessor::isBusesLayoutSupported (const Buse
 
 float RCAMKIISoundEffectsFilterAudioProcessor::getCurrentGain()
 {
-    const float gDb = apvts.getRawParameterValue("OUTPUT_GAIN")->load();
+    const float gDb = outputGainParam->load();
     return juce::Decibels::decibelsToGain(gDb);
 }
 
+template <typename T>
+bool IsInBounds(const T& value, const T& low, const T& high)
+{
+    return (value >= low) && (value <= high);
+}
+
+
+float mapImpedanceVal(float value)
+{
+    if (value == 0) return 560.f;
+    if (IsInBounds(value, -100.f, 0.f))
+        return juce::jmap(value, -100.f, 0.f, .001f, 560.f);
+    if (IsInBounds(value, 0.f, 100.f))
+        return juce::jmap(value, 0.f, 100.f, 560.f, 5000.f);
+    jassertfalse;
+};
+
+
 void RCAMKIISoundEffectsFilterAudioProcessor::updateFilters()
 {
+    if (coefficientsDirty.exchange(false))
+        filterKey.sampleRate = 0;
     
-    const float lpfValue = apvts.getRawParameterValue("LOW_PASS_CUTOFF")->load();
-    const float hpfValue = apvts.getRawParameterValue("HIGH_PASS_CUTOFF")->load();
-    const int lpfKnobPos = apvts.getRawParameterValue("DISC_LOW_PASS")->load();
-    const int hpfKnobPos = apvts.getRawParameterValue("DISC_HIGH_PASS")->load();
+    CoefficientCache::Key key;
     
-    auto setLowPassParameters = [this](RCA_MK2_SEF& filter, float cutoff, int knobPos)
-    {
-        if (isLowPassContinuous)
-            filter.setLowPassCutoff(cutoff);
-        else
-            filter.setLowPassKnobPos(knobPos);
-    };
+    key.sampleRate = float(getSampleRate() > 0 ? getSampleRate() : 48000.0);
     
-    auto setHighPassParameters = [this](RCA_MK2_SEF& filter, float cutoff, int knobPos)
-    {
-        if (isHighPassContinuous)
-            filter.setHighPassCutoff(cutoff);
-        else
-            filter.setHighPassKnobPos(knobPos);
-    };
+    if (isHighPassContinuous)
+        key.setHighPassCutoff(highPassCutoffParam->load());
+    else
+        key.setHighPassKnobPos(int(highPassKnobParam->load()));
+    
+    if (isLowPassContinuous)
+        key.setLowPassCutoff(lowPassCutoffParam->load());
+    else
+        key.setLowPassKnobPos(int(lowPassKnobParam->load()));
+    
+    key.knobTable = knobTableId.load();
     
-    for (auto& filter : filters)
+    key.highPassMod = highPassMod;
+    key.lowPassMod = lowPassMod;
+    
+    key.inputImpedance = mapImpedanceVal(inputImpedanceParam->load());
+    key.outputImpedance = mapImpedanceVal(outputImpedanceParam->load());
+    
+    // the cache only holds bilinear coefficients; the alpha and precise engines warp the cached components themselves
+    auto engine = analogMatchParam->load() >= 0.5f ? RCA_MK2_SEF::Engine::alpha : RCA_MK2_SEF::Engine::flat;
+    
+    if (isRenderingOffline)
+        engine = RCA_MK2_SEF::Engine::precise;
+    
+    if (engine != filterEngine)
     {
-        setLowPassParameters(filter, lpfValue, lpfKnobPos);
-        setHighPassParameters(filter, hpfValue, hpfKnobPos);
+        filterEngine = engine;
+        
+        // the states carry across, so toggling ANALOG MATCH mid-signal doesn't click
+        for (int channel = 0; channel < numChannelsPrepared; ++channel)
+            channels[channel].filter.setEngine(engine);
+        
+        filterKey.sampleRate = 0;
     }
     
-    setLowPassParameters(dummy, lpfValue, lpfKnobPos);
-    setHighPassParameters(dummy, hpfValue, hpfKnobPos);
+    modulator.setHighPassDepth(envelopeHighPassParam->load());
+    modulator.setLowPassDepth(envelopeLowPassParam->load());
+    modulator.setAttack(envelopeAttackParam->load());
+    modulator.setRelease(envelopeReleaseParam->load());
+    modulator.setSensitivity(juce::Decibels::decibelsToGain(envelopeSensitivityParam->load()));
+    
+    // when the envelope lets go, the filters go back to the unmodulated ladder
+    const bool isModulating = modulator.isActive();
+    
+    if (wasModulating && ! isModulating)
+        filterKey.sampleRate = 0;
+    
+    wasModulating = isModulating;
+    
+    // most blocks: nothing has moved since the last one
+    if (key == filterKey)
+        return;
+    
+    filterKey = key;
     
+    LadderComponents components;
+    LadderCoefficients coefficients;
+    coefficientCache->resolve(key, components, coefficients);
+    
+    for (int channel = 0; channel < numChannelsPrepared; ++channel)
+        channels[channel].filter.setComponentValues(components, coefficients);
+    
+    modulator.setBase(components);
 }
 
-template <typename T>
-bool IsInBounds(const T& value, const T& low, const T& high)
+
+void RCAMKIISoundEffectsFilterAudioProcessor::processModulated(juce::AudioBuffer<float>& buffer, int numChannels)
 {
-    return (value >= low) && (value <= high);
+    // raw pointers rather than getBusBuffer(), whose AudioBuffer allocates its channel list
+    const float* detectorData[maxChannels] = {};
+    int numDetectorChannels = 0;
+    
+    const auto* sidechainBus = getBusCount(true) > 1 ? getBus(true, 1) : nullptr;
+    const int numSidechainChannels = sidechainBus != nullptr && sidechainBus->isEnabled() ? sidechainBus->getNumberOfChannels() : 0;
+    
+    // without a sidechain connected, the envelope follows the input
+    if (envelopeSidechainParam->load() >= 0.5f && numSidechainChannels > 0)
+    {
+        numDetectorChannels = juce::jmin(numSidechainChannels, maxChannels);
+        
+        for (int channel = 0; channel < numDetectorChannels; ++channel)
+            detectorData[channel] = buffer.getReadPointer(getChannelIndexInProcessBlockBuffer(true, 1, channel));
+    }
+    else
+    {
+        numDetectorChannels = numChannels;
+        
+        for (int channel = 0; channel < numDetectorChannels; ++channel)
+            detectorData[channel] = channels[channel].data;
+    }
+    
+    for (int start = 0; start < buffer.getNumSamples(); start += EnvelopeModulation::Modulator::chunkSize)
+    {
+        const int numSamples = juce::jmin(EnvelopeModulation::Modulator::chunkSize, buffer.getNumSamples() - start);
+        
+        const float* detectorChannels[maxChannels] = {};
+        
+        for (int channel = 0; channel < numDetectorChannels; ++channel)
+            detectorChannels[channel] = detectorData[channel] + start;
+        
+        modulator.analyse(detectorChannels, numDetectorChannels, numSamples);
+        
+        // the chunk's updates are shared and only read from here, so the channels can go in parallel
+        auto processChannel = [this, start](int channel)
+        {
+            modulator.process(channels[channel].filter, channels[channel].data + start);
+        };
+        
+        forEachChannel(numChannels, numSamples, processChannel);
+    }
 }
 
 
-float mapImpedanceVal(float value)
+bool RCAMKIISoundEffectsFilterAudioProcessor::loadKnobTable(const juce::File& file, juce::String& error)
 {
-    if (value == 0) return 560.f;
-    if (IsInBounds(value, -100.f, 0.f))
-        return juce::jmap(value, -100.f, 0.f, .001f, 560.f);
-    if (IsInBounds(value, 0.f, 100.f))
-        return juce::jmap(value, 0.f, 100.f, 560.f, 5000.f);
-    jassertfalse;
-};
+    RCA_MK2_SEF::KnobTable table;
+    std::string parseError;
+    
+    if (! file.existsAsFile())
+    {
+        error = "Can't read " + file.getFullPathName();
+        return false;
+    }
+    
+    if (! RCA_MK2_SEF::parseKnobTable(file.loadFileAsString().toStdString(), table, parseError))
+    {
+        error = file.getFileName() + ", " + juce::String(parseError);
+        return false;
+    }
+    
+    const int id = RCA_MK2_SEF::addKnobTable(table);
+    
+    if (id < 0)
+    {
+        error = "Too many knob tables loaded, restart to load more";
+        return false;
+    }
+    
+    // the audio thread picks the id up in its next updateFilters()
+    knobTableId.store(id);
+    requestResponseUpdate();
+    return true;
+}
+
+
+FilterSettings RCAMKIISoundEffectsFilterAudioProcessor::getCurrentSettings() const
+{
+    FilterSettings settings;
+    
+    settings.sampleRate = getSampleRate() > 0 ? getSampleRate() : 48000.0;
+    
+    settings.highPassContinuous = isHighPassContinuous;
+    settings.lowPassContinuous = isLowPassContinuous;
+    
+    settings.highPassCutoff = highPassCutoffParam->load();
+    settings.lowPassCutoff = lowPassCutoffParam->load();
+    settings.highPassKnobPos = highPassKnobParam->load();
+    settings.lowPassKnobPos = lowPassKnobParam->load();
+    settings.knobTable = knobTableId.load();
+    
+    settings.highPassMod = highPassMod;
+    settings.lowPassMod = lowPassMod;
+    
+    settings.inputImpedance = mapImpedanceVal(inputImpedanceParam->load());
+    settings.outputImpedance = mapImpedanceVal(outputImpedanceParam->load());
+    
+    settings.analogMatched = analogMatchParam->load() >= 0.5f;
+    settings.tolerance = tolerance.load() * 0.01f;
+    
+    return settings;
+}
 
 
 void RCAMKIISoundEffectsFilterAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    RCA_SCOPED_REALTIME_GUARD
     
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     
-    float lowPassCutoff = apvts.getRawParameterValue("LOW_PASS_CUTOFF")->load();
-    float highPassCutoff = apvts.getRawParameterValue("HIGH_PASS_CUTOFF")->load();
-    
-    int highPassKnobPos = apvts.getRawParameterValue("DISC_HIGH_PASS")->load();
-    int lowPassKnobPos = apvts.getRawParameterValue("DISC_LOW_PASS")->load();
+    int highPassKnobPos = highPassKnobParam->load();
+    int lowPassKnobPos = lowPassKnobParam->load();
     
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-    {
         buffer.clear (i, 0, buffer.getNumSamples());
-        hpfSmooth[i].setTargetValue(highPassCutoff);
-        lpfSmooth[i].setTargetValue(lowPassCutoff);
-
-    }
-        
 
 
     if (highPassKnobPos != prevHighPassKnobPos || lowPassKnobPos != prevLowPassKnobPos)
     {
-        for (auto& filter : filters)
-            filter.reset();
+        filtersNeedReset.store(true);
         prevHighPassKnobPos = highPassKnobPos;
         prevLowPassKnobPos = lowPassKnobPos;
         
     }
-
-    float ZInput = apvts.getRawParameterValue("Z_INPUT")->load();
-    float ZOutput = apvts.getRawParameterValue("Z_OUTPUT")->load();
     
-    float gainDB = apvts.getRawParameterValue("OUTPUT_GAIN")->load();
+    // the editor's toggles ask for this too, rather than touching the filters mid-block
+    if (filtersNeedReset.exchange(false))
+        for (int channel = 0; channel < numChannelsPrepared; ++channel)
+            channels[channel].filter.reset();
+
+    float gainDB = outputGainParam->load();
     float gain = juce::Decibels::decibelsToGain(gainDB);
     
-    float mappedZIn = mapImpedanceVal(ZInput);
-    float mappedZOut = mapImpedanceVal(ZOutput);
+    updateFilters();
     
-    dummy.setLowPassCutoff(lowPassCutoff);
-    dummy.setHighPassCutoff(highPassCutoff);
-    dummy.setInputImpedance(mappedZIn);
-    dummy.setOutputImpedance(mappedZOut);
+    if (hasRestoredWaveState.load(std::memory_order_acquire))
+        applyRestoredWaveState();
     
-    updateFilters();
+    // the sidechain's channels come after the main input's, and only feed the envelope
+    const int numChannels = juce::jmin(getMainBusNumInputChannels(), numChannelsPrepared);
+    const int numSamples = buffer.getNumSamples();
     
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    for (int channel = 0; channel < numChannels; ++channel)
+        channels[channel].data = buffer.getWritePointer(channel);
+    
+    if (modulator.isActive())
     {
-        hpfSmooth[channel].setTargetValue(highPassCutoff);
-        lpfSmooth[channel].setTargetValue(lowPassCutoff);
+        processModulated(buffer, numChannels);
         
-        filters[channel].setInputImpedance(mappedZIn);
-        filters[channel].setOutputImpedance(mappedZOut);
-            
-
-        auto* channelData = buffer.getWritePointer (channel);
+        for (int channel = 0; channel < numChannels; ++channel)
+            buffer.applyGain(channel, 0, buffer.getNumSamples(), gain);
+        
+        publishWaveState();
+        return;
+    }
+    
+    auto processChannel = [this, numSamples, gain](int channel)
+    {
+        auto& filter = channels[channel].filter;
+        auto* channelData = channels[channel].data;
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        for (int sample = 0; sample < numSamples; ++sample)
         {
             const float inSample = channelData[sample];
             
-            const float outSample = filters[channel].processSample(inSample);
+            const float outSample = filter.processSample(inSample);
             
             channelData[sample] = gain * outSample;
         }
+    };
+    
+    forEachChannel(numChannels, numSamples, processChannel);
+    
+    publishWaveState();
+}
+
+void RCAMKIISoundEffectsFilterAudioProcessor::publishWaveState()
+{
+    if (storeWaveState.load(std::memory_order_relaxed))
+        currentWaveState.write(numChannelsPrepared, int(filterEngine), [this](int channel) {return channels[channel].filter.getExactState();});
+}
+
+void RCAMKIISoundEffectsFilterAudioProcessor::applyRestoredWaveState()
+{
+    PluginState::SharedWaveState<maxChannels>::States states;
+    int numChannels = 0, engine = 0;
+    
+    hasRestoredWaveState.store(false);
+    
+    // setStateInformation() is part way through writing it: leave it for the next block
+    if (! restoredWaveState.tryRead(states, numChannels, engine))
+    {
+        hasRestoredWaveState.store(true);
+        return;
     }
+    
+    // a state from a different engine's equations would just be noise; channels the session
+    // didn't save (it had a narrower bus) carry on from where they are
+    if (engine == int(filterEngine))
+        for (int channel = 0; channel < juce::jmin(numChannels, numChannelsPrepared); ++channel)
+            channels[channel].filter.setExactState(states[size_t(channel)]);
 }
 
 //==============================================================================
@@ -301,15 +565,76 @@ juce::AudioProcessorEditor* RCAMKIISoundEffectsFilterAudioProcessor::createEdito
 //==============================================================================
 void RCAMKIISoundEffectsFilterAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    PluginState state;
+    
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.parameters.emplace_back(PluginState::hashParameterID(ranged->paramID),
+                                          ranged->convertFrom0to1(ranged->getValue()));
+    
+    state.isHighPassContinuous = isHighPassContinuous;
+    state.isLowPassContinuous = isLowPassContinuous;
+    state.highPassMod = highPassMod;
+    state.lowPassMod = lowPassMod;
+    state.tolerance = tolerance;
+    state.storeWaveState = storeWaveState;
+    
+    if (const int id = knobTableId.load(); id != 0)
+    {
+        state.hasKnobTable = true;
+        state.knobTable = RCA_MK2_SEF::getKnobTable(id);
+    }
+    
+    PluginState::SharedWaveState<maxChannels>::States states;
+    int numChannels = 0;
+    
+    if (storeWaveState && currentWaveState.read(states, numChannels, state.engine))
+    {
+        state.hasWaveState = true;
+        state.waveStates.assign(states.begin(), states.begin() + numChannels);
+    }
+    
+    state.writeTo(destData);
 }
 
 void RCAMKIISoundEffectsFilterAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    PluginState state;
+    
+    if (! state.readFrom(data, sizeInBytes))
+        return;
+    
+    std::unordered_map<uint32_t, juce::RangedAudioParameter*> parametersByHash;
+    
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            parametersByHash[PluginState::hashParameterID(ranged->paramID)] = ranged;
+    
+    for (const auto& [hash, value] : state.parameters)
+        if (auto it = parametersByHash.find(hash); it != parametersByHash.end())
+            it->second->setValueNotifyingHost(it->second->convertTo0to1(value));
+    
+    isHighPassContinuous = state.isHighPassContinuous;
+    isLowPassContinuous = state.isLowPassContinuous;
+    highPassMod = state.highPassMod;
+    lowPassMod = state.lowPassMod;
+    tolerance = state.tolerance;
+    storeWaveState = state.storeWaveState;
+    
+    // a table this build can't register any more falls back to the built-in values
+    const int id = state.hasKnobTable ? RCA_MK2_SEF::addKnobTable(state.knobTable) : 0;
+    knobTableId.store(juce::jmax(0, id));
+    
+    if (state.hasWaveState && ! state.waveStates.empty())
+    {
+        restoredWaveState.write(int(state.waveStates.size()), state.engine,
+                                [&](int channel) {return state.waveStates[size_t(channel)];});
+        hasRestoredWaveState.store(true, std::memory_order_release);
+    }
+    
+    // nothing's rebuilt here: prepareToPlay(), or the next block if it's already playing, does that
+    coefficientsDirty.store(true);
+    sendChangeMessage();
 }
 
 //==============================================================================
@@ -10,16 +10,26 @@
 
 #include <JuceHeader.h>
 #include "RCA_MKII_SEF.h"
+#include "RCA_CoefficientCache.h"
+#include "RCA_EnvelopeModulation.h"
+#include "RCA_ChannelWorkers.h"
+#include "RealtimeGuard.h"
+#include "ResponseAnalyser.h"
+#include "PluginState.h"
 
 //==============================================================================
 /**
 */
-class RCAMKIISoundEffectsFilterAudioProcessor  : public juce::AudioProcessor
+class RCAMKIISoundEffectsFilterAudioProcessor  : public juce::AudioProcessor,
+                                                 public juce::ChangeBroadcaster  // after setStateInformation(), for the editor's toggles
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
 {
 public:
+    /** Widest main bus the filter runs on, e.g. 64 channels of seventh-order ambisonics */
+    static constexpr int maxChannels = PluginState::maxChannels;
+    
     //==============================================================================
     RCAMKIISoundEffectsFilterAudioProcessor();
     ~RCAMKIISoundEffectsFilterAudioProcessor() override;
@@ -55,22 +65,62 @@ public:
 
     //==============================================================================
     void getStateInformation (juce::MemoryBlock& destData) override;
+    
+    /** Only takes the values; the filters pick them up in prepareToPlay() or the next block */
     void setStateInformation (const void* data, int sizeInBytes) override;
     
+    /**
+     * Saves each channel's wave state with the session too, so that a render picks up
+     * exactly where the last one left off. Off by default: a session normally starts silent.
+     * Set by the editor's SAVE STATE toggle, read by the audio thread, and saved with the session.
+     */
+    std::atomic<bool> storeWaveState {false};
+    
+    /** Audio thread only. Resolves the current settings through the shared cache if they've changed */
     void updateFilters();
     float getCurrentGain();
     
-    void computeMagnitudeResponse(std::array<float, fftSize>& result) {dummy.computeMagnitudeResponse(result);}
-
-    std::array<RCA_MK2_SEF, 2>& getFilters() {return filters;}
+    /** Snapshot of the parameters and toggles that shape the response */
+    FilterSettings getCurrentSettings() const;
+    
+    /** Asks the analyser to recompute the response for the current settings in the background */
+    void requestResponseUpdate(ResponseAnalyser::Resolution resolution = ResponseAnalyser::Resolution::full)
+    {
+        analyser.requestUpdate(getCurrentSettings(), resolution);
+    }
+    
+    ResponseAnalyser& getResponseAnalyser() {return analyser;}
+    
+    /**
+     * Message thread only. Switches the CUTOFF POS knobs over to a table written by
+     * Tools/ComponentFit (see RCA_MK2_SEF::parseKnobTable), or says why it couldn't.
+     */
+    bool loadKnobTable(const juce::File& file, juce::String& error);
     
-    RCA_MK2_SEF& getDummy() {return dummy;};
+    /** Back to the built-in knob positions */
+    void resetKnobTable() {knobTableId.store(0); requestResponseUpdate();}
+    
+    bool hasCustomKnobTable() const {return knobTableId.load() != 0;}
+
+    /** Any thread. Every channel's filter starts the next block from rest */
+    void resetFilters() {filtersNeedReset.store(true);}
         
-    bool isHighPassContinuous = true;
-    bool isLowPassContinuous = true;
+    /** The CONTROLS and MOD switches: written by the editor, read by the audio and analyser threads */
+    std::atomic<bool> isHighPassContinuous {true};
+    std::atomic<bool> isLowPassContinuous {true};
+    
+    std::atomic<int> highPassMod {1};
+    std::atomic<int> lowPassMod {1};
+    
+    std::atomic<bool> highPassControlsChanged {false};
+    std::atomic<bool> lowPassControlsChanged {false};
     
-    bool highPassControlsChanged = false;
-    bool lowPassControlsChanged = false;
+    /**
+     * Component tolerance in percent. It only shapes the response display (the spread of
+     * units built from parts this far off), so it's saved with the session but kept out
+     * of the APVTS, where a host would offer it for automation.
+     */
+    std::atomic<float> tolerance {0.f};
         
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
@@ -78,14 +128,104 @@ public:
 private:
     //==============================================================================
     
-    std::array<RCA_MK2_SEF, 2> filters;
-    RCA_MK2_SEF dummy;
+    /**
+     * One channel's filter and the part of the buffer it's working on: the task a worker
+     * picks up. Whole cache lines each, so workers on neighbouring channels never share one.
+     */
+    struct alignas(ChannelWorkers::cacheLineSize) Channel
+    {
+        RCA_MK2_SEF filter;
+        float* data = nullptr;
+    };
+    
+    /** One per main bus channel, allocated in prepareToPlay() */
+    std::unique_ptr<Channel[]> channels;
+    int numChannelsPrepared = 0;
+    
+    RCA_MK2_SEF::Engine filterEngine = RCA_MK2_SEF::Engine::flat;
+    std::atomic<bool> filtersNeedReset {false};
+    
+    /**
+     * Only made for buses of minChannelsForWorkers or more, and only used for blocks of at
+     * least minChannelSamplesForWorkers in all: below that, waking the workers costs more
+     * than it saves. Its threads are started in prepareToPlay(), never on the audio thread.
+     */
+    std::unique_ptr<ChannelWorkers::Pool> workers;
+    static constexpr int minChannelsForWorkers = 4;
+    static constexpr int minChannelSamplesForWorkers = 2048;
+    
+    /** Audio thread only. Calls job(channel) for each channel, spread over the workers if it's worth it */
+    template <typename Job>
+    void forEachChannel(int numChannels, int numSamples, Job& job)
+    {
+        if (workers != nullptr && numChannels >= minChannelsForWorkers && numChannels * numSamples >= minChannelSamplesForWorkers)
+        {
+            workers->run(numChannels, job);
+            return;
+        }
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+            job(channel);
+    }
+    
+    ResponseAnalyser analyser;
+    
+    /**
+     * Shared with every other open instance, and taken in the constructor, so the audio thread
+     * never builds the cache or starts its fill thread. The last instance to close stops it.
+     */
+    juce::SharedResourcePointer<CoefficientCache> coefficientCache;
+    
+    /** What the filters were last set to; sampleRate 0 forces the first update */
+    CoefficientCache::Key filterKey;
     
     int prevHighPassKnobPos;
     int prevLowPassKnobPos;
     
-    juce::SmoothedValue<float> hpfSmooth[2];
-    juce::SmoothedValue<float> lpfSmooth[2];
+    /** RCA_MK2_SEF::getKnobTable() id for the knob positions, 0 for the built-in table */
+    std::atomic<int> knobTableId {0};
+    
+    /**
+     * isNonRealtime() as of the last prepareToPlay(). While it's set the filters run
+     * Engine::precise whatever ANALOG MATCH says, so a bounce never changes engine part way.
+     */
+    bool isRenderingOffline = false;
+    
+    /** Set by setStateInformation(); the next updateFilters() rebuilds whatever the key says */
+    std::atomic<bool> coefficientsDirty {false};
+    
+    /** The audio thread's wave state after every block, and a restored one waiting for it */
+    PluginState::SharedWaveState<maxChannels> currentWaveState;
+    PluginState::SharedWaveState<maxChannels> restoredWaveState;
+    std::atomic<bool> hasRestoredWaveState {false};
+    
+    void publishWaveState();
+    void applyRestoredWaveState();
+    
+    /** Cached so the audio thread never looks parameters up by (allocating) string ID */
+    std::atomic<float>* highPassCutoffParam = nullptr;
+    std::atomic<float>* lowPassCutoffParam = nullptr;
+    std::atomic<float>* highPassKnobParam = nullptr;
+    std::atomic<float>* lowPassKnobParam = nullptr;
+    std::atomic<float>* inputImpedanceParam = nullptr;
+    std::atomic<float>* outputImpedanceParam = nullptr;
+    std::atomic<float>* outputGainParam = nullptr;
+    std::atomic<float>* analogMatchParam = nullptr;
+    std::atomic<float>* envelopeHighPassParam = nullptr;
+    std::atomic<float>* envelopeLowPassParam = nullptr;
+    std::atomic<float>* envelopeAttackParam = nullptr;
+    std::atomic<float>* envelopeReleaseParam = nullptr;
+    std::atomic<float>* envelopeSensitivityParam = nullptr;
+    std::atomic<float>* envelopeSidechainParam = nullptr;
+    
+    /** Moves the cutoffs with the input (or sidechain) envelope, on top of the settings above */
+    EnvelopeModulation::Modulator modulator;
+    bool wasModulating = false;
+    
+    /** Samples between cutoff updates while the envelope is moving them */
+    static constexpr int envelopeUpdateInterval = 16;
+    
+    void processModulated(juce::AudioBuffer<float>& buffer, int numChannels);
     
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RCAMKIISoundEffectsFilterAudioProcessor)
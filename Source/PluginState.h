@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+    PluginState.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    What a session stores for the plugin: every parameter, the CONTROLS and
+    MOD switches and the display's component tolerance, which live outside
+    the APVTS, a fitted knob table if one is loaded and, optionally, each
+    channel's wave state. It's written as
+    little-endian binary, a few hundred bytes, with a version so that later
+    builds can still read it.
+
+    Parameters are stored against a hash of their ID, so adding or removing
+    one doesn't upset older sessions: unknown ones are skipped and missing
+    ones keep their defaults.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RCA_MKII_SEF.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+struct PluginState
+{
+    static constexpr uint32_t magicNumber = 0x53414352; // "RCAS"
+    static constexpr int currentVersion = 1;
+
+    /** At most one wave state per filter; more than that in a state means it's damaged */
+    static constexpr int maxChannels = 64;
+
+    enum Flags
+    {
+        highPassContinuousFlag = 1 << 0,
+        lowPassContinuousFlag  = 1 << 1,
+        highPassModFlag        = 1 << 2,
+        lowPassModFlag         = 1 << 3,
+        knobTableFlag          = 1 << 4,
+        waveStateFlag          = 1 << 5,
+        storeWaveStateFlag     = 1 << 6
+    };
+
+    /** Parameter ID hash and plain (not normalised) value */
+    std::vector<std::pair<uint32_t, float>> parameters;
+
+    bool isHighPassContinuous = true;
+    bool isLowPassContinuous = true;
+    int highPassMod = 1;
+    int lowPassMod = 1;
+
+    /** Percent */
+    float tolerance = 0.f;
+
+    bool hasKnobTable = false;
+    RCA_MK2_SEF::KnobTable knobTable;
+
+    /** Whether later saves should keep taking the wave state, which may not have been captured yet */
+    bool storeWaveState = false;
+
+    /** Only means anything to filters running the same engine */
+    bool hasWaveState = false;
+    int engine = 0;
+    std::vector<RCA_MK2_SEF::ExactState> waveStates;
+
+    /** FNV-1a over the ID's UTF-8, which (unlike String::hashCode()) is pinned down here for good */
+    static uint32_t hashParameterID(const juce::String& id)
+    {
+        uint32_t h = 2166136261u;
+
+        for (auto* c = id.toRawUTF8(); *c != 0; ++c)
+        {
+            h ^= (uint8_t) *c;
+            h *= 16777619u;
+        }
+
+        return h;
+    }
+
+    void writeTo(juce::MemoryBlock& dest) const
+    {
+        juce::MemoryOutputStream out(dest, false);
+
+        int flags = (isHighPassContinuous ? highPassContinuousFlag : 0)
+                  | (isLowPassContinuous ? lowPassContinuousFlag : 0)
+                  | (highPassMod != 0 ? highPassModFlag : 0)
+                  | (lowPassMod != 0 ? lowPassModFlag : 0)
+                  | (hasKnobTable ? knobTableFlag : 0)
+                  | (hasWaveState ? waveStateFlag : 0)
+                  | (storeWaveState ? storeWaveStateFlag : 0);
+
+        out.writeInt((int) magicNumber);
+        out.writeShort((short) currentVersion);
+        out.writeShort((short) flags);
+
+        out.writeShort((short) parameters.size());
+
+        for (const auto& [hash, value] : parameters)
+        {
+            out.writeInt((int) hash);
+            out.writeFloat(value);
+        }
+
+        out.writeFloat(tolerance);
+
+        if (hasKnobTable)
+        {
+            for (const auto* positions : {&knobTable.highPass, &knobTable.lowPass})
+            {
+                for (const auto& position : *positions)
+                {
+                    out.writeInt(position.cutoff);
+                    out.writeFloat(position.C);
+                    out.writeFloat(position.L);
+                }
+            }
+        }
+
+        if (hasWaveState)
+        {
+            out.writeShort((short) engine);
+            out.writeShort((short) waveStates.size());
+
+            for (const auto& state : waveStates)
+                for (auto z : state)
+                    out.writeDouble(z);
+        }
+    }
+
+    /** False for anything that isn't a state this version can read, leaving this as it was */
+    bool readFrom(const void* data, int sizeInBytes)
+    {
+        juce::MemoryInputStream in(data, (size_t) juce::jmax(0, sizeInBytes), false);
+        PluginState state;
+
+        auto has = [&](int numBytes) { return in.getNumBytesRemaining() >= numBytes; };
+
+        if (! has(10) || (uint32_t) in.readInt() != magicNumber)
+            return false;
+
+        const int version = in.readShort();
+        const int flags = in.readShort();
+
+        if (version != currentVersion)
+            return false;
+
+        state.isHighPassContinuous = (flags & highPassContinuousFlag) != 0;
+        state.isLowPassContinuous = (flags & lowPassContinuousFlag) != 0;
+        state.highPassMod = (flags & highPassModFlag) != 0 ? 1 : 0;
+        state.lowPassMod = (flags & lowPassModFlag) != 0 ? 1 : 0;
+        state.storeWaveState = (flags & storeWaveStateFlag) != 0;
+
+        const int numParameters = (uint16_t) in.readShort();
+
+        if (! has(numParameters * 8))
+            return false;
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            const auto hash = (uint32_t) in.readInt();
+            state.parameters.emplace_back(hash, in.readFloat());
+        }
+
+        if (! has(4))
+            return false;
+
+        state.tolerance = in.readFloat();
+
+        state.hasKnobTable = (flags & knobTableFlag) != 0;
+
+        if (state.hasKnobTable)
+        {
+            if (! has(2 * 11 * 12))
+                return false;
+
+            for (auto* positions : {&state.knobTable.highPass, &state.knobTable.lowPass})
+            {
+                for (auto& position : *positions)
+                {
+                    position.cutoff = in.readInt();
+                    position.C = in.readFloat();
+                    position.L = in.readFloat();
+                }
+            }
+        }
+
+        state.hasWaveState = (flags & waveStateFlag) != 0;
+
+        if (state.hasWaveState)
+        {
+            if (! has(4))
+                return false;
+
+            state.engine = in.readShort();
+            const int numChannels = in.readShort();
+
+            if (numChannels < 0 || numChannels > maxChannels || ! has(numChannels * RCA_MK2_SEF::numStates * 8))
+                return false;
+
+            state.waveStates.resize((size_t) numChannels);
+
+            for (auto& channel : state.waveStates)
+                for (auto& z : channel)
+                    z = in.readDouble();
+        }
+
+        *this = std::move(state);
+        return true;
+    }
+
+    //==============================================================================
+    /**
+     * Wave states handed between the audio thread and the message thread without a lock:
+     * a sequence number that's odd while a write is under way, and a reader that tries
+     * again if it changed while it was copying. One writer at a time. The audio thread
+     * only ever makes one try, so a writer that's been preempted can't hold it up.
+     */
+    template <int maxNumChannels>
+    class SharedWaveState
+    {
+    public:
+        using States = std::array<RCA_MK2_SEF::ExactState, (size_t) maxNumChannels>;
+
+        /** Stores getState(channel) for the first numChannels channels (at most maxNumChannels) */
+        template <typename GetState>
+        void write(int numChannels, int engine, GetState&& getState) noexcept
+        {
+            numChannels = juce::jlimit(0, maxNumChannels, numChannels);
+
+            const auto start = sequence.load(std::memory_order_relaxed);
+            sequence.store(start + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const RCA_MK2_SEF::ExactState state = getState(c);
+
+                for (size_t i = 0; i < state.size(); ++i)
+                    values[(size_t) c * RCA_MK2_SEF::numStates + i].store(state[i], std::memory_order_relaxed);
+            }
+
+            savedNumChannels.store(numChannels, std::memory_order_relaxed);
+            savedEngine.store(engine, std::memory_order_relaxed);
+            sequence.store(start + 2, std::memory_order_release);
+        }
+
+        /** False if nothing's been written yet. Waits out a write under way, so not for the audio thread */
+        bool read(States& states, int& numChannels, int& engine) const noexcept
+        {
+            while (sequence.load(std::memory_order_acquire) != 0)
+            {
+                if (tryRead(states, numChannels, engine))
+                    return true;
+
+                std::this_thread::yield();
+            }
+
+            return false;
+        }
+
+        /**
+         * One try at read(), for the audio thread: false if nothing's been written yet, or a
+         * write was under way. Only the first numChannels of states are filled in.
+         */
+        bool tryRead(States& states, int& numChannels, int& engine) const noexcept
+        {
+            const auto start = sequence.load(std::memory_order_acquire);
+
+            if (start == 0 || (start & 1) != 0)
+                return false;
+
+            numChannels = savedNumChannels.load(std::memory_order_relaxed);
+
+            for (size_t c = 0; c < (size_t) numChannels; ++c)
+                for (size_t i = 0; i < states[c].size(); ++i)
+                    states[c][i] = values[c * RCA_MK2_SEF::numStates + i].load(std::memory_order_relaxed);
+
+            engine = savedEngine.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            return sequence.load(std::memory_order_relaxed) == start;
+        }
+
+    private:
+        std::atomic<uint32_t> sequence {0};
+        std::atomic<int> savedNumChannels {0};
+        std::atomic<int> savedEngine {0};
+        std::array<std::atomic<double>, (size_t) maxNumChannels * RCA_MK2_SEF::numStates> values {};
+
+        static_assert(std::atomic<double>::is_always_lock_free, "the audio thread writes these");
+    };
+};
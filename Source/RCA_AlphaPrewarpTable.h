@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    RCA_AlphaPrewarpTable.h
+
+    Generated by Tools/AlphaPrewarpFit. Don't edit by hand, run it again.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+namespace AlphaPrewarpTable
+{
+    constexpr int numPoints = 48;
+
+    /** Normalised cutoffs fc / fs of the first and last points, which are log-spaced */
+    constexpr double minCutoff = 0.002;
+    constexpr double maxCutoff = 0.75;
+
+    /** {alpha, component scale} per point, [mod off / on][point] */
+    constexpr float highPass[2][numPoints][2] =
+    {
+        {   // mod off
+            { 0.998643f, 0.999996f },  // fc/fs 0.0020: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998453f, 0.999995f },  // fc/fs 0.0023: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998246f, 0.999993f },  // fc/fs 0.0026: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998011f, 0.999991f },  // fc/fs 0.0029: worst 0.00 dB, bilinear 0.00 dB
+            { 0.997749f, 0.999989f },  // fc/fs 0.0033: worst 0.00 dB, bilinear 0.00 dB
+            { 0.997447f, 0.999986f },  // fc/fs 0.0038: worst 0.00 dB, bilinear 0.00 dB
+            { 0.997088f, 0.999982f },  // fc/fs 0.0043: worst 0.00 dB, bilinear 0.00 dB
+            { 0.996703f, 0.999977f },  // fc/fs 0.0048: worst 0.00 dB, bilinear 0.00 dB
+            { 0.996265f, 0.999970f },  // fc/fs 0.0055: worst 0.00 dB, bilinear 0.00 dB
+            { 0.995769f, 0.999961f },  // fc/fs 0.0062: worst 0.00 dB, bilinear 0.00 dB
+            { 0.995207f, 0.999950f },  // fc/fs 0.0071: worst 0.00 dB, bilinear 0.00 dB
+            { 0.994529f, 0.999937f },  // fc/fs 0.0080: worst 0.00 dB, bilinear 0.00 dB
+            { 0.993806f, 0.999918f },  // fc/fs 0.0091: worst 0.00 dB, bilinear 0.00 dB
+            { 0.992980f, 0.999894f },  // fc/fs 0.0103: worst 0.00 dB, bilinear 0.00 dB
+            { 0.992049f, 0.999863f },  // fc/fs 0.0117: worst 0.00 dB, bilinear 0.01 dB
+            { 0.990996f, 0.999822f },  // fc/fs 0.0133: worst 0.00 dB, bilinear 0.01 dB
+            { 0.989725f, 0.999778f },  // fc/fs 0.0150: worst 0.00 dB, bilinear 0.01 dB
+            { 0.988365f, 0.999712f },  // fc/fs 0.0171: worst 0.00 dB, bilinear 0.01 dB
+            { 0.986821f, 0.999627f },  // fc/fs 0.0194: worst 0.00 dB, bilinear 0.01 dB
+            { 0.985077f, 0.999517f },  // fc/fs 0.0220: worst 0.01 dB, bilinear 0.02 dB
+            { 0.983102f, 0.999375f },  // fc/fs 0.0249: worst 0.01 dB, bilinear 0.02 dB
+            { 0.980718f, 0.999219f },  // fc/fs 0.0283: worst 0.01 dB, bilinear 0.03 dB
+            { 0.978170f, 0.998989f },  // fc/fs 0.0321: worst 0.01 dB, bilinear 0.04 dB
+            { 0.975285f, 0.998692f },  // fc/fs 0.0364: worst 0.01 dB, bilinear 0.05 dB
+            { 0.972016f, 0.998308f },  // fc/fs 0.0413: worst 0.02 dB, bilinear 0.06 dB
+            { 0.968321f, 0.997811f },  // fc/fs 0.0468: worst 0.02 dB, bilinear 0.08 dB
+            { 0.963861f, 0.997268f },  // fc/fs 0.0531: worst 0.03 dB, bilinear 0.11 dB
+            { 0.959088f, 0.996471f },  // fc/fs 0.0602: worst 0.04 dB, bilinear 0.14 dB
+            { 0.953688f, 0.995445f },  // fc/fs 0.0683: worst 0.05 dB, bilinear 0.18 dB
+            { 0.947574f, 0.994125f },  // fc/fs 0.0775: worst 0.06 dB, bilinear 0.23 dB
+            { 0.940659f, 0.992431f },  // fc/fs 0.0879: worst 0.08 dB, bilinear 0.29 dB
+            { 0.932294f, 0.990601f },  // fc/fs 0.0997: worst 0.10 dB, bilinear 0.38 dB
+            { 0.923355f, 0.987931f },  // fc/fs 0.1131: worst 0.13 dB, bilinear 0.48 dB
+            { 0.913229f, 0.984537f },  // fc/fs 0.1283: worst 0.17 dB, bilinear 0.62 dB
+            { 0.901759f, 0.980242f },  // fc/fs 0.1456: worst 0.21 dB, bilinear 0.79 dB
+            { 0.888760f, 0.974837f },  // fc/fs 0.1651: worst 0.26 dB, bilinear 1.01 dB
+            { 0.872976f, 0.969252f },  // fc/fs 0.1873: worst 0.33 dB, bilinear 1.29 dB
+            { 0.856109f, 0.961239f },  // fc/fs 0.2125: worst 0.41 dB, bilinear 1.65 dB
+            { 0.837002f, 0.951457f },  // fc/fs 0.2411: worst 0.50 dB, bilinear 2.09 dB
+            { 0.815424f, 0.939679f },  // fc/fs 0.2735: worst 0.59 dB, bilinear 2.64 dB
+            { 0.791224f, 0.925714f },  // fc/fs 0.3102: worst 0.68 dB, bilinear 3.33 dB
+            { 0.762172f, 0.913245f },  // fc/fs 0.3519: worst 0.77 dB, bilinear 4.17 dB
+            { 0.732822f, 0.895426f },  // fc/fs 0.3992: worst 0.82 dB, bilinear 5.18 dB
+            { 0.702361f, 0.874809f },  // fc/fs 0.4529: worst 0.83 dB, bilinear 6.40 dB
+            { 0.672747f, 0.850262f },  // fc/fs 0.5138: worst 0.78 dB, bilinear 7.81 dB
+            { 0.646890f, 0.819374f },  // fc/fs 0.5828: worst 0.67 dB, bilinear 9.45 dB
+            { 0.621484f, 0.791721f },  // fc/fs 0.6611: worst 0.56 dB, bilinear 11.30 dB
+            { 0.614073f, 0.736171f },  // fc/fs 0.7500: worst 0.37 dB, bilinear 13.36 dB
+        },
+        {   // mod on
+            { 0.999220f, 0.999988f },  // fc/fs 0.0020: worst 0.00 dB, bilinear 0.00 dB
+            { 0.999120f, 0.999985f },  // fc/fs 0.0023: worst 0.00 dB, bilinear 0.00 dB
+            { 0.999008f, 0.999980f },  // fc/fs 0.0026: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998879f, 0.999974f },  // fc/fs 0.0029: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998744f, 0.999968f },  // fc/fs 0.0033: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998586f, 0.999959f },  // fc/fs 0.0038: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998409f, 0.999946f },  // fc/fs 0.0043: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998210f, 0.999930f },  // fc/fs 0.0048: worst 0.00 dB, bilinear 0.00 dB
+            { 0.997986f, 0.999910f },  // fc/fs 0.0055: worst 0.00 dB, bilinear 0.01 dB
+            { 0.997749f, 0.999888f },  // fc/fs 0.0062: worst 0.00 dB, bilinear 0.01 dB
+            { 0.997471f, 0.999855f },  // fc/fs 0.0071: worst 0.00 dB, bilinear 0.01 dB
+            { 0.997164f, 0.999811f },  // fc/fs 0.0080: worst 0.00 dB, bilinear 0.01 dB
+            { 0.996823f, 0.999755f },  // fc/fs 0.0091: worst 0.00 dB, bilinear 0.01 dB
+            { 0.996445f, 0.999683f },  // fc/fs 0.0103: worst 0.00 dB, bilinear 0.02 dB
+            { 0.996048f, 0.999605f },  // fc/fs 0.0117: worst 0.01 dB, bilinear 0.02 dB
+            { 0.995589f, 0.999488f },  // fc/fs 0.0133: worst 0.01 dB, bilinear 0.03 dB
+            { 0.995085f, 0.999337f },  // fc/fs 0.0150: worst 0.01 dB, bilinear 0.04 dB
+            { 0.994535f, 0.999140f },  // fc/fs 0.0171: worst 0.01 dB, bilinear 0.05 dB
+            { 0.993934f, 0.998885f },  // fc/fs 0.0194: worst 0.02 dB, bilinear 0.06 dB
+            { 0.993314f, 0.998609f },  // fc/fs 0.0220: worst 0.02 dB, bilinear 0.08 dB
+            { 0.992618f, 0.998196f },  // fc/fs 0.0249: worst 0.02 dB, bilinear 0.10 dB
+            { 0.991872f, 0.997662f },  // fc/fs 0.0283: worst 0.03 dB, bilinear 0.13 dB
+            { 0.991081f, 0.996967f },  // fc/fs 0.0321: worst 0.04 dB, bilinear 0.17 dB
+            { 0.990249f, 0.996066f },  // fc/fs 0.0364: worst 0.05 dB, bilinear 0.22 dB
+            { 0.989362f, 0.995056f },  // fc/fs 0.0413: worst 0.06 dB, bilinear 0.29 dB
+            { 0.988452f, 0.993581f },  // fc/fs 0.0468: worst 0.08 dB, bilinear 0.37 dB
+            { 0.987520f, 0.991661f },  // fc/fs 0.0531: worst 0.10 dB, bilinear 0.47 dB
+            { 0.986576f, 0.989163f },  // fc/fs 0.0602: worst 0.12 dB, bilinear 0.61 dB
+            { 0.985624f, 0.985911f },  // fc/fs 0.0683: worst 0.16 dB, bilinear 0.78 dB
+            { 0.984065f, 0.982237f },  // fc/fs 0.0775: worst 0.21 dB, bilinear 1.01 dB
+            { 0.982771f, 0.976931f },  // fc/fs 0.0879: worst 0.27 dB, bilinear 1.29 dB
+            { 0.981262f, 0.970061f },  // fc/fs 0.0997: worst 0.35 dB, bilinear 1.66 dB
+            { 0.979411f, 0.961186f },  // fc/fs 0.1131: worst 0.44 dB, bilinear 2.12 dB
+            { 0.977078f, 0.949747f },  // fc/fs 0.1283: worst 0.56 dB, bilinear 2.71 dB
+            { 0.971271f, 0.937456f },  // fc/fs 0.1456: worst 0.75 dB, bilinear 3.46 dB
+            { 0.967071f, 0.919377f },  // fc/fs 0.1651: worst 0.95 dB, bilinear 4.40 dB
+            { 0.961907f, 0.896265f },  // fc/fs 0.1873: worst 1.18 dB, bilinear 5.54 dB
+            { 0.955483f, 0.866863f },  // fc/fs 0.2125: worst 1.46 dB, bilinear 6.98 dB
+            { 0.947457f, 0.829676f },  // fc/fs 0.2411: worst 1.78 dB, bilinear 8.68 dB
+            { 0.931579f, 0.792696f },  // fc/fs 0.2735: worst 2.23 dB, bilinear 10.74 dB
+            { 0.919582f, 0.737203f },  // fc/fs 0.3102: worst 2.59 dB, bilinear 13.09 dB
+            { 0.905519f, 0.668349f },  // fc/fs 0.3519: worst 2.97 dB, bilinear 15.76 dB
+            { 0.877123f, 0.593250f },  // fc/fs 0.3992: worst 2.81 dB, bilinear 16.78 dB
+            { 0.840724f, 0.511190f },  // fc/fs 0.4529: worst 1.38 dB, bilinear 15.77 dB
+            { 0.810501f, 0.444906f },  // fc/fs 0.5138: worst 0.39 dB, bilinear 16.98 dB
+            { 0.810501f, 0.444906f },  // fc/fs 0.5828: worst 0.00 dB, bilinear 0.00 dB
+            { 0.810501f, 0.444906f },  // fc/fs 0.6611: worst 0.00 dB, bilinear 0.00 dB
+            { 0.810501f, 0.444906f },  // fc/fs 0.7500: worst 0.00 dB, bilinear 0.00 dB
+        },
+    };
+
+    constexpr float lowPass[2][numPoints][2] =
+    {
+        {   // mod off
+            { 0.993231f, 0.999968f },  // fc/fs 0.0020: worst 0.00 dB, bilinear 0.00 dB
+            { 0.992179f, 0.999958f },  // fc/fs 0.0023: worst 0.00 dB, bilinear 0.00 dB
+            { 0.990956f, 0.999945f },  // fc/fs 0.0026: worst 0.00 dB, bilinear 0.00 dB
+            { 0.990515f, 0.999933f },  // fc/fs 0.0029: worst 0.00 dB, bilinear 0.00 dB
+            { 0.989019f, 0.999912f },  // fc/fs 0.0033: worst 0.00 dB, bilinear 0.00 dB
+            { 0.987333f, 0.999886f },  // fc/fs 0.0038: worst 0.00 dB, bilinear 0.00 dB
+            { 0.985357f, 0.999851f },  // fc/fs 0.0043: worst 0.00 dB, bilinear 0.00 dB
+            { 0.983087f, 0.999806f },  // fc/fs 0.0048: worst 0.00 dB, bilinear 0.00 dB
+            { 0.982227f, 0.999762f },  // fc/fs 0.0055: worst 0.00 dB, bilinear 0.00 dB
+            { 0.979474f, 0.999690f },  // fc/fs 0.0062: worst 0.00 dB, bilinear 0.01 dB
+            { 0.976309f, 0.999596f },  // fc/fs 0.0071: worst 0.00 dB, bilinear 0.01 dB
+            { 0.972645f, 0.999474f },  // fc/fs 0.0080: worst 0.00 dB, bilinear 0.01 dB
+            { 0.968443f, 0.999314f },  // fc/fs 0.0091: worst 0.00 dB, bilinear 0.01 dB
+            { 0.966836f, 0.999161f },  // fc/fs 0.0103: worst 0.00 dB, bilinear 0.02 dB
+            { 0.961743f, 0.998906f },  // fc/fs 0.0117: worst 0.00 dB, bilinear 0.02 dB
+            { 0.955876f, 0.998574f },  // fc/fs 0.0133: worst 0.01 dB, bilinear 0.03 dB
+            { 0.949143f, 0.998141f },  // fc/fs 0.0150: worst 0.01 dB, bilinear 0.04 dB
+            { 0.941420f, 0.997576f },  // fc/fs 0.0171: worst 0.01 dB, bilinear 0.05 dB
+            { 0.938479f, 0.997036f },  // fc/fs 0.0194: worst 0.01 dB, bilinear 0.06 dB
+            { 0.929171f, 0.996136f },  // fc/fs 0.0220: worst 0.01 dB, bilinear 0.08 dB
+            { 0.918490f, 0.994961f },  // fc/fs 0.0249: worst 0.02 dB, bilinear 0.10 dB
+            { 0.906282f, 0.993430f },  // fc/fs 0.0283: worst 0.03 dB, bilinear 0.13 dB
+            { 0.892341f, 0.991435f },  // fc/fs 0.0321: worst 0.03 dB, bilinear 0.17 dB
+            { 0.886977f, 0.989521f },  // fc/fs 0.0364: worst 0.04 dB, bilinear 0.21 dB
+            { 0.870264f, 0.986334f },  // fc/fs 0.0413: worst 0.05 dB, bilinear 0.27 dB
+            { 0.851224f, 0.982178f },  // fc/fs 0.0468: worst 0.07 dB, bilinear 0.36 dB
+            { 0.829529f, 0.976753f },  // fc/fs 0.0531: worst 0.09 dB, bilinear 0.47 dB
+            { 0.804943f, 0.969681f },  // fc/fs 0.0602: worst 0.12 dB, bilinear 0.61 dB
+            { 0.795323f, 0.962871f },  // fc/fs 0.0683: worst 0.13 dB, bilinear 0.75 dB
+            { 0.766025f, 0.951558f },  // fc/fs 0.0775: worst 0.18 dB, bilinear 0.98 dB
+            { 0.732932f, 0.936813f },  // fc/fs 0.0879: worst 0.23 dB, bilinear 1.30 dB
+            { 0.695732f, 0.917637f },  // fc/fs 0.0997: worst 0.30 dB, bilinear 1.71 dB
+            { 0.654180f, 0.892795f },  // fc/fs 0.1131: worst 0.38 dB, bilinear 2.27 dB
+            { 0.636785f, 0.868550f },  // fc/fs 0.1283: worst 0.43 dB, bilinear 2.80 dB
+            { 0.588756f, 0.829608f },  // fc/fs 0.1456: worst 0.54 dB, bilinear 3.75 dB
+            { 0.537473f, 0.780817f },  // fc/fs 0.1651: worst 0.67 dB, bilinear 5.07 dB
+            { 0.485388f, 0.721863f },  // fc/fs 0.1873: worst 0.79 dB, bilinear 6.94 dB
+            { 0.436941f, 0.654544f },  // fc/fs 0.2125: worst 0.89 dB, bilinear 9.67 dB
+            { 0.419251f, 0.590165f },  // fc/fs 0.2411: worst 0.92 dB, bilinear 12.63 dB
+            { 0.390528f, 0.515710f },  // fc/fs 0.2735: worst 0.93 dB, bilinear 18.86 dB
+            { 0.387717f, 0.445180f },  // fc/fs 0.3102: worst 0.90 dB, bilinear 31.12 dB
+            { 0.416862f, 0.377447f },  // fc/fs 0.3519: worst 0.78 dB, bilinear 55.72 dB
+            { 0.453810f, 0.308057f },  // fc/fs 0.3992: worst 0.63 dB, bilinear 55.62 dB
+            { 0.493908f, 0.239254f },  // fc/fs 0.4529: worst 0.47 dB, bilinear 55.42 dB
+            { 0.535246f, 0.174926f },  // fc/fs 0.5138: worst 0.32 dB, bilinear 55.02 dB
+            { 0.574367f, 0.119332f },  // fc/fs 0.5828: worst 0.19 dB, bilinear 54.27 dB
+            { 0.607011f, 0.075773f },  // fc/fs 0.6611: worst 0.11 dB, bilinear 53.00 dB
+            { 0.630394f, 0.045130f },  // fc/fs 0.7500: worst 0.05 dB, bilinear 51.13 dB
+        },
+        {   // mod on
+            { 0.999069f, 0.999990f },  // fc/fs 0.0020: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998912f, 0.999987f },  // fc/fs 0.0023: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998912f, 0.999984f },  // fc/fs 0.0026: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998726f, 0.999980f },  // fc/fs 0.0029: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998508f, 0.999974f },  // fc/fs 0.0033: worst 0.00 dB, bilinear 0.00 dB
+            { 0.998251f, 0.999966f },  // fc/fs 0.0038: worst 0.00 dB, bilinear 0.00 dB
+            { 0.997958f, 0.999955f },  // fc/fs 0.0043: worst 0.00 dB, bilinear 0.00 dB
+            { 0.997954f, 0.999945f },  // fc/fs 0.0048: worst 0.00 dB, bilinear 0.00 dB
+            { 0.997605f, 0.999928f },  // fc/fs 0.0055: worst 0.00 dB, bilinear 0.00 dB
+            { 0.997194f, 0.999907f },  // fc/fs 0.0062: worst 0.00 dB, bilinear 0.00 dB
+            { 0.996713f, 0.999878f },  // fc/fs 0.0071: worst 0.00 dB, bilinear 0.01 dB
+            { 0.996160f, 0.999842f },  // fc/fs 0.0080: worst 0.00 dB, bilinear 0.01 dB
+            { 0.996152f, 0.999805f },  // fc/fs 0.0091: worst 0.00 dB, bilinear 0.01 dB
+            { 0.995497f, 0.999747f },  // fc/fs 0.0103: worst 0.00 dB, bilinear 0.01 dB
+            { 0.994729f, 0.999670f },  // fc/fs 0.0117: worst 0.00 dB, bilinear 0.02 dB
+            { 0.993831f, 0.999571f },  // fc/fs 0.0133: worst 0.00 dB, bilinear 0.02 dB
+            { 0.992787f, 0.999441f },  // fc/fs 0.0150: worst 0.00 dB, bilinear 0.03 dB
+            { 0.992774f, 0.999312f },  // fc/fs 0.0171: worst 0.00 dB, bilinear 0.04 dB
+            { 0.991539f, 0.999105f },  // fc/fs 0.0194: worst 0.01 dB, bilinear 0.05 dB
+            { 0.990095f, 0.998835f },  // fc/fs 0.0220: worst 0.01 dB, bilinear 0.06 dB
+            { 0.988419f, 0.998484f },  // fc/fs 0.0249: worst 0.01 dB, bilinear 0.08 dB
+            { 0.986461f, 0.998027f },  // fc/fs 0.0283: worst 0.01 dB, bilinear 0.10 dB
+            { 0.986436f, 0.997571f },  // fc/fs 0.0321: worst 0.02 dB, bilinear 0.13 dB
+            { 0.984121f, 0.996837f },  // fc/fs 0.0364: worst 0.02 dB, bilinear 0.16 dB
+            { 0.981414f, 0.995882f },  // fc/fs 0.0413: worst 0.03 dB, bilinear 0.21 dB
+            { 0.978260f, 0.994639f },  // fc/fs 0.0468: worst 0.04 dB, bilinear 0.28 dB
+            { 0.978261f, 0.993399f },  // fc/fs 0.0531: worst 0.04 dB, bilinear 0.34 dB
+            { 0.974527f, 0.991401f },  // fc/fs 0.0602: worst 0.06 dB, bilinear 0.45 dB
+            { 0.970166f, 0.988797f },  // fc/fs 0.0683: worst 0.08 dB, bilinear 0.58 dB
+            { 0.965064f, 0.985399f },  // fc/fs 0.0775: worst 0.10 dB, bilinear 0.76 dB
+            { 0.959094f, 0.980961f },  // fc/fs 0.0879: worst 0.14 dB, bilinear 0.99 dB
+            { 0.959036f, 0.976536f },  // fc/fs 0.0997: worst 0.15 dB, bilinear 1.23 dB
+            { 0.951903f, 0.969370f },  // fc/fs 0.1131: worst 0.20 dB, bilinear 1.60 dB
+            { 0.943487f, 0.959975f },  // fc/fs 0.1283: worst 0.27 dB, bilinear 2.10 dB
+            { 0.933529f, 0.947630f },  // fc/fs 0.1456: worst 0.36 dB, bilinear 2.75 dB
+            { 0.921669f, 0.931353f },  // fc/fs 0.1651: worst 0.48 dB, bilinear 3.61 dB
+            { 0.921181f, 0.915093f },  // fc/fs 0.1873: worst 0.53 dB, bilinear 4.48 dB
+            { 0.906463f, 0.888220f },  // fc/fs 0.2125: worst 0.70 dB, bilinear 5.92 dB
+            { 0.888448f, 0.852240f },  // fc/fs 0.2411: worst 0.92 dB, bilinear 7.87 dB
+            { 0.866032f, 0.803576f },  // fc/fs 0.2735: worst 1.20 dB, bilinear 10.53 dB
+            { 0.837554f, 0.736876f },  // fc/fs 0.3102: worst 1.52 dB, bilinear 14.27 dB
+            { 0.833393f, 0.669438f },  // fc/fs 0.3519: worst 1.60 dB, bilinear 18.27 dB
+            { 0.792417f, 0.549554f },  // fc/fs 0.3992: worst 1.89 dB, bilinear 25.75 dB
+            { 0.730328f, 0.383412f },  // fc/fs 0.4529: worst 2.02 dB, bilinear 38.20 dB
+            { 0.647786f, 0.219051f },  // fc/fs 0.5138: worst 1.93 dB, bilinear 64.17 dB
+            { 0.683281f, 0.129176f },  // fc/fs 0.5828: worst 1.36 dB, bilinear 96.91 dB
+            { 0.772892f, 0.061990f },  // fc/fs 0.6611: worst 0.67 dB, bilinear 97.92 dB
+            { 0.870317f, 0.019710f },  // fc/fs 0.7500: worst 0.20 dB, bilinear 97.76 dB
+        },
+    };
+}
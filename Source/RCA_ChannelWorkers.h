@@ -0,0 +1,325 @@
+/*
+  ==============================================================================
+
+    RCA_ChannelWorkers.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    A small pool of worker threads that the audio thread hands a block's
+    channels to, for ambisonic and immersive buses with more channels than
+    one core gets through in time. The threads are started up front; run()
+    never allocates, never takes a lock and never waits on a thread that
+    hasn't started its job yet.
+
+    A run is one 64-bit word: a generation, the number of jobs and the next
+    job to take. Workers and the calling thread all take jobs from it by
+    compare-and-swap, so a worker that wakes late just finds nothing left,
+    and the caller only ever waits for jobs another thread is already doing.
+
+    Between runs a worker spins (yielding) for spinTime, then sleeps on a
+    semaphore. The audio thread only posts to it when someone is asleep,
+    which on every platform here is a lock-free call into the kernel.
+
+    Once a worker has a job the audio thread waits for it, so a worker the
+    scheduler puts behind other work holds up the block: each one asks for
+    real-time priority as it starts. That's best effort (Linux without an
+    rtprio limit says no), so the caller's wait also yields now and then,
+    which on a core it shares with a worker lets the worker finish.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined (_WIN32)
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#elif defined (__APPLE__)
+ #include <dispatch/dispatch.h>
+ #include <mach/mach.h>
+ #include <mach/mach_time.h>
+ #include <mach/thread_policy.h>
+#else
+ #include <cerrno>
+ #include <pthread.h>
+ #include <sched.h>
+ #include <semaphore.h>
+#endif
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ #include <immintrin.h>
+#endif
+
+
+namespace ChannelWorkers
+{
+    /** Per-channel state aligned to this never shares a line with its neighbour's */
+    constexpr size_t cacheLineSize = 64;
+
+    /** Counting semaphore whose signal() is safe to call from the audio thread */
+    class Semaphore
+    {
+    public:
+       #if defined (_WIN32)
+        Semaphore()  : handle (CreateSemaphoreW (nullptr, 0, LONG_MAX, nullptr)) {}
+        ~Semaphore() { CloseHandle (handle); }
+
+        void signal (int count) noexcept { ReleaseSemaphore (handle, count, nullptr); }
+        void wait() noexcept             { WaitForSingleObject (handle, INFINITE); }
+       #elif defined (__APPLE__)
+        Semaphore()  : semaphore (dispatch_semaphore_create (0)) {}
+        ~Semaphore() { dispatch_release (semaphore); }
+
+        void signal (int count) noexcept
+        {
+            for (int i = 0; i < count; ++i)
+                dispatch_semaphore_signal (semaphore);
+        }
+
+        void wait() noexcept { dispatch_semaphore_wait (semaphore, DISPATCH_TIME_FOREVER); }
+       #else
+        Semaphore()  { sem_init (&semaphore, 0, 0); }
+        ~Semaphore() { sem_destroy (&semaphore); }
+
+        void signal (int count) noexcept
+        {
+            for (int i = 0; i < count; ++i)
+                sem_post (&semaphore);
+        }
+
+        void wait() noexcept
+        {
+            while (sem_wait (&semaphore) != 0 && errno == EINTR) {}
+        }
+       #endif
+
+        Semaphore (const Semaphore&) = delete;
+        Semaphore& operator= (const Semaphore&) = delete;
+
+    private:
+       #if defined (_WIN32)
+        HANDLE handle;
+       #elif defined (__APPLE__)
+        dispatch_semaphore_t semaphore;
+       #else
+        sem_t semaphore;
+       #endif
+    };
+
+    /**
+     * Asks for real-time scheduling for the calling thread, and says whether it got it.
+     * Called by each worker on itself as it starts, never on the audio thread.
+     */
+    inline bool setCurrentThreadRealtime() noexcept
+    {
+       #if defined (_WIN32)
+        return SetThreadPriority (GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+       #elif defined (__APPLE__)
+        // the policy Core Audio's own threads use: up to 1 ms of every 2 ms, non-periodic
+        mach_timebase_info_data_t timebase;
+        mach_timebase_info (&timebase);
+        const auto toAbsolute = [&timebase] (double ns) { return (uint32_t) (ns * timebase.denom / timebase.numer); };
+
+        thread_time_constraint_policy_data_t policy;
+        policy.period      = 0;
+        policy.computation = toAbsolute (1.0e6);
+        policy.constraint  = toAbsolute (2.0e6);
+        policy.preemptible = 1;
+
+        return thread_policy_set (mach_thread_self(), THREAD_TIME_CONSTRAINT_POLICY,
+                                  (thread_policy_t) &policy, THREAD_TIME_CONSTRAINT_POLICY_COUNT) == KERN_SUCCESS;
+       #else
+        // the lowest real-time priority: ahead of every ordinary thread, but never ahead of
+        // the audio thread, which a worker spinning between runs would otherwise starve
+        sched_param param {};
+        param.sched_priority = sched_get_priority_min (SCHED_FIFO);
+
+        return pthread_setschedparam (pthread_self(), SCHED_FIFO, &param) == 0;
+       #endif
+    }
+
+    //==============================================================================
+    class Pool
+    {
+    public:
+        /** Most jobs in one run */
+        static constexpr int maxJobs = 0xffff;
+
+        /** How long an idle worker keeps looking for the next run before it sleeps */
+        static constexpr std::chrono::microseconds spinTime { 200 };
+
+        /** Pauses the caller spins between yields while it waits for the workers' last jobs */
+        static constexpr int pausesPerYield = 64;
+
+        using JobFunction = void (*) (void* context, int index);
+
+        /** The only place threads are started */
+        explicit Pool (int numWorkers)
+        {
+            for (int i = 0; i < numWorkers; ++i)
+                threads.emplace_back ([this] { runWorker(); });
+        }
+
+        ~Pool()
+        {
+            quit.store (true);
+            wake.signal ((int) threads.size());
+
+            for (auto& thread : threads)
+                thread.join();
+        }
+
+        int getNumWorkers() const noexcept { return (int) threads.size(); }
+
+        /**
+         * Calls job (index) for every index in [0, numJobs), spread over the workers
+         * and the calling thread, and returns once they've all finished. One caller at a time.
+         */
+        template <typename Job>
+        void run (int numJobs, Job& job) noexcept
+        {
+            run (numJobs, [] (void* context, int index) { (*static_cast<Job*> (context)) (index); }, &job);
+        }
+
+        void run (int numJobs, JobFunction function, void* context) noexcept
+        {
+            assert (numJobs <= maxJobs);
+
+            if (numJobs <= 0)
+                return;
+
+            // nobody's holding a job from the last run, so these are the caller's to change
+            jobFunction = function;
+            jobContext = context;
+            numDone.store (0, std::memory_order_relaxed);
+
+            const auto generation = getGeneration (work.load (std::memory_order_relaxed)) + 1;
+            const auto word = ((uint64_t) generation << 32) | ((uint64_t) numJobs << 16);
+
+            work.store (word, std::memory_order_seq_cst);
+
+            if (numSleeping.load (std::memory_order_seq_cst) > 0)
+                if (const int numToWake = numSleeping.exchange (0); numToWake > 0)
+                    wake.signal (numToWake);
+
+            takeJobs (word);
+
+            // only jobs a worker has already started are left, so this is short, unless that
+            // worker was preempted: then yielding is what gives it the core back
+            for (int spins = 1; numDone.load (std::memory_order_acquire) < numJobs; ++spins)
+            {
+                if (spins % pausesPerYield == 0)
+                    std::this_thread::yield();
+                else
+                    pause();
+            }
+        }
+
+        /** How many workers got real-time priority; the rest run at normal priority */
+        int getNumRealtimeWorkers() const noexcept { return numRealtime.load(); }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static uint32_t getGeneration (uint64_t word) noexcept { return (uint32_t) (word >> 32); }
+        static int getNumJobs (uint64_t word) noexcept         { return (int) ((word >> 16) & 0xffff); }
+        static int getIndex (uint64_t word) noexcept           { return (int) (word & 0xffff); }
+
+        static void pause() noexcept
+        {
+           #if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+            _mm_pause();
+           #elif defined (__aarch64__) && ! defined (_MSC_VER)
+            asm volatile ("yield");
+           #endif
+        }
+
+        /** Takes jobs from the run in word until there are none left, or another run has started */
+        void takeJobs (uint64_t word) noexcept
+        {
+            const auto generation = getGeneration (word);
+
+            while (getGeneration (word) == generation && getIndex (word) < getNumJobs (word))
+            {
+                if (work.compare_exchange_weak (word, word + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    // the run can't finish, and jobFunction can't change, until this one's counted
+                    jobFunction (jobContext, getIndex (word));
+                    numDone.fetch_add (1, std::memory_order_release);
+                    ++word;
+                }
+            }
+        }
+
+        void runWorker() noexcept
+        {
+            if (setCurrentThreadRealtime())
+                numRealtime.fetch_add (1);
+
+            auto seen = getGeneration (work.load (std::memory_order_acquire));
+
+            for (;;)
+            {
+                const auto word = waitForRun (seen);
+
+                if (quit.load())
+                    return;
+
+                seen = getGeneration (word);
+                takeJobs (word);
+            }
+        }
+
+        uint64_t waitForRun (uint32_t seen) noexcept
+        {
+            auto idleSince = Clock::now();
+
+            for (;;)
+            {
+                const auto word = work.load (std::memory_order_acquire);
+
+                if (getGeneration (word) != seen || quit.load (std::memory_order_relaxed))
+                    return word;
+
+                if (Clock::now() - idleSince < spinTime)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                // counted before looking once more, so run() either sees this one asleep or
+                // this one sees the run; if both happen, the spare post only wakes it early
+                numSleeping.fetch_add (1, std::memory_order_seq_cst);
+
+                if (getGeneration (work.load (std::memory_order_seq_cst)) == seen && ! quit.load())
+                    wake.wait();
+
+                idleSince = Clock::now();
+            }
+        }
+
+        // the run, and what it calls, on the line every worker reads
+        alignas (cacheLineSize) std::atomic<uint64_t> work { 0 };
+        JobFunction jobFunction = nullptr;
+        void* jobContext = nullptr;
+
+        // the caller spins on this one while the workers finish
+        alignas (cacheLineSize) std::atomic<int> numDone { 0 };
+
+        alignas (cacheLineSize) std::atomic<int> numSleeping { 0 };
+        std::atomic<bool> quit { false };
+        std::atomic<int> numRealtime { 0 };
+        Semaphore wake;
+
+        std::vector<std::thread> threads;
+    };
+}
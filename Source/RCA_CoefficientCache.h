@@ -0,0 +1,329 @@
+/*
+  ==============================================================================
+
+    RCA_CoefficientCache.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    One table shared by every filter instance, from the settings a user can dial
+    in to the component values and flat-engine coefficients they resolve to. Ten
+    instances sitting on the same knob positions work the ladder out once between
+    them. The processors hold it through a juce::SharedResourcePointer, so it and
+    its fill thread go with the last instance rather than at static destruction.
+
+    The audio thread only ever reads. A lookup is a hash and a few atomic loads;
+    a miss is worked out on the spot (there is nothing to wait for) and queued
+    for the fill thread, which builds the entry and publishes it with a CAS.
+    The fill thread sleeps on a semaphore the miss posts to, so an idle cache
+    costs nothing.
+    Entries are immutable once published and live as long as the cache, so a
+    reader can never see one half-built or freed.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RCA_MKII_SEF.h"
+#include "RCA_ChannelWorkers.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+
+class CoefficientCache
+{
+public:
+    /**
+     * Everything that decides a coefficient set. Continuous cutoffs are quantised to
+     * whole cents, and a miss resolves the quantised cutoff too, so a hit and a miss
+     * for the same key always give the same filter.
+     */
+    struct Key
+    {
+        float sampleRate = 48000;
+
+        int32_t highPassKnobPos = 0;    // 1..11, or 0 for the continuous cutoff
+        int32_t lowPassKnobPos = 0;
+        int32_t highPassCents = 0;      // continuous cutoffs, in cents above 1 Hz
+        int32_t lowPassCents = 0;
+        int32_t knobTable = 0;          // RCA_MK2_SEF::getKnobTable() id the knob positions read
+
+        int32_t highPassMod = 1;
+        int32_t lowPassMod = 1;
+
+        float inputImpedance = 560;
+        float outputImpedance = 560;
+        float k = 560;
+
+        /** Compared bit for bit, the same way it's hashed */
+        bool operator== (const Key& other) const noexcept { return std::memcmp (this, &other, sizeof (Key)) == 0; }
+        bool operator!= (const Key& other) const noexcept { return ! (*this == other); }
+
+        void setHighPassCutoff (float cutoff) noexcept  { highPassKnobPos = 0; highPassCents = toCents (cutoff); }
+        void setLowPassCutoff (float cutoff) noexcept   { lowPassKnobPos = 0; lowPassCents = toCents (cutoff); }
+        void setHighPassKnobPos (int pos) noexcept      { highPassKnobPos = pos; highPassCents = 0; }
+        void setLowPassKnobPos (int pos) noexcept       { lowPassKnobPos = pos; lowPassCents = 0; }
+
+        static int32_t toCents (float hz) noexcept      { return (int32_t) std::lround (1200.0 * std::log2 ((double) hz)); }
+        static float fromCents (int32_t cents) noexcept { return (float) std::exp2 ((double) cents / 1200.0); }
+
+        /** The same values RCA_MK2_SEF's own setters arrive at for these settings */
+        LadderComponents getComponents() const noexcept
+        {
+            LadderComponents c;
+            c.Rin = inputImpedance;
+            c.Rt = outputImpedance;
+
+            if (highPassKnobPos > 0)
+            {
+                const auto& values = RCA_MK2_SEF::getKnobTable (knobTable).highPass[(size_t) highPassKnobPos - 1];
+                c.setHighPass (values.C, values.L, highPassMod, k);
+            }
+            else
+            {
+                c.setHighPassCutoff (fromCents (highPassCents), highPassMod, k);
+            }
+
+            if (lowPassKnobPos > 0)
+            {
+                const auto& values = RCA_MK2_SEF::getKnobTable (knobTable).lowPass[(size_t) lowPassKnobPos - 1];
+                c.setLowPass (values.C, values.L, lowPassMod, k);
+            }
+            else
+            {
+                c.setLowPassCutoff (fromCents (lowPassCents), lowPassMod, k);
+            }
+
+            return c;
+        }
+
+        /** FNV-1a over the key's words */
+        uint64_t hash() const noexcept
+        {
+            uint32_t words[sizeof (Key) / sizeof (uint32_t)];
+            std::memcpy (words, this, sizeof (Key));
+
+            uint64_t h = 14695981039346656037ull;
+
+            for (auto word : words)
+            {
+                h ^= word;
+                h *= 1099511628211ull;
+            }
+
+            return h ^ (h >> 32);
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        LadderComponents components;
+        LadderCoefficients coefficients;
+    };
+
+    static constexpr int numSlots = 4096;
+    static constexpr int maxProbes = 16;
+    static constexpr int queueSize = 256;
+
+    /** Starts the fill thread, so build it on the message thread (e.g. in a processor's constructor) */
+    CoefficientCache()
+    {
+        for (auto& slot : slots)
+            slot.store (nullptr, std::memory_order_relaxed);
+
+        fillThread = std::thread ([this] { run(); });
+    }
+
+    ~CoefficientCache()
+    {
+        shouldExit.store (true, std::memory_order_release);
+        requestPosted.signal (1);
+        fillThread.join();
+
+        for (auto& slot : slots)
+            delete slot.load (std::memory_order_acquire);
+    }
+
+    CoefficientCache (const CoefficientCache&) = delete;
+    CoefficientCache& operator= (const CoefficientCache&) = delete;
+
+    //==============================================================================
+    /**
+     * Realtime safe: no locks, no allocation. Fills in the components and coefficients
+     * for key, from the table if it's there, otherwise by working them out here and
+     * asking the fill thread to add them. Returns true on a hit.
+     */
+    bool resolve (const Key& key, LadderComponents& components, LadderCoefficients& coefficients) noexcept
+    {
+        if (const auto* entry = find (key))
+        {
+            components = entry->components;
+            coefficients = entry->coefficients;
+            return true;
+        }
+
+        components = key.getComponents();
+        coefficients = LadderCoefficients::fromComponents (components, key.sampleRate);
+
+        // if the queue is full this request is dropped, and the next miss asks again
+        if (requests.push (key))
+            requestPosted.signal (1);
+
+        return false;
+    }
+
+    /** Realtime safe. nullptr if the key hasn't been filled yet */
+    const Entry* find (const Key& key) const noexcept
+    {
+        const auto h = key.hash();
+
+        for (int i = 0; i < maxProbes; ++i)
+        {
+            const auto* entry = slots[(size_t) ((h + (uint64_t) i) & (numSlots - 1))].load (std::memory_order_acquire);
+
+            if (entry == nullptr)
+                return nullptr;
+
+            if (entry->key == key)
+                return entry;
+        }
+
+        return nullptr;
+    }
+
+    /** Fills key straight away. Allocates, so not from the audio thread */
+    void add (const Key& key)
+    {
+        if (find (key) != nullptr)
+            return;
+
+        auto entry = std::make_unique<Entry>();
+        entry->key = key;
+        entry->components = key.getComponents();
+        entry->coefficients = LadderCoefficients::fromComponents (entry->components, key.sampleRate);
+
+        const auto h = key.hash();
+
+        for (int i = 0; i < maxProbes; ++i)
+        {
+            auto& slot = slots[(size_t) ((h + (uint64_t) i) & (numSlots - 1))];
+            const Entry* expected = nullptr;
+
+            if (slot.compare_exchange_strong (expected, entry.get(), std::memory_order_release, std::memory_order_acquire))
+            {
+                entry.release();
+                numEntries.fetch_add (1, std::memory_order_relaxed);
+                return;
+            }
+
+            // someone else filled the same key first
+            if (expected->key == key)
+                return;
+        }
+
+        // this neighbourhood of the table is full; the key stays a miss and is worked out each time
+    }
+
+    int getNumEntries() const noexcept { return numEntries.load (std::memory_order_relaxed); }
+
+private:
+    void run()
+    {
+        while (! shouldExit.load (std::memory_order_acquire))
+        {
+            Key key;
+
+            // one post per request pushed, so a wait only blocks once the queue's been drained
+            if (requests.pop (key))
+                add (key);
+            else
+                requestPosted.wait();
+        }
+    }
+
+    /**
+     * Bounded multi-producer, single-consumer queue (Vyukov's), so any number of audio
+     * threads can ask for fills at once without a lock. Each cell's sequence number says
+     * whose turn it is: pos when free for the producer at pos, pos + 1 once written.
+     */
+    class RequestQueue
+    {
+    public:
+        RequestQueue()
+        {
+            for (size_t i = 0; i < (size_t) queueSize; ++i)
+                cells[i].sequence.store (i, std::memory_order_relaxed);
+        }
+
+        bool push (const Key& key) noexcept
+        {
+            auto pos = tail.load (std::memory_order_relaxed);
+
+            for (;;)
+            {
+                auto& cell = cells[pos & (queueSize - 1)];
+                const auto sequence = cell.sequence.load (std::memory_order_acquire);
+                const auto diff = (intptr_t) sequence - (intptr_t) pos;
+
+                if (diff == 0)
+                {
+                    if (tail.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.key = key;
+                        cell.sequence.store (pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = tail.load (std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /** Only ever called from the fill thread */
+        bool pop (Key& key) noexcept
+        {
+            auto& cell = cells[head & (queueSize - 1)];
+
+            if (cell.sequence.load (std::memory_order_acquire) != head + 1)
+                return false;
+
+            key = cell.key;
+            cell.sequence.store (head + queueSize, std::memory_order_release);
+            ++head;
+            return true;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            Key key;
+        };
+
+        std::array<Cell, queueSize> cells;
+        std::atomic<size_t> tail { 0 };
+        size_t head = 0;
+    };
+
+    std::array<std::atomic<const Entry*>, numSlots> slots;
+    std::atomic<int> numEntries { 0 };
+
+    RequestQueue requests;
+
+    ChannelWorkers::Semaphore requestPosted;
+    std::atomic<bool> shouldExit { false };
+    std::thread fillThread;
+};
+
+static_assert (sizeof (CoefficientCache::Key) % sizeof (uint32_t) == 0 && std::is_trivially_copyable<CoefficientCache::Key>::value,
+               "keys are hashed and compared as raw words");
@@ -0,0 +1,503 @@
+/*
+  ==============================================================================
+
+    RCA_ComponentFit.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Fits a knob position's C and L, along with the Rin and Rt the unit was
+    measured between, to a measured magnitude response. Tools/ComponentFit
+    runs it over all 22 positions and writes out a table the plugin loads
+    (see RCA_MK2_SEF::KnobTable).
+
+    Scaling every impedance in the ladder by the same factor (Rin, Rt, L and
+    1 / C) leaves the response exactly as it was, so a magnitude response
+    can't tell the impedance level. That's pinned at the geometric mean of Rin
+    and Rt, which is the measurement rig's; the fit finds C, L and how Rin
+    and Rt split around it, which sets the passband level and the damping.
+
+    The model is ladderTransferFunction() on dual numbers, so every point of
+    the response comes with its exact derivatives in the parameters, and
+    Levenberg-Marquardt works on the dB error from there. The parameters are
+    logs, which keeps the values positive and evenly scaled. A coarse search
+    over the cutoff first keeps it away from the wrong minimum when a unit is
+    far off its nominal values.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RCA_MKII_SEF.h"
+#include "RCA_OfflineRender.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <type_traits>
+#include <vector>
+
+
+namespace ComponentFit
+{
+    /** ln C, ln L, and ln (Rin / Rt) / 2 */
+    constexpr int numParameters = 3;
+
+    /** A value and its derivatives with respect to the parameters */
+    struct Dual
+    {
+        double v = 0.0;
+        std::array<double, numParameters> d {};
+
+        constexpr Dual (double value = 0.0) noexcept : v (value) {}
+
+        static Dual parameter (double value, int index) noexcept
+        {
+            Dual x (value);
+            x.d[(size_t) index] = 1.0;
+            return x;
+        }
+
+        friend Dual operator+ (const Dual& a, const Dual& b) noexcept { return combine (a, b, a.v + b.v, 1.0, 1.0); }
+        friend Dual operator- (const Dual& a, const Dual& b) noexcept { return combine (a, b, a.v - b.v, 1.0, -1.0); }
+        friend Dual operator* (const Dual& a, const Dual& b) noexcept { return combine (a, b, a.v * b.v, b.v, a.v); }
+
+        friend Dual operator/ (const Dual& a, const Dual& b) noexcept
+        {
+            const double q = a.v / b.v;
+            return combine (a, b, q, 1.0 / b.v, -q / b.v);
+        }
+
+        friend Dual exp (const Dual& x) noexcept { return chain (x, std::exp (x.v), std::exp (x.v)); }
+        friend Dual log (const Dual& x) noexcept { return chain (x, std::log (x.v), 1.0 / x.v); }
+
+    private:
+        /** value, with derivative da * a' + db * b' */
+        static Dual combine (const Dual& a, const Dual& b, double value, double da, double db) noexcept
+        {
+            Dual result (value);
+
+            for (size_t i = 0; i < numParameters; ++i)
+                result.d[i] = da * a.d[i] + db * b.d[i];
+
+            return result;
+        }
+
+        static Dual chain (const Dual& x, double value, double derivative) noexcept
+        {
+            Dual result (value);
+
+            for (size_t i = 0; i < numParameters; ++i)
+                result.d[i] = derivative * x.d[i];
+
+            return result;
+        }
+    };
+
+    /** Just enough of std::complex for ladderTransferFunction() */
+    struct ComplexDual
+    {
+        Dual re, im;
+
+        ComplexDual (const Dual& real = {}, const Dual& imag = {}) noexcept : re (real), im (imag) {}
+        ComplexDual (int real) noexcept : re ((double) real) {}
+
+        friend ComplexDual operator+ (const ComplexDual& a, const ComplexDual& b) noexcept
+        {
+            return { a.re + b.re, a.im + b.im };
+        }
+
+        friend ComplexDual operator* (const ComplexDual& a, const ComplexDual& b) noexcept
+        {
+            return { a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+        }
+
+        friend ComplexDual operator/ (const ComplexDual& a, const ComplexDual& b) noexcept
+        {
+            const Dual scale = Dual (1.0) / (b.re * b.re + b.im * b.im);
+            return { (a.re * b.re + a.im * b.im) * scale, (a.im * b.re - a.re * b.im) * scale };
+        }
+
+        /** 20 log10 |z| */
+        Dual decibels() const noexcept
+        {
+            return Dual (10.0 / std::log (10.0)) * log (re * re + im * im);
+        }
+    };
+
+    enum class Section
+    {
+        highPass,
+        lowPass
+    };
+
+    /** A knob position's response, measured with the other section switched out (HP 1 or LP 11) */
+    struct Measurement
+    {
+        std::vector<double> frequencies;    // Hz
+        std::vector<double> magnitudesDb;
+    };
+
+    struct Problem
+    {
+        Section section = Section::highPass;
+        int position = 1;
+
+        /** Where the fit starts: usually the built-in table's C and L */
+        double C = 1.0e-6, L = 0.1;
+
+        /** sqrt (Rin * Rt), which stays put */
+        double impedance = 560.0;
+
+        /** The MOD switches, both set the same for the measurement, and the k setHighPass()/setLowPass() park with */
+        bool mod = false;
+        double k = 560.0;
+
+        /**
+         * Bypass positions (HP 1, LP 11) leave nothing of C and L in the response;
+         * they only get the split between Rin and Rt.
+         */
+        bool fitValues = true;
+
+        /** Points more than this far below the loudest are left out, as measurement noise */
+        double rangeDb = 60.0;
+
+        Measurement measurement;
+    };
+
+    struct Result
+    {
+        double C = 0.0, L = 0.0, Rin = 0.0, Rt = 0.0;
+
+        double rmsErrorDb = 0.0;
+        double maxErrorDb = 0.0;
+
+        int numPoints = 0;
+        int iterations = 0;
+        bool converged = false;
+
+        /** The cutoff these C and L give, the way the built-in table's cutoffs are worked out */
+        int getCutoff (Section section) const
+        {
+            LadderComponentsT<double> c;
+            c.C_HP1 = c.C_LP1 = C;
+            c.L_HP1 = c.L_LP1 = L;
+
+            return (int) std::lround (section == Section::highPass ? c.getHighPassCutoff() : c.getLowPassCutoff());
+        }
+    };
+
+    //==============================================================================
+    class Fitter
+    {
+    public:
+        static constexpr int maxIterations = 200;
+        static constexpr int numSearchSteps = 25;       // the coarse cutoff search, over +-1 octave
+
+        explicit Fitter (const Problem& problemToUse) : problem (problemToUse)
+        {
+            const auto& m = problem.measurement;
+            const double loudest = m.magnitudesDb.empty() ? 0.0 : *std::max_element (m.magnitudesDb.begin(), m.magnitudesDb.end());
+
+            for (size_t i = 0; i < m.frequencies.size(); ++i)
+            {
+                if (m.frequencies[i] > 0.0 && m.magnitudesDb[i] > loudest - problem.rangeDb)
+                {
+                    omegas.push_back (LadderComponentsT<double>::twoPi * m.frequencies[i]);
+                    targets.push_back (m.magnitudesDb[i]);
+                }
+            }
+
+            residuals.resize (omegas.size());
+            jacobian.resize (omegas.size());
+        }
+
+        Result run()
+        {
+            Parameters theta { std::log (problem.C), std::log (problem.L), 0.0 };
+            Result result;
+
+            if (omegas.size() < (size_t) numParameters)
+                return finish (theta, result);
+
+            if (problem.fitValues)
+                searchCutoff (theta);
+
+            double cost = evaluate (theta, true);
+            double lambda = 1.0e-3;
+
+            for (result.iterations = 0; result.iterations < maxIterations; ++result.iterations)
+            {
+                Matrix normal {};
+                Parameters gradient {};
+
+                for (size_t i = 0; i < omegas.size(); ++i)
+                {
+                    for (size_t a = 0; a < numParameters; ++a)
+                    {
+                        gradient[a] += jacobian[i][a] * residuals[i];
+
+                        for (size_t b = 0; b < numParameters; ++b)
+                            normal[a][b] += jacobian[i][a] * jacobian[i][b];
+                    }
+                }
+
+                bool accepted = false;
+                Parameters step {};
+
+                while (! accepted && lambda < 1.0e12)
+                {
+                    if (! solve (normal, gradient, lambda, step))
+                    {
+                        lambda *= 4.0;
+                        continue;
+                    }
+
+                    Parameters next;
+                    for (size_t a = 0; a < numParameters; ++a)
+                        next[a] = theta[a] - step[a];
+
+                    const double nextCost = evaluate (next, false);
+
+                    if (nextCost < cost)
+                    {
+                        const double improvement = (cost - nextCost) / std::max (cost, 1.0e-300);
+
+                        theta = next;
+                        cost = evaluate (theta, true);
+                        lambda = std::max (lambda / 3.0, 1.0e-12);
+                        accepted = true;
+
+                        if (improvement < 1.0e-10)
+                            result.converged = true;
+                    }
+                    else
+                    {
+                        lambda *= 4.0;
+                    }
+                }
+
+                // nowhere left to go downhill is a minimum too
+                if (! accepted)
+                    result.converged = true;
+
+                if (result.converged)
+                    break;
+            }
+
+            return finish (theta, result);
+        }
+
+    private:
+        using Parameters = std::array<double, numParameters>;
+        using Matrix = std::array<Parameters, numParameters>;
+
+        /** The model's dB at every point, with its derivatives if withJacobian, and half the sum of squared errors */
+        double evaluate (const Parameters& theta, bool withJacobian)
+        {
+            double cost = 0.0;
+
+            if (withJacobian)
+            {
+                const auto c = makeComponents<Dual> (theta);
+
+                for (size_t i = 0; i < omegas.size(); ++i)
+                {
+                    const auto db = ladderTransferFunction (c, ComplexDual ({}, omegas[i])).decibels();
+
+                    residuals[i] = db.v - targets[i];
+                    jacobian[i] = db.d;
+                    cost += 0.5 * residuals[i] * residuals[i];
+                }
+            }
+            else
+            {
+                // trial steps and the cutoff search only need the cost, which plain doubles give quicker
+                const auto c = makeComponents<double> (theta);
+
+                for (size_t i = 0; i < omegas.size(); ++i)
+                {
+                    const auto h = ladderTransferFunction (c, std::complex<double> (0.0, omegas[i]));
+                    const double r = 10.0 * std::log10 (std::norm (h)) - targets[i];
+                    cost += 0.5 * r * r;
+                }
+            }
+
+            return std::isfinite (cost) ? cost : 1.0e300;
+        }
+
+        /** The ladder as it was measured, on Dual for the derivatives or double for just the values */
+        template <typename T>
+        LadderComponentsT<T> makeComponents (const Parameters& theta) const
+        {
+            using std::exp;
+
+            auto variable = [] (double value, int index)
+            {
+                if constexpr (std::is_same_v<T, Dual>)
+                    return Dual::parameter (value, index);
+                else
+                    return (void) index, value;
+            };
+
+            LadderComponentsT<T> c;
+            const T split = exp (variable (theta[2], 2));
+            c.Rin = T (problem.impedance) * split;
+            c.Rt = T (problem.impedance) / split;
+
+            // a bypass position still has to be switched in, just without derivatives for its C and L
+            const T C = exp (problem.fitValues ? variable (theta[0], 0) : T (theta[0]));
+            const T L = exp (problem.fitValues ? variable (theta[1], 1) : T (theta[1]));
+
+            const auto& highPassOff = RCA_MK2_SEF::highPassKnobPositions.front();
+            const auto& lowPassOff = RCA_MK2_SEF::lowPassKnobPositions.back();
+
+            if (problem.section == Section::highPass)
+            {
+                c.setHighPass (C, L, problem.mod, T (problem.k));
+                c.setLowPass (T (lowPassOff.C), T (lowPassOff.L), problem.mod, T (problem.k));
+            }
+            else
+            {
+                c.setHighPass (T (highPassOff.C), T (highPassOff.L), problem.mod, T (problem.k));
+                c.setLowPass (C, L, problem.mod, T (problem.k));
+            }
+
+            return c;
+        }
+
+        /** Slides C and L together, which moves the cutoff and keeps the impedance, to the best starting point */
+        void searchCutoff (Parameters& theta)
+        {
+            const Parameters start = theta;
+            double best = evaluate (theta, false);
+
+            for (int n = 0; n < numSearchSteps; ++n)
+            {
+                const double shift = std::log (2.0) * (2.0 * n / (numSearchSteps - 1) - 1.0);
+
+                Parameters candidate = start;
+                candidate[0] += shift;
+                candidate[1] += shift;
+
+                const double cost = evaluate (candidate, false);
+
+                if (cost < best)
+                {
+                    best = cost;
+                    theta = candidate;
+                }
+            }
+        }
+
+        /** (J^T J + lambda diag(J^T J)) step = J^T r, by Cholesky. Parameters with no say in the response stay put */
+        static bool solve (const Matrix& normal, const Parameters& gradient, double lambda, Parameters& step)
+        {
+            Matrix a = normal;
+
+            for (size_t i = 0; i < numParameters; ++i)
+                a[i][i] = normal[i][i] > 0.0 ? normal[i][i] * (1.0 + lambda) : 1.0;
+
+            Matrix lower {};
+
+            for (size_t i = 0; i < numParameters; ++i)
+            {
+                for (size_t j = 0; j <= i; ++j)
+                {
+                    double sum = a[i][j];
+
+                    for (size_t n = 0; n < j; ++n)
+                        sum -= lower[i][n] * lower[j][n];
+
+                    if (i == j)
+                    {
+                        if (! (sum > 0.0))
+                            return false;
+
+                        lower[i][i] = std::sqrt (sum);
+                    }
+                    else
+                    {
+                        lower[i][j] = sum / lower[j][j];
+                    }
+                }
+            }
+
+            Parameters y {};
+
+            for (size_t i = 0; i < numParameters; ++i)
+            {
+                double sum = gradient[i];
+
+                for (size_t n = 0; n < i; ++n)
+                    sum -= lower[i][n] * y[n];
+
+                y[i] = sum / lower[i][i];
+            }
+
+            for (size_t i = numParameters; i-- > 0;)
+            {
+                double sum = y[i];
+
+                for (size_t n = i + 1; n < numParameters; ++n)
+                    sum -= lower[n][i] * step[n];
+
+                step[i] = sum / lower[i][i];
+            }
+
+            return true;
+        }
+
+        Result finish (const Parameters& theta, Result& result)
+        {
+            result.C = std::exp (theta[0]);
+            result.L = std::exp (theta[1]);
+            result.Rin = problem.impedance * std::exp (theta[2]);
+            result.Rt = problem.impedance / std::exp (theta[2]);
+            result.numPoints = (int) omegas.size();
+
+            if (omegas.empty())
+                return result;
+
+            evaluate (theta, true);
+
+            double sum = 0.0;
+
+            for (auto r : residuals)
+            {
+                sum += r * r;
+                result.maxErrorDb = std::max (result.maxErrorDb, std::abs (r));
+            }
+
+            result.rmsErrorDb = std::sqrt (sum / (double) residuals.size());
+            return result;
+        }
+
+        const Problem& problem;
+
+        std::vector<double> omegas, targets;
+        std::vector<double> residuals;
+        std::vector<Parameters> jacobian;
+    };
+
+    /** Every problem on its own, shared out over numThreads (0 for one per core) */
+    inline std::vector<Result> fitAll (const std::vector<Problem>& problems, int numThreads = 0)
+    {
+        std::vector<Result> results (problems.size());
+
+        if (numThreads <= 0)
+            numThreads = (int) std::max (1u, std::thread::hardware_concurrency());
+
+        std::atomic<int> next { 0 };
+        const int numProblems = (int) problems.size();
+
+        OfflineRender::runOnThreads (std::max (1, std::min (numThreads, numProblems)), [&] (int)
+        {
+            for (int i = next++; i < numProblems; i = next++)
+                results[(size_t) i] = Fitter (problems[(size_t) i]).run();
+        });
+
+        return results;
+    }
+}
@@ -0,0 +1,419 @@
+/*
+  ==============================================================================
+
+    RCA_EnvelopeModulation.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    An envelope follower moving the HP and LP cutoffs, for auto-filter effects.
+
+    Going through setHighPassCutoff() and friends for every step would rebuild
+    the section's component values each time and, on the tree engine, push new
+    impedances through every adaptor. Here the cutoffs only ever move by a
+    ratio away from a base ladder instead. Scaling a section's cutoff by r
+    scales its capacitors' port resistances by r and its inductors' by 1 / r,
+    so an update is twelve multiplies plus the adaptor divisions
+    (LadderCoefficients::fromPortResistances). Updates land every
+    updateInterval samples, and a chunk's worth of them are worked out
+    together, Lanes::width side by side.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RCA_MKII_SEF.h"
+#include "RCA_Lanes.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace EnvelopeModulation
+{
+    //==============================================================================
+    /** Peak envelope with separate attack and release times, linked across channels */
+    class Follower
+    {
+    public:
+        void prepare (float sampleRate)
+        {
+            fs = sampleRate;
+            updateCoefficients();
+            reset();
+        }
+
+        void reset() noexcept { envelope = 0.f; }
+
+        void setAttack (float milliseconds)
+        {
+            if (attackMs != milliseconds)
+            {
+                attackMs = milliseconds;
+                updateCoefficients();
+            }
+        }
+
+        void setRelease (float milliseconds)
+        {
+            if (releaseMs != milliseconds)
+            {
+                releaseMs = milliseconds;
+                updateCoefficients();
+            }
+        }
+
+        float getEnvelope() const noexcept { return envelope; }
+
+        /** Writes the envelope of the loudest of numChannels inputs to dest, one value per sample */
+        void process (const float* const* inputs, int numChannels, int numSamples, float* dest) noexcept
+        {
+            // rectify and link; nothing here depends on the sample before, so it vectorises
+            std::fill (dest, dest + numSamples, 0.f);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const float* in = inputs[channel];
+
+                for (int n = 0; n < numSamples; ++n)
+                    dest[n] = std::max (dest[n], std::abs (in[n]));
+            }
+
+            // the ballistics are a recursion, but a branch-free one
+            float env = envelope;
+
+            for (int n = 0; n < numSamples; ++n)
+            {
+                const float x = dest[n];
+                env = x + (x > env ? attack : release) * (env - x);
+                dest[n] = env;
+            }
+
+            envelope = env;
+        }
+
+    private:
+        void updateCoefficients()
+        {
+            attack = std::exp (-1.f / (0.001f * attackMs * fs));
+            release = std::exp (-1.f / (0.001f * releaseMs * fs));
+        }
+
+        float fs = 48000.f;
+        float attackMs = 5.f, releaseMs = 200.f;
+        float attack = 0.f, release = 0.f;
+        float envelope = 0.f;
+    };
+
+    //==============================================================================
+    /**
+     * Flat-engine coefficients for a base ladder with its section cutoffs scaled, without
+     * going through the component values. At ratio 1 they're bit-exact with
+     * LadderCoefficients::fromComponents() for the base.
+     */
+    class CoefficientPath
+    {
+    public:
+        void setBase (const LadderComponents& components, float sampleRate)
+        {
+            base = components;
+            basePorts = LadderCoefficients::getPortResistances (components, sampleRate);
+
+            // with mod off the m-derived elements are parked out of the way, and stay there
+            const auto hpMod = components.isHighPassModOn();
+            const auto lpMod = components.isLowPassModOn();
+
+            scaling = { hpMod ? highPassUp : fixed, hpMod ? highPassDown : fixed, hpMod ? highPassUp : fixed,
+                        highPassUp, highPassDown, highPassUp,
+                        lowPassDown, lowPassUp, lowPassDown,
+                        lpMod ? lowPassDown : fixed, lpMod ? lowPassUp : fixed, lpMod ? lowPassDown : fixed };
+        }
+
+        const LadderComponents& getBase() const noexcept { return base; }
+
+        /** Fills dest[i] for the i-th pair of ratios, Lanes::width pairs at a time */
+        void compute (const float* highPassRatios, const float* lowPassRatios, int num, LadderCoefficients* dest) const noexcept
+        {
+            for (int start = 0; start < num; start += Lanes::width)
+            {
+                const int count = std::min (Lanes::width, num - start);
+
+                // with fewer than half the lanes in use, one at a time is quicker
+                if (count < Lanes::width / 2)
+                {
+                    for (int j = start; j < num; ++j)
+                        dest[j] = compute (highPassRatios[j], lowPassRatios[j]);
+
+                    return;
+                }
+
+                float factors[numScalings][Lanes::width];
+
+                for (int j = 0; j < Lanes::width; ++j)
+                {
+                    const float hp = j < count ? highPassRatios[start + j] : 1.f;
+                    const float lp = j < count ? lowPassRatios[start + j] : 1.f;
+
+                    factors[fixed][j] = 1.f;
+                    factors[highPassUp][j] = hp;
+                    factors[highPassDown][j] = 1.f / hp;
+                    factors[lowPassUp][j] = lp;
+                    factors[lowPassDown][j] = 1.f / lp;
+                }
+
+                float ports[12][Lanes::width];
+
+                for (size_t e = 0; e < 12; ++e)
+                    for (int j = 0; j < Lanes::width; ++j)
+                        ports[e][j] = basePorts[e] * factors[scaling[e]][j];
+
+                float series[9][Lanes::width], parallel[4][Lanes::width];
+                fromPortResistances (ports, base.Rin, base.Rt, series, parallel);
+
+                for (int j = 0; j < count; ++j)
+                {
+                    auto& coefficients = dest[start + j];
+
+                    for (size_t k = 0; k < coefficients.series.size(); ++k)
+                        coefficients.series[k] = series[k][j];
+
+                    for (size_t k = 0; k < coefficients.parallel.size(); ++k)
+                        coefficients.parallel[k] = parallel[k][j];
+                }
+            }
+        }
+
+        LadderCoefficients compute (float highPassRatio, float lowPassRatio) const noexcept
+        {
+            const float factors[numScalings] = { 1.f, highPassRatio, 1.f / highPassRatio, lowPassRatio, 1.f / lowPassRatio };
+            std::array<float, 12> ports;
+
+            for (size_t e = 0; e < ports.size(); ++e)
+                ports[e] = basePorts[e] * factors[scaling[e]];
+
+            return LadderCoefficients::fromPortResistances (ports, base.Rin, base.Rt);
+        }
+
+        /** The same scaling on the component values, for engines that want those */
+        LadderComponents getComponents (float highPassRatio, float lowPassRatio) const noexcept
+        {
+            auto c = base;
+            float* values[] = { &c.C_HPm1, &c.L_HPm, &c.C_HPm2, &c.C_HP1, &c.L_HP1, &c.C_HP2,
+                                &c.L_LP1, &c.C_LP1, &c.L_LP2, &c.L_LPm1, &c.C_LPm1, &c.L_LPm2 };
+
+            for (size_t e = 0; e < scaling.size(); ++e)
+                if (scaling[e] != fixed)
+                    *values[e] /= scaling[e] <= highPassDown ? highPassRatio : lowPassRatio;
+
+            return c;
+        }
+
+    private:
+        /**
+         * LadderCoefficients::fromPortResistances() for Lanes::width ladders at once, the same
+         * operations in the same order, but as plain loops over the lanes so that each
+         * adaptor comes out as a handful of vector instructions. Bit-exact with the scalar
+         * version, so a chunk gives the same coefficients as one update at a time.
+         */
+        static void fromPortResistances (const float (&r)[12][Lanes::width], float Rin, float Rt,
+                                         float (&series)[9][Lanes::width], float (&parallel)[4][Lanes::width]) noexcept
+        {
+            // the resistance looking down into the tree from the adaptor reached so far
+            float R[Lanes::width];
+
+            for (int j = 0; j < Lanes::width; ++j)
+            {
+                R[j] = r[11][j] + Rt;
+                series[8][j] = r[11][j] / R[j];
+            }
+
+            auto seriesAdaptor = [&] (int index, const float* element)
+            {
+                for (int j = 0; j < Lanes::width; ++j)
+                {
+                    const float sum = element[j] + R[j];
+                    series[index][j] = element[j] / sum;
+                    R[j] = sum;
+                }
+            };
+
+            auto parallelAdaptor = [&] (int index, const float* element)
+            {
+                for (int j = 0; j < Lanes::width; ++j)
+                {
+                    const float G1 = 1.f / element[j];
+                    const float G = G1 + 1.f / R[j];
+                    parallel[index - 1][j] = G1 / G;
+                    R[j] = 1.f / G;
+                }
+            };
+
+            parallelAdaptor (4, r[10]);
+            seriesAdaptor (7, r[9]);
+            seriesAdaptor (6, r[8]);
+            parallelAdaptor (3, r[7]);
+            seriesAdaptor (5, r[6]);
+            seriesAdaptor (4, r[5]);
+            parallelAdaptor (2, r[4]);
+            seriesAdaptor (3, r[3]);
+            seriesAdaptor (2, r[2]);
+            parallelAdaptor (1, r[1]);
+            seriesAdaptor (1, r[0]);
+
+            for (int j = 0; j < Lanes::width; ++j)
+                series[0][j] = Rin / (Rin + R[j]);
+        }
+
+        /** What a port resistance gets multiplied by: the ratio, its reciprocal, or nothing */
+        enum Scaling { fixed, highPassUp, highPassDown, lowPassUp, lowPassDown, numScalings };
+
+        LadderComponents base;
+        std::array<float, 12> basePorts {};
+        std::array<Scaling, 12> scaling {};
+    };
+
+    //==============================================================================
+    /**
+     * Follows a detector signal and moves a filter's cutoffs with it. Each section's
+     * cutoff goes up by its depth in octaves at full envelope (after sensitivity, clipped
+     * to 1), and is kept between 10 Hz and 45% of the sample rate, or wherever the base
+     * already is if that's outside.
+     *
+     * Realtime safe: everything lives in fixed-size arrays, so nothing allocates.
+     */
+    class Modulator
+    {
+    public:
+        /** Most samples analyse() takes in one go */
+        static constexpr int chunkSize = 256;
+
+        void prepare (float sampleRate)
+        {
+            fs = sampleRate;
+            follower.prepare (sampleRate);
+            setBase (path.getBase());
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            follower.reset();
+            samplesUntilUpdate = 0;
+        }
+
+        /** The unmodulated ladder. The next analyse() updates straight away, at its first sample */
+        void setBase (const LadderComponents& components)
+        {
+            path.setBase (components, fs);
+
+            const auto lowest = 10.0, highest = 0.45 * fs;
+            const auto highPassCutoff = components.getHighPassCutoff();
+            const auto lowPassCutoff = components.getLowPassCutoff();
+
+            highPassRange = { float (std::min (1.0, lowest / highPassCutoff)), float (std::max (1.0, highest / highPassCutoff)) };
+            lowPassRange = { float (std::min (1.0, lowest / lowPassCutoff)), float (std::max (1.0, highest / lowPassCutoff)) };
+
+            samplesUntilUpdate = 0;
+        }
+
+        void setAttack (float milliseconds)         { follower.setAttack (milliseconds); }
+        void setRelease (float milliseconds)        { follower.setRelease (milliseconds); }
+        void setHighPassDepth (float octaves)       { highPassDepth = octaves; }
+        void setLowPassDepth (float octaves)        { lowPassDepth = octaves; }
+        void setSensitivity (float gain)            { sensitivity = gain; }
+
+        /** Samples between coefficient updates, 1 to chunkSize */
+        void setUpdateInterval (int samples)        { updateInterval = std::clamp (samples, 1, chunkSize); }
+        int getUpdateInterval() const noexcept      { return updateInterval; }
+
+        /** False while both depths are zero, when there's nothing to modulate */
+        bool isActive() const noexcept { return highPassDepth != 0.f || lowPassDepth != 0.f; }
+
+        /**
+         * Follows numChannels of detector over the next numSamples (at most chunkSize)
+         * and works out the coefficient updates that fall in them. Then run process()
+         * over the same samples of each channel.
+         */
+        void analyse (const float* const* detector, int numChannels, int numSamples) noexcept
+        {
+            assert (numSamples <= chunkSize);
+
+            follower.process (detector, numChannels, numSamples, envelope.data());
+
+            numUpdates = 0;
+            int pos = samplesUntilUpdate;
+
+            for (; pos < numSamples; pos += updateInterval)
+            {
+                const float amount = std::min (envelope[(size_t) pos] * sensitivity, 1.f);
+
+                updateOffsets[(size_t) numUpdates] = pos;
+                highPassRatios[(size_t) numUpdates] = getRatio (highPassDepth * amount, highPassRange);
+                lowPassRatios[(size_t) numUpdates] = getRatio (lowPassDepth * amount, lowPassRange);
+                ++numUpdates;
+            }
+
+            samplesUntilUpdate = pos - numSamples;
+            numSamplesAnalysed = numSamples;
+
+            path.compute (highPassRatios.data(), lowPassRatios.data(), numUpdates, coefficients.data());
+        }
+
+        /**
+         * Runs filter over the samples last analysed, in place, with the updates where they
+         * fall. The flat engine takes the fast coefficients; any other engine is given the
+         * scaled component values and works its coefficients out itself.
+         */
+        void process (RCA_MK2_SEF& filter, float* data) const noexcept
+        {
+            const bool isFlat = filter.getEngine() == RCA_MK2_SEF::Engine::flat;
+            int pos = 0;
+
+            for (int u = 0; u <= numUpdates; ++u)
+            {
+                const int end = u < numUpdates ? updateOffsets[(size_t) u] : numSamplesAnalysed;
+
+                for (; pos < end; ++pos)
+                    data[pos] = filter.processSample (data[pos]);
+
+                if (u == numUpdates)
+                    break;
+
+                if (isFlat)
+                    filter.setFlatCoefficients (coefficients[(size_t) u]);
+                else
+                    filter.setComponentValues (path.getComponents (highPassRatios[(size_t) u], lowPassRatios[(size_t) u]));
+            }
+        }
+
+        int getNumUpdates() const noexcept { return numUpdates; }
+        float getEnvelope() const noexcept { return follower.getEnvelope(); }
+
+    private:
+        struct Range { float lowest = 1.f, highest = 1.f; };
+
+        static float getRatio (float octaves, Range range) noexcept
+        {
+            return std::clamp (std::exp2 (octaves), range.lowest, range.highest);
+        }
+
+        float fs = 48000.f;
+
+        Follower follower;
+        CoefficientPath path;
+
+        float highPassDepth = 0.f, lowPassDepth = 0.f;
+        float sensitivity = 1.f;
+        int updateInterval = 16;
+
+        Range highPassRange, lowPassRange;
+
+        int samplesUntilUpdate = 0;
+        int numUpdates = 0;
+        int numSamplesAnalysed = 0;
+
+        std::array<float, chunkSize> envelope {};
+        std::array<int, chunkSize> updateOffsets {};
+        std::array<float, chunkSize> highPassRatios {}, lowPassRatios {};
+        std::array<LadderCoefficients, chunkSize> coefficients {};
+    };
+}
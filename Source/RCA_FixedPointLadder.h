@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+
+    RCA_FixedPointLadder.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    The flat engine's ladder in integer arithmetic only, for processors with
+    no FPU. It runs the same processLadderSample() equations, on fixed-point
+    types instead of float.
+
+    Audio goes in and out as Q1.31, like 32-bit PCM. Every reflection
+    coefficient lies in [0, 1), so the coefficients are Q1.31 too. They're
+    worked out in double when the components change and only then rounded.
+
+    Wave variables carry more than the signal level: a wave is v + R i, and an
+    inductor's R is 2 fs L, up to 10^5 ohms. At the knob positions, -6 dBFS
+    noise takes them to about +-50, so they're Q9.23 by default. A
+    full-scale 20 Hz square with HP and LP at 20 Hz takes them to +-2000 at
+    48 kHz and +-7600 at 192 kHz, and with Rin near 0 ohms to +-54000: no
+    one format has the range for that and the resolution for the rest.
+
+    So each ladder ranges itself. The equations are linear, so halving every
+    state and the input gives exactly half the output: when a state comes
+    within two bits of the rail, the ladder halves them all and takes the
+    input in one bit lower, and when they've stayed small for a while it
+    goes back. Only settings that need the range pay for it in resolution.
+
+    Within a sample, states and the multiplies' operands saturate, so a
+    jump faster than the ranging clips rather than wrapping to the other
+    rail. Sums between them are 64-bit (two instructions on a 32-bit core),
+    so they never clip anything that would have come back in range.
+
+    With a section's MOD off, or at the bypass knob positions, its parked
+    elements' coefficients round to exactly 0. The ladder then keeps those
+    elements' states out of the signal path, just as the analog circuit does.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RCA_MKII_SEF.h"
+#include <array>
+#include <cstdint>
+
+
+namespace FixedPoint
+{
+    /** A reflection coefficient in [0, 1), Q1.31 */
+    struct Coefficient
+    {
+        int32_t raw = 0;
+
+        static Coefficient fromDouble (double value) noexcept
+        {
+            const double scaled = value * 2147483648.0 + 0.5;
+
+            if (! (scaled > 0.0))
+                return { 0 };
+
+            return { scaled >= 2147483647.0 ? INT32_MAX : (int32_t) scaled };
+        }
+    };
+
+    /** Clamps a 64-bit sum into the 32 bits a state or a multiply's operand is kept in */
+    constexpr int32_t saturate (int64_t value) noexcept
+    {
+        return value > INT32_MAX ? INT32_MAX : value < INT32_MIN ? INT32_MIN : (int32_t) value;
+    }
+
+    /**
+     * A wave variable in Q(32 - fractionBits).fractionBits. It's held in 64 bits while
+     * the equations add it up, and saturated to 32 wherever it's stored or multiplied.
+     */
+    template <int fractionBits>
+    struct Wave
+    {
+        static_assert (fractionBits > 0 && fractionBits < 30, "leave integer bits, and room for the constants' products");
+
+        static constexpr int numFractionBits = fractionBits;
+
+        int64_t raw = 0;
+
+        constexpr Wave() noexcept = default;
+
+        /** For processLadderSample()'s constants; folded at compile time */
+        constexpr explicit Wave (int value) noexcept : raw (value * (int64_t (1) << fractionBits)) {}
+        constexpr explicit Wave (double value) noexcept : raw ((int64_t) (value * double (int64_t (1) << fractionBits))) {}
+
+        static constexpr Wave fromRaw (int64_t value) noexcept
+        {
+            Wave w;
+            w.raw = value;
+            return w;
+        }
+
+        friend constexpr Wave operator+ (Wave a, Wave b) noexcept { return fromRaw (a.raw + b.raw); }
+        friend constexpr Wave operator- (Wave a, Wave b) noexcept { return fromRaw (a.raw - b.raw); }
+        friend constexpr Wave operator- (Wave a) noexcept          { return fromRaw (-a.raw); }
+
+        /** Only ever by the constants 2 and 0.5, which are exact and fit in 31 bits */
+        friend constexpr Wave operator* (Wave a, Wave b) noexcept
+        {
+            return fromRaw (((int64_t) saturate (a.raw) * b.raw) >> fractionBits);
+        }
+
+        /** One 32 x 32 -> 64 multiply, rounded to nearest */
+        friend constexpr Wave operator* (Coefficient c, Wave w) noexcept
+        {
+            return fromRaw (((int64_t) c.raw * saturate (w.raw) + (int64_t (1) << 30)) >> 31);
+        }
+    };
+
+    /** Q1.31 <-> float, for feeding and checking the ladder where there is an FPU */
+    inline int32_t toQ31 (float x) noexcept
+    {
+        const float scaled = x * 2147483648.f;
+
+        if (scaled >= 2147483647.f)
+            return INT32_MAX;
+
+        if (scaled <= -2147483648.f)
+            return INT32_MIN;
+
+        return (int32_t) scaled;
+    }
+
+    inline float fromQ31 (int32_t x) noexcept
+    {
+        return (float) x * (1.f / 2147483648.f);
+    }
+
+    //==============================================================================
+    /** waveFractionBits is the wave format with no headroom taken, for the quietest settings */
+    template <int waveFractionBits = 23>
+    class Ladder
+    {
+    public:
+        using WaveType = Wave<waveFractionBits>;
+
+        /** Most the ladder takes the input down by, on top of the Q1.31 to wave format shift */
+        static constexpr int maxHeadroomBits = 16;
+
+        /** Works the coefficients out in double and rounds them; no state is touched */
+        void setComponentValues (const LadderComponentsT<double>& components, double sampleRate) noexcept
+        {
+            setCoefficients (LadderCoefficientsT<double>::fromComponents (components, sampleRate));
+        }
+
+        /** Takes a float filter's component values and sample rate */
+        void copySettingsFrom (const RCA_MK2_SEF& filter) noexcept
+        {
+            setComponentValues (filter.getComponentValues().convertTo<double>(), (double) filter.getSampleRate());
+        }
+
+        void setCoefficients (const LadderCoefficientsT<double>& coefficients) noexcept
+        {
+            for (size_t i = 0; i < series.size(); ++i)
+                series[i] = Coefficient::fromDouble (coefficients.series[i]);
+
+            for (size_t i = 0; i < parallel.size(); ++i)
+                parallel[i] = Coefficient::fromDouble (coefficients.parallel[i]);
+        }
+
+        void reset() noexcept
+        {
+            state = {};
+            headroomBits = 0;
+            quietSamples = 0;
+        }
+
+        /** Bits the input is currently taken down by, to make room in the waves */
+        int getHeadroomBits() const noexcept { return headroomBits; }
+
+        /** Q1.31 in and out; the output saturates rather than wrapping */
+        int32_t processSample (int32_t x) noexcept
+        {
+            const int shift = 31 - waveFractionBits + headroomBits;
+
+            // rounded to the nearest wave LSB
+            const auto input = WaveType::fromRaw (((int64_t) x + (int64_t (1) << (shift - 1))) >> shift);
+
+            const auto y = processLadderSample<WaveType> ([this] (int i) { return WaveType::fromRaw (state[(size_t) i]); },
+                                                          [this] (int i) { return series[(size_t) i]; },
+                                                          [this] (int i) { return parallel[(size_t) i - 1]; },
+                                                          input,
+                                                          [this] (int i, WaveType a) { state[(size_t) i] = saturate (a.raw); });
+
+            const int32_t output = saturate (saturate (y.raw) * (int64_t (1) << shift));
+
+            updateHeadroom();
+            return output;
+        }
+
+        void process (int32_t* data, int numSamples) noexcept
+        {
+            for (int n = 0; n < numSamples; ++n)
+                data[n] = processSample (data[n]);
+        }
+
+    private:
+        /** A state past this takes a bit more headroom: two bits under the rail */
+        static constexpr uint32_t growLevel = 1u << 29;
+
+        /** Below this for quietTime samples, every state still would be after doubling */
+        static constexpr uint32_t shrinkLevel = 1u << 27;
+        static constexpr int quietTime = 1 << 12;
+
+        /**
+         * Halving the states along with the input carries on the same response at half the
+         * scale, give or take the state's last bit, so the output doesn't step.
+         */
+        void updateHeadroom() noexcept
+        {
+            uint32_t level = 0;
+
+            // |s| to within one, which is all the top bit needs
+            for (auto s : state)
+                level |= (uint32_t) (s ^ (s >> 31));
+
+            if (level >= growLevel)
+            {
+                quietSamples = 0;
+
+                if (headroomBits < maxHeadroomBits)
+                {
+                    for (auto& s : state)
+                        s >>= 1;
+
+                    ++headroomBits;
+                }
+            }
+            else if (level >= shrinkLevel || headroomBits == 0)
+            {
+                quietSamples = 0;
+            }
+            else if (++quietSamples >= quietTime)
+            {
+                for (auto& s : state)
+                    s *= 2;
+
+                --headroomBits;
+                quietSamples = 0;
+            }
+        }
+
+        std::array<int32_t, RCA_MK2_SEF::numStates> state {};
+        std::array<Coefficient, 9> series {};
+        std::array<Coefficient, 4> parallel {};
+
+        int headroomBits = 0;
+        int quietSamples = 0;
+    };
+}
@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    RCA_GeneratedLadder.h
+
+    Generated by Tools/WdfCodegen from WdfNetlist::rcaLadder.
+    Don't edit by hand, run it again.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+namespace GeneratedLadder
+{
+    /** Resistances, capacitances and inductances, starting at the netlist's */
+    struct Values
+    {
+        float C_LPm1 = 1e-08f;
+        float C_LP1 = 1e-08f;
+        float C_HP2 = 1e-08f;
+        float C_HP1 = 5e-08f;
+        float C_HPm2 = 5e-08f;
+        float C_HPm1 = 5e-08f;
+        float L_LPm2 = 0.001f;
+        float L_LPm1 = 0.001f;
+        float L_LP2 = 0.001f;
+        float L_LP1 = 0.001f;
+        float L_HP1 = 0.001f;
+        float L_HPm = 0.001f;
+        float Rt = 560.0f;
+        float Rin = 560.0f;
+    };
+
+    /** Port 1's reflection coefficient, per adaptor */
+    struct Coefficients
+    {
+        float S8 = 0.f;
+        float P4 = 0.f;
+        float S7 = 0.f;
+        float S6 = 0.f;
+        float P3 = 0.f;
+        float S5 = 0.f;
+        float S4 = 0.f;
+        float P2 = 0.f;
+        float S3 = 0.f;
+        float S2 = 0.f;
+        float P1 = 0.f;
+        float S1 = 0.f;
+        float S0 = 0.f;
+    };
+
+    /** Each reactive element's last incident wave */
+    struct State
+    {
+        float C_LPm1 = 0.f;
+        float C_LP1 = 0.f;
+        float C_HP2 = 0.f;
+        float C_HP1 = 0.f;
+        float C_HPm2 = 0.f;
+        float C_HPm1 = 0.f;
+        float L_LPm2 = 0.f;
+        float L_LPm1 = 0.f;
+        float L_LP2 = 0.f;
+        float L_LP1 = 0.f;
+        float L_HP1 = 0.f;
+        float L_HPm = 0.f;
+    };
+
+    inline Coefficients computeCoefficients (const Values& v, float sampleRate) noexcept
+    {
+        const float twoFs = 2.f * sampleRate;
+
+        Coefficients k;
+
+        const float R_L_LPm2 = v.L_LPm2 * twoFs;
+        const float R_Rt = v.Rt;
+        const float R_S8 = R_L_LPm2 + R_Rt;
+        k.S8 = R_L_LPm2 / R_S8;
+
+        const float R_C_LPm1 = 1.f / (v.C_LPm1 * twoFs);
+        const float G_C_LPm1 = 1.f / R_C_LPm1;
+        const float G_S8 = 1.f / R_S8;
+        const float G_P4 = G_C_LPm1 + G_S8;
+        k.P4 = G_C_LPm1 / G_P4;
+
+        const float R_L_LPm1 = v.L_LPm1 * twoFs;
+        const float R_P4 = 1.f / G_P4;
+        const float R_S7 = R_L_LPm1 + R_P4;
+        k.S7 = R_L_LPm1 / R_S7;
+
+        const float R_L_LP2 = v.L_LP2 * twoFs;
+        const float R_S6 = R_L_LP2 + R_S7;
+        k.S6 = R_L_LP2 / R_S6;
+
+        const float R_C_LP1 = 1.f / (v.C_LP1 * twoFs);
+        const float G_C_LP1 = 1.f / R_C_LP1;
+        const float G_S6 = 1.f / R_S6;
+        const float G_P3 = G_C_LP1 + G_S6;
+        k.P3 = G_C_LP1 / G_P3;
+
+        const float R_L_LP1 = v.L_LP1 * twoFs;
+        const float R_P3 = 1.f / G_P3;
+        const float R_S5 = R_L_LP1 + R_P3;
+        k.S5 = R_L_LP1 / R_S5;
+
+        const float R_C_HP2 = 1.f / (v.C_HP2 * twoFs);
+        const float R_S4 = R_C_HP2 + R_S5;
+        k.S4 = R_C_HP2 / R_S4;
+
+        const float R_L_HP1 = v.L_HP1 * twoFs;
+        const float G_L_HP1 = 1.f / R_L_HP1;
+        const float G_S4 = 1.f / R_S4;
+        const float G_P2 = G_L_HP1 + G_S4;
+        k.P2 = G_L_HP1 / G_P2;
+
+        const float R_C_HP1 = 1.f / (v.C_HP1 * twoFs);
+        const float R_P2 = 1.f / G_P2;
+        const float R_S3 = R_C_HP1 + R_P2;
+        k.S3 = R_C_HP1 / R_S3;
+
+        const float R_C_HPm2 = 1.f / (v.C_HPm2 * twoFs);
+        const float R_S2 = R_C_HPm2 + R_S3;
+        k.S2 = R_C_HPm2 / R_S2;
+
+        const float R_L_HPm = v.L_HPm * twoFs;
+        const float G_L_HPm = 1.f / R_L_HPm;
+        const float G_S2 = 1.f / R_S2;
+        const float G_P1 = G_L_HPm + G_S2;
+        k.P1 = G_L_HPm / G_P1;
+
+        const float R_C_HPm1 = 1.f / (v.C_HPm1 * twoFs);
+        const float R_P1 = 1.f / G_P1;
+        const float R_S1 = R_C_HPm1 + R_P1;
+        k.S1 = R_C_HPm1 / R_S1;
+
+        const float R_Rin = v.Rin;
+        const float R_S0 = R_Rin + R_S1;
+        k.S0 = R_Rin / R_S0;
+
+        return k;
+    }
+
+    inline float processSample (State& z, const Coefficients& k, float x) noexcept
+    {
+        // reflected, from the leaves up
+        const float b_L_LPm2 = -z.L_LPm2;
+        const float b_Rt = 0.f;
+        const float b_S8 = -(b_L_LPm2 + b_Rt);
+        const float b_C_LPm1 = z.C_LPm1;
+        const float d_P4 = b_S8 - b_C_LPm1;
+        const float b_P4 = b_S8 - k.P4 * d_P4;
+        const float b_L_LPm1 = -z.L_LPm1;
+        const float b_S7 = -(b_L_LPm1 + b_P4);
+        const float b_L_LP2 = -z.L_LP2;
+        const float b_S6 = -(b_L_LP2 + b_S7);
+        const float b_C_LP1 = z.C_LP1;
+        const float d_P3 = b_S6 - b_C_LP1;
+        const float b_P3 = b_S6 - k.P3 * d_P3;
+        const float b_L_LP1 = -z.L_LP1;
+        const float b_S5 = -(b_L_LP1 + b_P3);
+        const float b_C_HP2 = z.C_HP2;
+        const float b_S4 = -(b_C_HP2 + b_S5);
+        const float b_L_HP1 = -z.L_HP1;
+        const float d_P2 = b_S4 - b_L_HP1;
+        const float b_P2 = b_S4 - k.P2 * d_P2;
+        const float b_C_HP1 = z.C_HP1;
+        const float b_S3 = -(b_C_HP1 + b_P2);
+        const float b_C_HPm2 = z.C_HPm2;
+        const float b_S2 = -(b_C_HPm2 + b_S3);
+        const float b_L_HPm = -z.L_HPm;
+        const float d_P1 = b_S2 - b_L_HPm;
+        const float b_P1 = b_S2 - k.P1 * d_P1;
+        const float b_C_HPm1 = z.C_HPm1;
+        const float b_S1 = -(b_C_HPm1 + b_P1);
+        const float b_Rin = 0.f;
+        const float b_S0 = -(b_Rin + b_S1);
+
+        // the ideal source, then incident from the root down
+        const float a_S0 = -b_S0 + 2.f * x;
+
+        const float a_Rin = b_Rin - k.S0 * (a_S0 + b_Rin + b_S1);
+        const float a_S1 = -(a_S0 + a_Rin);
+
+        const float a_C_HPm1 = b_C_HPm1 - k.S1 * (a_S1 + b_C_HPm1 + b_P1);
+        const float a_P1 = -(a_S1 + a_C_HPm1);
+
+        const float a_S2 = b_P1 - b_S2 + a_P1;
+        const float a_L_HPm = a_S2 + d_P1;
+
+        const float a_C_HPm2 = b_C_HPm2 - k.S2 * (a_S2 + b_C_HPm2 + b_S3);
+        const float a_S3 = -(a_S2 + a_C_HPm2);
+
+        const float a_C_HP1 = b_C_HP1 - k.S3 * (a_S3 + b_C_HP1 + b_P2);
+        const float a_P2 = -(a_S3 + a_C_HP1);
+
+        const float a_S4 = b_P2 - b_S4 + a_P2;
+        const float a_L_HP1 = a_S4 + d_P2;
+
+        const float a_C_HP2 = b_C_HP2 - k.S4 * (a_S4 + b_C_HP2 + b_S5);
+        const float a_S5 = -(a_S4 + a_C_HP2);
+
+        const float a_L_LP1 = b_L_LP1 - k.S5 * (a_S5 + b_L_LP1 + b_P3);
+        const float a_P3 = -(a_S5 + a_L_LP1);
+
+        const float a_S6 = b_P3 - b_S6 + a_P3;
+        const float a_C_LP1 = a_S6 + d_P3;
+
+        const float a_L_LP2 = b_L_LP2 - k.S6 * (a_S6 + b_L_LP2 + b_S7);
+        const float a_S7 = -(a_S6 + a_L_LP2);
+
+        const float a_L_LPm1 = b_L_LPm1 - k.S7 * (a_S7 + b_L_LPm1 + b_P4);
+        const float a_P4 = -(a_S7 + a_L_LPm1);
+
+        const float a_S8 = b_P4 - b_S8 + a_P4;
+        const float a_C_LPm1 = a_S8 + d_P4;
+
+        const float a_L_LPm2 = b_L_LPm2 - k.S8 * (a_S8 + b_L_LPm2 + b_Rt);
+        const float a_Rt = -(a_S8 + a_L_LPm2);
+
+        // each reactive element keeps its incident wave for next time
+        z.C_LPm1 = a_C_LPm1;
+        z.C_LP1 = a_C_LP1;
+        z.C_HP2 = a_C_HP2;
+        z.C_HP1 = a_C_HP1;
+        z.C_HPm2 = a_C_HPm2;
+        z.C_HPm1 = a_C_HPm1;
+        z.L_LPm2 = a_L_LPm2;
+        z.L_LPm1 = a_L_LPm1;
+        z.L_LP2 = a_L_LP2;
+        z.L_LP1 = a_L_LP1;
+        z.L_HP1 = a_L_HP1;
+        z.L_HPm = a_L_HPm;
+
+        return (a_Rt + b_Rt) * 0.5f;
+    }
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    RCA_Lanes.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    A few floats with elementwise arithmetic, so scalar code written against
+    a number type can run on Lanes::width values at once. The tolerance
+    analysis runs a trial per lane through ladderTransferFunction(); the
+    envelope modulation works its cutoff updates out Lanes::width at a time.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+struct Lanes
+{
+    static constexpr int width = 8;
+
+    float v[width];
+
+    Lanes (float x = 0.f) noexcept
+    {
+        for (auto& e : v)
+            e = x;
+    }
+
+    friend Lanes operator+ (const Lanes& a, const Lanes& b) noexcept { return apply (a, b, [] (float x, float y) { return x + y; }); }
+    friend Lanes operator- (const Lanes& a, const Lanes& b) noexcept { return apply (a, b, [] (float x, float y) { return x - y; }); }
+    friend Lanes operator* (const Lanes& a, const Lanes& b) noexcept { return apply (a, b, [] (float x, float y) { return x * y; }); }
+    friend Lanes operator/ (const Lanes& a, const Lanes& b) noexcept { return apply (a, b, [] (float x, float y) { return x / y; }); }
+
+private:
+    template <typename Op>
+    static Lanes apply (const Lanes& a, const Lanes& b, Op op) noexcept
+    {
+        Lanes result;
+
+        for (int i = 0; i < width; ++i)
+            result.v[i] = op (a.v[i], b.v[i]);
+
+        return result;
+    }
+};
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+    RCA_MK2_SEF_Bank.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Many independent RCA ladders (e.g. one per synth voice) processed side by
+    side. Each lane has its own components and state, but shares none of the
+    per-instance baggage of RCA_MK2_SEF (FFT, impulse buffer, knob tables).
+
+    Each lane runs the flat equations of processLadderSample() over its twelve
+    wave states and adaptor reflection coefficients, and the lanes are stored
+    struct-of-arrays in blocks of laneWidth, so the inner loop over a block is
+    plain float arithmetic the compiler turns into SIMD.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RCA_MKII_SEF.h"
+#include <vector>
+
+
+class RCA_MK2_SEF_Bank
+{
+public:
+    /** Lanes per SIMD block: two SSE/NEON registers or one AVX register */
+    static constexpr int laneWidth = 8;
+
+    explicit RCA_MK2_SEF_Bank (int numLanesToUse)
+        : numLanes (numLanesToUse),
+          lanes ((size_t) numLanesToUse),
+          blocks ((size_t) (numLanesToUse + laneWidth - 1) / laneWidth)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+            updateCoefficients (lane);
+    }
+
+    int getNumLanes() const { return numLanes; }
+
+    void prepare (float sampleRate)
+    {
+        fs = sampleRate;
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            updateCoefficients (lane);
+    }
+
+    void reset()
+    {
+        for (auto& block : blocks)
+            for (auto& z : block.z)
+                std::fill (std::begin (z), std::end (z), 0.f);
+    }
+
+    void reset (int lane)
+    {
+        for (auto& z : getBlock (lane).z)
+            z[lane % laneWidth] = 0.f;
+    }
+
+    //==============================================================================
+    void setComponentValues (int lane, const LadderComponents& newComponents)
+    {
+        auto& settings = lanes[(size_t) lane];
+
+        if (settings.components == newComponents)
+            return;
+
+        settings.components = newComponents;
+        updateCoefficients (lane);
+    }
+
+    const LadderComponents& getComponentValues (int lane) const { return lanes[(size_t) lane].components; }
+
+    void setHighPassCutoff (int lane, float newCutoff)
+    {
+        auto& settings = lanes[(size_t) lane];
+        auto next = settings.components;
+        next.setHighPassCutoff (newCutoff, settings.highPassMod, settings.k);
+        settings.highPassCutoff = newCutoff;
+
+        setComponentValues (lane, next);
+    }
+
+    void setLowPassCutoff (int lane, float newCutoff)
+    {
+        auto& settings = lanes[(size_t) lane];
+        auto next = settings.components;
+        next.setLowPassCutoff (newCutoff, settings.lowPassMod, settings.k);
+        settings.lowPassCutoff = newCutoff;
+
+        setComponentValues (lane, next);
+    }
+
+    void setHighPassMod (int lane, int mod)
+    {
+        auto& settings = lanes[(size_t) lane];
+
+        if (settings.highPassMod != mod)
+        {
+            settings.highPassMod = mod;
+            setHighPassCutoff (lane, settings.highPassCutoff);
+        }
+    }
+
+    void setLowPassMod (int lane, int mod)
+    {
+        auto& settings = lanes[(size_t) lane];
+
+        if (settings.lowPassMod != mod)
+        {
+            settings.lowPassMod = mod;
+            setLowPassCutoff (lane, settings.lowPassCutoff);
+        }
+    }
+
+    //==============================================================================
+    /** Runs numSamples of every lane. inputs[i] and outputs[i] belong to lane i */
+    void process (const float* const* inputs, float* const* outputs, int numSamples) noexcept
+    {
+        for (int b = 0; b < (int) blocks.size(); ++b)
+        {
+            const float* in[laneWidth];
+            float* out[laneWidth];
+
+            // padding lanes past the end borrow lane 0's input and have nowhere to write
+            for (int j = 0; j < laneWidth; ++j)
+            {
+                const int lane = b * laneWidth + j;
+                in[j] = inputs[lane < numLanes ? lane : 0];
+                out[j] = lane < numLanes ? outputs[lane] : nullptr;
+            }
+
+            processBlock (blocks[(size_t) b], in, out, numSamples);
+        }
+    }
+
+private:
+    struct LaneSettings
+    {
+        LadderComponents components;
+
+        float highPassCutoff = 20.f;
+        float lowPassCutoff = 20000.f;
+        int highPassMod = 1;
+        int lowPassMod = 1;
+        float k = 560.f;
+    };
+
+    /** laneWidth ladders, one per column */
+    struct alignas (32) LaneBlock
+    {
+        float z[RCA_MK2_SEF::numStates][laneWidth] {};
+        float s[9][laneWidth] {};
+        float p[4][laneWidth] {};
+    };
+
+    LaneBlock& getBlock (int lane) { return blocks[(size_t) (lane / laneWidth)]; }
+
+    void updateCoefficients (int lane)
+    {
+        const auto coeffs = LadderCoefficients::fromComponents (lanes[(size_t) lane].components, fs);
+        auto& block = getBlock (lane);
+        const int j = lane % laneWidth;
+
+        for (size_t i = 0; i < coeffs.series.size(); ++i)
+            block.s[i][j] = coeffs.series[i];
+
+        for (size_t i = 0; i < coeffs.parallel.size(); ++i)
+            block.p[i][j] = coeffs.parallel[i];
+    }
+
+    /**
+     * processLadderSample() per lane. The lane index is innermost and every access is
+     * into a contiguous lane array, so the loop over j vectorises.
+     */
+    static void processBlock (LaneBlock& block, const float* const* in, float* const* out, int numSamples) noexcept
+    {
+        LaneBlock local = block;
+        auto& z = local.z;
+        const auto& s = local.s;
+        const auto& p = local.p;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            float x[laneWidth], y[laneWidth];
+
+            // gather first, so the loop below only touches contiguous lane arrays and vectorises
+            for (int j = 0; j < laneWidth; ++j)
+                x[j] = in[j][n];
+
+            for (int j = 0; j < laneWidth; ++j)
+            {
+                y[j] = processLadderSample<float> ([&] (int i) -> float& { return z[i][j]; },
+                                                   [&] (int i) { return s[i][j]; },
+                                                   [&] (int i) { return p[i - 1][j]; },
+                                                   x[j]);
+            }
+
+            for (int j = 0; j < laneWidth; ++j)
+                if (out[j] != nullptr)
+                    out[j][n] = y[j];
+        }
+
+        for (int i = 0; i < RCA_MK2_SEF::numStates; ++i)
+            for (int j = 0; j < laneWidth; ++j)
+                block.z[i][j] = z[i][j];
+    }
+
+    int numLanes;
+    float fs = 48000;
+
+    std::vector<LaneSettings> lanes;
+    std::vector<LaneBlock> blocks;
+};
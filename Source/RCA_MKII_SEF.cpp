@@ -0,0 +1,281 @@
+/*
+  ==============================================================================
+
+    RCA_MKII_SEF.cpp
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+  ==============================================================================
+*/
+
+#include "RCA_MKII_SEF.h"
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+
+const std::array<RCA_MK2_SEF::KnobPosition, 11> RCA_MK2_SEF::highPassKnobPositions =
+{{
+    {0, 99999, 99999},
+    {175, 1.6e-6, 255.6e-3},
+    {248, 1.15e-6, 176.9e-3},
+    {352, 0.8e-6, 126.4e-3},
+    {497, 0.57e-6, 90.11e-3},
+    {699, 0.4e-6, 63.9e-3},
+    {1002, 0.272e-6, 44.56e-3},
+    {1411, 0.2e-6, 31.79e-3},
+    {2024, 0.15e-6, 21.77e-3},
+    {2847, 0.1e-6, 15.63e-3},
+    {3994, 0.069e-6, 11.18e-3}
+}};
+
+const std::array<RCA_MK2_SEF::KnobPosition, 11> RCA_MK2_SEF::lowPassKnobPositions =
+{{
+    {175, 3.22e-6, 511.1e-3},
+    {245, 2.3e-6, 365.2e-3},
+    {350, 1.6e-6, 255.6e-3},
+    {499, 1.15e-6, 178.6e-3},
+    {703, 0.8e-6, 126.4e-3},
+    {996, 0.57e-6, 90.02e-3},
+    {1408, 0.4e-6, 63.54e-3},
+    {1989, 0.272e-6, 45.08e-3},
+    {2803, 0.2e-6, 32.13e-3},
+    {3992, 0.15e-6, 22.38e-3},
+    {999999, 1e-10, 1e-10}
+}};
+
+
+namespace
+{
+    /** Slot 0 is the built-in table. Slots fill once, in order, and are never freed */
+    struct KnobTables
+    {
+        KnobTables()
+        {
+            tables[0].store(&builtIn);
+        }
+        
+        const RCA_MK2_SEF::KnobTable builtIn;
+        std::array<std::atomic<const RCA_MK2_SEF::KnobTable*>, RCA_MK2_SEF::maxKnobTables> tables {};
+        std::vector<std::unique_ptr<RCA_MK2_SEF::KnobTable>> added;
+        std::mutex addLock;
+    };
+    
+    KnobTables& getKnobTables()
+    {
+        static KnobTables instance;
+        return instance;
+    }
+}
+
+const RCA_MK2_SEF::KnobTable& RCA_MK2_SEF::getKnobTable(int id) noexcept
+{
+    auto& registry = getKnobTables();
+    
+    if (id > 0 && id < maxKnobTables)
+        if (const auto* table = registry.tables[(size_t) id].load(std::memory_order_acquire))
+            return *table;
+    
+    return registry.builtIn;
+}
+
+int RCA_MK2_SEF::addKnobTable(const KnobTable& table)
+{
+    auto& registry = getKnobTables();
+    const std::lock_guard<std::mutex> lock(registry.addLock);
+    
+    for (int id = 0; id < maxKnobTables; ++id)
+    {
+        const auto* existing = registry.tables[(size_t) id].load(std::memory_order_acquire);
+        
+        if (existing == nullptr)
+        {
+            registry.added.push_back(std::make_unique<KnobTable>(table));
+            registry.tables[(size_t) id].store(registry.added.back().get(), std::memory_order_release);
+            return id;
+        }
+        
+        if (*existing == table)
+            return id;
+    }
+    
+    return -1;
+}
+
+bool RCA_MK2_SEF::parseKnobTable(const std::string& text, KnobTable& table, std::string& error)
+{
+    table = KnobTable();
+    
+    std::istringstream lines(text);
+    std::string line;
+    
+    for (int lineNumber = 1; std::getline(lines, line); ++lineNumber)
+    {
+        std::istringstream fields(line);
+        std::string section;
+        
+        if (! (fields >> section) || section[0] == '#')
+            continue;
+        
+        int pos = 0;
+        KnobPosition values;
+        
+        if (! (fields >> pos >> values.cutoff >> values.C >> values.L))
+        {
+            error = "line " + std::to_string(lineNumber) + ": expected a section, position, cutoff, C and L";
+            return false;
+        }
+        
+        if ((section != "hp" && section != "lp") || pos < 1 || pos > 11 || ! (values.C > 0.f) || ! (values.L > 0.f))
+        {
+            error = "line " + std::to_string(lineNumber) + ": no such knob position, or C or L not positive";
+            return false;
+        }
+        
+        (section == "hp" ? table.highPass : table.lowPass)[(size_t) pos - 1] = values;
+    }
+    
+    return true;
+}
+
+std::string RCA_MK2_SEF::writeKnobTable(const KnobTable& table, const std::string& comment)
+{
+    std::ostringstream text;
+    text.precision(9);
+    
+    std::istringstream commentLines(comment);
+    
+    for (std::string line; std::getline(commentLines, line);)
+        text << "# " << line << "\n";
+    
+    text << "# section position cutoff C L\n";
+    
+    for (int pos = 1; pos <= 11; ++pos)
+    {
+        const auto& values = table.highPass[(size_t) pos - 1];
+        text << "hp " << pos << " " << values.cutoff << " " << values.C << " " << values.L << "\n";
+    }
+    
+    for (int pos = 1; pos <= 11; ++pos)
+    {
+        const auto& values = table.lowPass[(size_t) pos - 1];
+        text << "lp " << pos << " " << values.cutoff << " " << values.C << " " << values.L << "\n";
+    }
+    
+    return text.str();
+}
+
+
+RCA_MK2_SEF::Snapshot RCA_MK2_SEF::saveState() const
+{
+    Snapshot snapshot;
+    snapshot.engine = (int32_t) engine;
+    snapshot.sampleRate = fs;
+    snapshot.components = components;
+    snapshot.highPassCutoff = highPassCutoff;
+    snapshot.lowPassCutoff = lowPassCutoff;
+    snapshot.highPassMod = highPassMod;
+    snapshot.lowPassMod = lowPassMod;
+    snapshot.k = k;
+    snapshot.state = getExactState();
+    return snapshot;
+}
+
+bool RCA_MK2_SEF::restoreState(const Snapshot& snapshot)
+{
+    if (snapshot.magic != Snapshot::magicNumber || snapshot.version != Snapshot::currentVersion
+        || snapshot.engine < 0 || snapshot.engine > (int32_t) Engine::precise)
+        return false;
+    
+    setEngine((Engine) snapshot.engine);
+    
+    if (fs != snapshot.sampleRate)
+        prepare(snapshot.sampleRate);
+    
+    k = snapshot.k;
+    highPassMod = snapshot.highPassMod;
+    lowPassMod = snapshot.lowPassMod;
+    highPassCutoff = snapshot.highPassCutoff;
+    lowPassCutoff = snapshot.lowPassCutoff;
+    
+    setComponentValues(snapshot.components);
+    setExactState(snapshot.state);
+    return true;
+}
+
+void RCA_MK2_SEF::copySettingsFrom(const RCA_MK2_SEF& other)
+{
+    setEngine(other.engine);
+    
+    if (fs != other.fs)
+        prepare(other.fs);
+    
+    k = other.k;
+    knobTable = other.knobTable;
+    highPassMod = other.highPassMod;
+    lowPassMod = other.lowPassMod;
+    highPassCutoff = other.highPassCutoff;
+    lowPassCutoff = other.lowPassCutoff;
+    
+    setComponentValues(other.components);
+}
+
+void RCA_MK2_SEF::computeImpulseResponse(float* dest, int numSamples) noexcept
+{
+    reset();
+    
+    for (int n = 0; n < numSamples; ++n)
+        dest[n] = processSample(n == 0 ? 1.f : 0.f);
+    
+    reset();
+}
+
+void RCA_MK2_SEF::computeMagnitudeResponse(const float* freqs, float* mags, int numPoints) const noexcept
+{
+    const double twoPi = LadderComponents::twoPi;
+    
+    if (engine == Engine::alpha || engine == Engine::precise)
+    {
+        const auto warped = AlphaPrewarp::apply(components, fs);
+        
+        for (int n = 0; n < numPoints; ++n)
+        {
+            const double w = std::min(twoPi * freqs[n] / fs, 0.999 * twoPi * 0.5);
+            const auto sHighPass = AlphaPrewarp::getS(w, warped.highPassAlpha, fs);
+            const auto sLowPass = AlphaPrewarp::getS(w, warped.lowPassAlpha, fs);
+            mags[n] = float(std::abs(ladderTransferFunction(warped.components, sHighPass, sLowPass)));
+        }
+        
+        return;
+    }
+    
+    for (int n = 0; n < numPoints; ++n)
+    {
+        // stay just below Nyquist, where the bilinear frequency warping blows up
+        const double w = std::min(twoPi * freqs[n] / fs, 0.999 * twoPi * 0.5);
+        const std::complex<double> s (0.0, 2.0 * fs * std::tan(0.5 * w));
+        mags[n] = float(std::abs(ladderTransferFunction(components, s)));
+    }
+}
+
+void RCA_MK2_SEF::saveResponseToCSV(const float* response, int numPoints, const std::string& filename)
+{
+    std::ofstream file;
+
+    file.open(filename);
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        file << response[i];
+
+        if (i + 1 < numPoints)
+            file << ",";
+    }
+    
+    file.close();
+    std::cout << "Data saved to " + filename << std::endl;
+}
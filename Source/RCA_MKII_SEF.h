@@ -7,6 +7,9 @@
  
     Based on https://dafx2020.mdw.ac.at/proceedings/papers/DAFx20in22_paper_39.pdf
 
+    Plain C++17 with no JUCE dependency, so it can be built on its own as the
+    core library (Core/RCA MK II Core.jucer) as well as inside the plugin.
+
   ==============================================================================
 */
 
@@ -14,24 +17,414 @@
 #pragma once
 
 #include "chowdsp_wdf.h"
-#include <iostream>
-#include <fstream>
+#include "RCA_RtypeLadder.h"
+#include "RCA_AlphaPrewarp.h"
+#include "RCA_GeneratedLadder.h"
 #include <string>
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <type_traits>
 
 
 using namespace chowdsp::wdft;
 
 
+/** Values of every element in the ladder, named after the WDF elements in RCA_MK2_SEF */
+template <typename T>
+struct LadderComponentsT
+{
+    T Rin = 560, Rt = 560;
+
+    T C_HPm1 = 5.0e-8, L_HPm = 1.0e-3, C_HPm2 = 5.0e-8;
+    T C_HP1 = 5.0e-8, L_HP1 = 1.0e-3, C_HP2 = 1.0e-8;
+    T L_LP1 = 1.0e-3, C_LP1 = 1.0e-8, L_LP2 = 1.0e-3;
+    T L_LPm1 = 1.0e-3, C_LPm1 = 1.0e-8, L_LPm2 = 1.0e-3;
+    
+    bool operator==(const LadderComponentsT& other) const
+    {
+        return Rin == other.Rin && Rt == other.Rt
+            && C_HPm1 == other.C_HPm1 && L_HPm == other.L_HPm && C_HPm2 == other.C_HPm2
+            && C_HP1 == other.C_HP1 && L_HP1 == other.L_HP1 && C_HP2 == other.C_HP2
+            && L_LP1 == other.L_LP1 && C_LP1 == other.C_LP1 && L_LP2 == other.L_LP2
+            && L_LPm1 == other.L_LPm1 && C_LPm1 == other.C_LPm1 && L_LPm2 == other.L_LPm2;
+    }
+    
+    bool operator!=(const LadderComponentsT& other) const {return ! (*this == other);}
+    
+    /** The same values in another precision */
+    template <typename U>
+    LadderComponentsT<U> convertTo() const
+    {
+        LadderComponentsT<U> c;
+        c.Rin = (U) Rin;                 c.Rt = (U) Rt;
+        c.C_HPm1 = (U) C_HPm1;           c.L_HPm = (U) L_HPm;     c.C_HPm2 = (U) C_HPm2;
+        c.C_HP1 = (U) C_HP1;             c.L_HP1 = (U) L_HP1;     c.C_HP2 = (U) C_HP2;
+        c.L_LP1 = (U) L_LP1;             c.C_LP1 = (U) C_LP1;     c.L_LP2 = (U) L_LP2;
+        c.L_LPm1 = (U) L_LPm1;           c.C_LPm1 = (U) C_LPm1;   c.L_LPm2 = (U) L_LPm2;
+        return c;
+    }
+    
+    /** Sets the HP section from a C and L. With mod off, the HPm section is moved far below the audio band */
+    void setHighPass(T C, T L, bool mod, T k)
+    {
+        C_HP1 = C_HP2 = C;
+        L_HP1 = L;
+        
+        if (! mod)
+        {
+            T wc = (T) 1e-8;
+            C = root2 / (k * wc);
+            L = k / ((T) 2 * root2 * wc);
+        }
+        
+        C_HPm1 = C_HPm2 = C;
+        L_HPm = L;
+    }
+    
+    /** Sets the LP section from a C and L. With mod off, the LPm section is moved far above the audio band */
+    void setLowPass(T C, T L, bool mod, T k)
+    {
+        C_LP1 = C;
+        L_LP1 = L_LP2 = L;
+        
+        if (! mod)
+        {
+            T wc = (T) 1e8;
+            C = ((T) 2 * root2) / (k * wc);
+            L = (root2 * k) / wc;
+        }
+        
+        C_LPm1 = C;
+        L_LPm1 = L_LPm2 = L;
+    }
+    
+    /** Constant-k HP values for a cutoff in Hz, for a ladder terminated in k ohms */
+    void setHighPassCutoff(T cutoff, bool mod, T k)
+    {
+        T wc = cutoff * twoPi;
+        setHighPass(root2 / (k * wc), k / ((T) 2 * root2 * wc), mod, k);
+    }
+    
+    void setLowPassCutoff(T cutoff, bool mod, T k)
+    {
+        T wc = cutoff * twoPi;
+        setLowPass(((T) 2 * root2) / (k * wc), (root2 * k) / wc, mod, k);
+    }
+    
+    /** The cutoffs in Hz the section values were designed for; C * L is 1 / (2 wc^2) for HP and 4 / wc^2 for LP */
+    double getHighPassCutoff() const {return 1.0 / (6.283185307179586477 * std::sqrt(2.0 * (double) C_HP1 * (double) L_HP1));}
+    double getLowPassCutoff() const {return 2.0 / (6.283185307179586477 * std::sqrt((double) C_LP1 * (double) L_LP1));}
+    
+    /** With mod off, setHighPass()/setLowPass() park the m-derived elements on values of their own */
+    bool isHighPassModOn() const {return C_HPm1 == C_HP1 && L_HPm == L_HP1;}
+    bool isLowPassModOn() const {return C_LPm1 == C_LP1 && L_LPm1 == L_LP1;}
+    
+    static constexpr T root2 = (T) 1.4142135623730950488;
+    static constexpr T twoPi = (T) 6.283185307179586477;
+};
+
+using LadderComponents = LadderComponentsT<float>;
+
+
+/**
+ * Port-1 reflection coefficients of every adaptor in the tree, which is all the
+ * per-sample maths needs besides the wave states. Computed the same way chowdsp's
+ * calcImpedance() does, so a flat implementation matches the tree.
+ */
+template <typename T>
+struct LadderCoefficientsT
+{
+    std::array<T, 9> series {};     // S0 .. S8:  R1 / (R1 + R2)
+    std::array<T, 4> parallel {};   // P1 .. P4:  G1 / (G1 + G2)
+    
+    /**
+     * The alphas are the alpha transform's, per section (1 is the bilinear transform).
+     * They only change the reactive port resistances; see RCA_AlphaPrewarp.h for the rest.
+     */
+    static LadderCoefficientsT fromComponents(const LadderComponentsT<T>& c, T sampleRate,
+                                              T highPassAlpha = (T) 1, T lowPassAlpha = (T) 1)
+    {
+        return fromPortResistances(getPortResistances(c, sampleRate, highPassAlpha, lowPassAlpha), c.Rin, c.Rt);
+    }
+    
+    /** Port resistance of each reactive element, in LadderComponents order */
+    static std::array<T, 12> getPortResistances(const LadderComponentsT<T>& c, T sampleRate,
+                                                T highPassAlpha = (T) 1, T lowPassAlpha = (T) 1)
+    {
+        const T hp = ((T) 1 + highPassAlpha) * sampleRate;
+        const T lp = ((T) 1 + lowPassAlpha) * sampleRate;
+        
+        auto capacitor = [](T C, T scale) { return (T) 1 / (C * scale); };
+        auto inductor  = [](T L, T scale) { return L * scale; };
+        
+        return {capacitor(c.C_HPm1, hp), inductor(c.L_HPm, hp), capacitor(c.C_HPm2, hp),
+                capacitor(c.C_HP1, hp), inductor(c.L_HP1, hp), capacitor(c.C_HP2, hp),
+                inductor(c.L_LP1, lp), capacitor(c.C_LP1, lp), inductor(c.L_LP2, lp),
+                inductor(c.L_LPm1, lp), capacitor(c.C_LPm1, lp), inductor(c.L_LPm2, lp)};
+    }
+    
+    /**
+     * The adaptor tree from the load up, given every port resistance. RCA_EnvelopeModulation.h
+     * keeps a lane-wise copy of it; the two have to change together.
+     */
+    static LadderCoefficientsT fromPortResistances(const std::array<T, 12>& r, T Rin, T Rt)
+    {
+        struct Port { T R, G; };
+        
+        auto resistor = [](T R) { return Port {R, (T) 1 / R}; };
+        
+        LadderCoefficientsT coeffs;
+        
+        auto series = [&](int index, Port p1, Port p2)
+        {
+            const T R = p1.R + p2.R;
+            coeffs.series[(size_t) index] = p1.R / R;
+            return resistor(R);
+        };
+        
+        auto parallel = [&](int index, Port p1, Port p2)
+        {
+            const T G = p1.G + p2.G;
+            coeffs.parallel[(size_t) index - 1] = p1.G / G;
+            return Port {(T) 1 / G, G};
+        };
+        
+        const auto S8 = series(8, resistor(r[11]), resistor(Rt));
+        const auto P4 = parallel(4, resistor(r[10]), S8);
+        const auto S7 = series(7, resistor(r[9]), P4);
+        const auto S6 = series(6, resistor(r[8]), S7);
+        const auto P3 = parallel(3, resistor(r[7]), S6);
+        const auto S5 = series(5, resistor(r[6]), P3);
+        const auto S4 = series(4, resistor(r[5]), S5);
+        const auto P2 = parallel(2, resistor(r[4]), S4);
+        const auto S3 = series(3, resistor(r[3]), P2);
+        const auto S2 = series(2, resistor(r[2]), S3);
+        const auto P1 = parallel(1, resistor(r[1]), S2);
+        const auto S1 = series(1, resistor(r[0]), P1);
+        series(0, resistor(Rin), S1);
+        
+        return coeffs;
+    }
+};
+
+using LadderCoefficients = LadderCoefficientsT<float>;
+
+
+/**
+ * One sample of the ladder with the tree flattened into straight-line equations: the
+ * reflected() pass from the load up, the ideal source, then incident() back down.
+ * z(i) is the wave state of reactive i in LadderComponents order; a capacitor reflects
+ * z, an inductor -z, and each keeps its new incident wave as its next z. s(i) and p(i)
+ * are the S0..S8 and P1..P4 coefficients. Taking accessors lets RCA_MK2_SEF and the
+ * lane-blocked RCA_MK2_SEF_Bank share these equations.
+ *
+ * commit(i, a) stores the next state of reactive i from its new incident wave a,
+ * once every state has been read.
+ */
+template <typename T, typename States, typename Series, typename Parallel, typename Commit>
+inline T processLadderSample(States&& z, Series&& s, Parallel&& p, T x, Commit&& commit) noexcept
+{
+    // reflected, from the load up
+    const T bS8 = z(11);
+    const T dP4 = bS8 - z(10);
+    const T bP4 = bS8 - p(4) * dP4;
+    const T bS7 = z(9) - bP4;
+    const T bS6 = z(8) - bS7;
+    const T dP3 = bS6 - z(7);
+    const T bP3 = bS6 - p(3) * dP3;
+    const T bS5 = z(6) - bP3;
+    const T bS4 = -(z(5) + bS5);
+    const T dP2 = bS4 + z(4);
+    const T bP2 = bS4 - p(2) * dP2;
+    const T bS3 = -(z(3) + bP2);
+    const T bS2 = -(z(2) + bS3);
+    const T dP1 = bS2 + z(1);
+    const T bP1 = bS2 - p(1) * dP1;
+    const T bS1 = -(z(0) + bP1);
+    const T bS0 = -bS1;
+    
+    // the ideal source, then incident from the top down
+    const T aS0 = -bS0 + (T) 2 * x;
+    
+    const T rin = -(s(0) * (aS0 + bS1));
+    const T aS1 = -(aS0 + rin);
+    
+    const T c0 = z(0) - s(1) * (aS1 + z(0) + bP1);
+    const T aP1 = -(aS1 + c0);
+    
+    const T aS2 = bP1 - bS2 + aP1;
+    const T l1 = aS2 + dP1;
+    
+    const T c2 = z(2) - s(2) * (aS2 + z(2) + bS3);
+    const T aS3 = -(aS2 + c2);
+    
+    const T c3 = z(3) - s(3) * (aS3 + z(3) + bP2);
+    const T aP2 = -(aS3 + c3);
+    
+    const T aS4 = bP2 - bS4 + aP2;
+    const T l4 = aS4 + dP2;
+    
+    const T c5 = z(5) - s(4) * (aS4 + z(5) + bS5);
+    const T aS5 = -(aS4 + c5);
+    
+    const T l6 = -z(6) - s(5) * (aS5 + -z(6) + bP3);
+    const T aP3 = -(aS5 + l6);
+    
+    const T aS6 = bP3 - bS6 + aP3;
+    const T c7 = aS6 + dP3;
+    
+    const T l8 = -z(8) - s(6) * (aS6 + -z(8) + bS7);
+    const T aS7 = -(aS6 + l8);
+    
+    const T l9 = -z(9) - s(7) * (aS7 + -z(9) + bP4);
+    const T aP4 = -(aS7 + l9);
+    
+    const T aS8 = bP4 - bS8 + aP4;
+    const T c10 = aS8 + dP4;
+    
+    const T l11 = -z(11) - s(8) * (aS8 + -z(11));
+    const T aRt = -(aS8 + l11);
+    
+    commit(0, c0);   commit(1, l1);   commit(2, c2);
+    commit(3, c3);   commit(4, l4);   commit(5, c5);
+    commit(6, l6);   commit(7, c7);   commit(8, l8);
+    commit(9, l9);   commit(10, c10); commit(11, l11);
+    
+    // voltage across Rt, which reflects nothing
+    return aRt * (T) 0.5;
+}
+
+/** With bilinear elements, each state is just the element's last incident wave */
+template <typename T, typename States, typename Series, typename Parallel>
+inline T processLadderSample(States&& z, Series&& s, Parallel&& p, T x) noexcept
+{
+    return processLadderSample<T>(z, s, p, x, [&](int i, T a) { z(i) = a; });
+}
+
+
+/**
+ * Voltage transfer function Vout / Vs of the ladder at the complex frequency s.
+ * With s = j * 2fs * tan(w / 2) this is exactly the response of the bilinear WDF.
+ * The HP and LP elements can be given different s, for sections discretised
+ * differently (see RCA_AlphaPrewarp.h).
+ */
+template <typename Complex, typename Components>
+Complex ladderTransferFunction(const Components& c, Complex sHighPass, Complex sLowPass)
+{
+    const Complex one (1);
+    
+    auto zC = [&](auto C, const Complex& s) { return one / (s * Complex(C)); };
+    auto zL = [&](auto L, const Complex& s) { return s * Complex(L); };
+    auto parallel = [](const Complex& a, const Complex& b) { return a * b / (a + b); };
+    
+    const Complex Rt (c.Rt);
+    
+    /** Impedances looking into each adaptor, from the load up */
+    const auto zS8 = zL(c.L_LPm2, sLowPass) + Rt;
+    const auto zP4 = parallel(zC(c.C_LPm1, sLowPass), zS8);
+    const auto zS7 = zL(c.L_LPm1, sLowPass) + zP4;
+    const auto zS6 = zL(c.L_LP2, sLowPass) + zS7;
+    const auto zP3 = parallel(zC(c.C_LP1, sLowPass), zS6);
+    const auto zS5 = zL(c.L_LP1, sLowPass) + zP3;
+    const auto zS4 = zC(c.C_HP2, sHighPass) + zS5;
+    const auto zP2 = parallel(zL(c.L_HP1, sHighPass), zS4);
+    const auto zS3 = zC(c.C_HP1, sHighPass) + zP2;
+    const auto zS2 = zC(c.C_HPm2, sHighPass) + zS3;
+    const auto zP1 = parallel(zL(c.L_HPm, sHighPass), zS2);
+    const auto zS1 = zC(c.C_HPm1, sHighPass) + zP1;
+    const auto zS0 = Complex(c.Rin) + zS1;
+    
+    /** ... then divide the source voltage back down */
+    const auto vP1 = zP1 / zS0;
+    const auto vP2 = vP1 * zP2 / zS2;
+    const auto vP3 = vP2 * zP3 / zS4;
+    const auto vP4 = vP3 * zP4 / zS6;
+    
+    return vP4 * Rt / zS8;
+}
+
+template <typename Complex, typename Components>
+Complex ladderTransferFunction(const Components& c, Complex s)
+{
+    return ladderTransferFunction(c, s, s);
+}
+
+
 class RCA_MK2_SEF
 {
 public:
     RCA_MK2_SEF() = default;
+    
+    /** The adaptors hold references to their children, so a copy would still point into the original */
+    RCA_MK2_SEF(const RCA_MK2_SEF&) = delete;
+    RCA_MK2_SEF& operator=(const RCA_MK2_SEF&) = delete;
+    
+    /** Number of reactive elements, which between them hold all of the ladder's memory */
+    static constexpr int numStates = 12;
+    
+    /**
+     * Wave state of each reactive element, in LadderComponents order (C_HPm1 ... L_LPm2).
+     * For the alpha and precise engines it's the element's next reflected wave (negated for
+     * inductors) rather than its last incident wave; with the bilinear elements the two are the same.
+     */
+    using State = std::array<float, numStates>;
+    
+    /** The same in double, which Engine::precise's states need to come back exactly */
+    using ExactState = std::array<double, numStates>;
+    
+    /** Which wave-domain implementation processSample() runs */
+    enum class Engine
+    {
+        wdfTree,    // nested series/parallel adaptors, S0..S8 and P1..P4
+        rtype,      // a single R-type junction, see RCA_RtypeLadder.h
+        flat,       // processLadderSample() on precomputed coefficients, bit-exact with wdfTree
+        alpha,      // flat, on alpha-transform elements with prewarped values, see RCA_AlphaPrewarp.h
+        generated,  // straight-line code from Tools/WdfCodegen, see RCA_GeneratedLadder.h; bit-exact with wdfTree
+        precise     // alpha, with its coefficients and states in double, for offline renders
+    };
+    
+    /**
+     * Every engine runs the same twelve reactive states, so switching carries them across
+     * rather than resetting: the output goes on from where it was instead of clicking.
+     */
+    void setEngine(Engine newEngine)
+    {
+        if (engine == newEngine)
+            return;
+        
+        const auto state = getExactState();
+        engine = newEngine;
+        
+        // only wdfTree keeps the tree up to date, so it has to catch up when we come back to it
+        if (engine == Engine::wdfTree)
+            updateTree();
+        
+        if (engine == Engine::rtype)
+        {
+            rtypeLadder.prepare(fs);
+            rtypeLadder.setComponentValues(components);
+        }
+        
+        updateFlatCoefficients();
+        setExactState(state);
+    }
+    
+    Engine getEngine() const {return engine;}
 
     void prepare (float sampleRate)
     {
         fs = sampleRate;
         
+        {
+        // every element recomputes its impedance once on scope exit, leaves first, then S8 up to S0
+        ScopedDeferImpedancePropagation deferImpedance { Rin, C_HPm1, L_HPm, C_HPm2, C_HP1, L_HP1, C_HP2,
+                                                         L_LP1, C_LP1, L_LP2, L_LPm1, C_LPm1, L_LPm2, Rt,
+                                                         S8, P4, S7, S6, P3, S5, S4, P2, S3, S2, P1, S1, S0 };
+        
         C_HP1.prepare(sampleRate);
         C_HP2.prepare(sampleRate);
         C_HPm1.prepare(sampleRate);
@@ -45,76 +438,248 @@ public:
         L_LP2.prepare(sampleRate);
         L_LPm1.prepare(sampleRate);
         L_LPm2.prepare(sampleRate);
+        }
         
+        if (engine == Engine::rtype)
+            rtypeLadder.prepare(sampleRate);
+        
+        updateFlatCoefficients();
     }
 
     void reset()
     {
-        C_HP1.reset();
-        C_HP2.reset();
-        C_HPm1.reset();
-        C_HPm2.reset();
-        C_LP1.reset();
-        C_LPm1.reset();
-
-        L_HP1.reset();
-        L_HPm.reset();
-        L_LP1.reset();
-        L_LP2.reset();
-        L_LPm1.reset();
-        L_LPm2.reset();
+        // incident(0) clears each element's state and its stored incident wave, see getState()
+        forEachReactive(*this, [](auto& element, int) { element.incident(0.f); });
+        
+        rtypeLadder.reset();
+        flatState = {};
+        preciseState = {};
+        generatedState = {};
     }
-
-    void setOutputImpedance(float newZ)
+    
+    /**
+     * The current state of whichever engine is running. Feeding the same input to two
+     * filters with equal settings and equal states gives identical output.
+     */
+    State getState() const
     {
-        if (outputImpedance != newZ)
+        if (engine == Engine::rtype)
+            return rtypeLadder.getState();
+        
+        State state;
+        
+        if (engine == Engine::generated)
         {
-            outputImpedance = newZ;
-            Rt.setResistanceValue(outputImpedance);
+            forEachReactive(generatedState, [&](float z, int index) { state[(size_t) index] = z; });
+            return state;
         }
+        
+        if (engine == Engine::precise)
+        {
+            for (size_t i = 0; i < state.size(); ++i)
+                state[i] = (float) preciseState[i];
+            
+            return state;
+        }
+        
+        if (usesFlatEquations())
+            return flatState;
+        
+        // chowdsp keeps z private, but it is always a copy of the last incident wave
+        forEachReactive(*this, [&](const auto& element, int index) { state[(size_t) index] = element.wdf.a; });
+        return state;
+    }
+    
+    void setState(const State& state)
+    {
+        if (engine == Engine::rtype)
+        {
+            rtypeLadder.setState(state);
+            return;
+        }
+        
+        if (engine == Engine::generated)
+        {
+            forEachReactive(generatedState, [&](float& z, int index) { z = state[(size_t) index]; });
+            return;
+        }
+        
+        if (engine == Engine::precise)
+        {
+            for (size_t i = 0; i < state.size(); ++i)
+                preciseState[i] = (double) state[i];
+            
+            return;
+        }
+        
+        if (usesFlatEquations())
+        {
+            flatState = state;
+            return;
+        }
+        
+        forEachReactive(*this, [&](auto& element, int index) { element.incident(state[(size_t) index]); });
+    }
+    
+    /** getState(), without rounding Engine::precise's states to float */
+    ExactState getExactState() const
+    {
+        if (engine == Engine::precise)
+            return preciseState;
+        
+        const auto state = getState();
+        
+        ExactState exact;
+        std::copy(state.begin(), state.end(), exact.begin());
+        return exact;
+    }
+    
+    /** setState() from getExactState(); the float engines take it back exactly, having given floats */
+    void setExactState(const ExactState& state)
+    {
+        if (engine == Engine::precise)
+        {
+            preciseState = state;
+            return;
+        }
+        
+        State rounded;
+        for (size_t i = 0; i < state.size(); ++i)
+            rounded[i] = (float) state[i];
+        
+        setState(rounded);
+    }
+    
+    /**
+     * Everything needed to carry on exactly where a filter left off: settings plus the
+     * reactive states. The adaptor waves are recomputed from those every sample, so they
+     * aren't stored. Plain data, so it can be written out or sent to another process as
+     * raw bytes (between machines with the same float layout and endianness).
+     */
+    struct Snapshot
+    {
+        static constexpr uint32_t magicNumber = 0x32414352; // "RCA2"
+        static constexpr uint32_t currentVersion = 1;
+        
+        uint32_t magic = magicNumber;
+        uint32_t version = currentVersion;
+        
+        int32_t engine = 0;
+        float sampleRate = 48000;
+        
+        LadderComponents components;
+        
+        float highPassCutoff = 20.f;
+        float lowPassCutoff = 20000.f;
+        int32_t highPassMod = 1;
+        int32_t lowPassMod = 1;
+        float k = 560.f;
+        
+        ExactState state {};
+    };
+    
+    Snapshot saveState() const;
+    
+    /** Returns false, leaving the filter untouched, if the snapshot isn't one this version can read */
+    bool restoreState(const Snapshot& snapshot);
+    
+    /** Matches another filter's engine, sample rate and component values. The state is left alone */
+    void copySettingsFrom(const RCA_MK2_SEF& other);
+
+    void setOutputImpedance(float newZ)
+    {
+        auto next = components;
+        next.Rt = newZ;
+        setComponentValues(next);
     }
 
     void setInputImpedance(float newZ)
     {
-        if (inputImpedance != newZ)
+        auto next = components;
+        next.Rin = newZ;
+        setComponentValues(next);
+    }
+    
+    /**
+     * Sets every element of the ladder at once. The impedance tree is only
+     * recomputed if something actually changed, and then only once.
+     */
+    void setComponentValues(const LadderComponents& newComponents)
+    {
+        if (newComponents == components)
+            return;
+        
+        components = newComponents;
+        inputImpedance = components.Rin;
+        outputImpedance = components.Rt;
+        
+        if (usesFlatEquations())
+        {
+            updateFlatCoefficients();
+            return;
+        }
+        
+        // the R-type junction has its own scattering matrix and never reads the tree
+        if (engine == Engine::rtype)
         {
-            inputImpedance = newZ;
-            Rin.setResistanceValue(inputImpedance);
+            rtypeLadder.setComponentValues(components);
+            return;
         }
+        
+        updateTree();
     }
     
-    void setHighPassComponentValues(float C, float L)
+    /**
+     * As above, with the coefficients already resolved for these components at this
+     * filter's sample rate (see CoefficientCache). The flat engine takes them as they
+     * are, which makes a change no more than a copy; the others work them out again.
+     */
+    void setComponentValues(const LadderComponents& newComponents, const LadderCoefficients& resolved)
     {
-        C_HP1.setCapacitanceValue(C);
-        C_HP2.setCapacitanceValue(C);
-        L_HP1.setInductanceValue(L);
-
-        if (! highPassMod)
+        if (engine != Engine::flat)
         {
-            float wc = 1e-8f;
-            C = root2 / (k * wc);
-            L = k / (2.0f * root2 * wc);
+            setComponentValues(newComponents);
+            return;
         }
-        C_HPm1.setCapacitanceValue(C);
-        C_HPm2.setCapacitanceValue(C);
-        L_HPm.setInductanceValue(L);
         
+        components = newComponents;
+        inputImpedance = components.Rin;
+        outputImpedance = components.Rt;
+        flatCoefficients = resolved;
+    }
+    
+    /**
+     * Flat engine only: runs on coefficients worked out elsewhere (e.g. by a modulator,
+     * see RCA_EnvelopeModulation.h) while the component values, and everything derived
+     * from them, keep describing the unmodulated ladder. setComponentValues() with
+     * resolved coefficients goes back to it; the other setters only do if they change something.
+     */
+    void setFlatCoefficients(const LadderCoefficients& coefficients) noexcept
+    {
+        assert(engine == Engine::flat);
+        flatCoefficients = coefficients;
+    }
+    
+    void setHighPassComponentValues(float C, float L)
+    {
+        auto next = components;
+        next.setHighPass(C, L, highPassMod, k);
+        setComponentValues(next);
     }
 
     void setHighPassCutoff(float newCutoff)
     {
-        float wc = newCutoff * twoPi;
-        float C = root2 / (k * wc);
-        float L = k / (2.0f * root2 * wc);
+        auto next = components;
+        next.setHighPassCutoff(newCutoff, highPassMod, k);
+        setComponentValues(next);
         
-        setHighPassComponentValues(C, L);
         highPassCutoff = newCutoff;
     }
     
     void setHighPassKnobPos(int pos)
     {
-        jassert(pos <= HPVals.size() && pos >= 0);
-        const auto& values = HPVals[pos - 1];
+        assert(pos > 0 && pos <= (int) highPassKnobPositions.size());
+        const auto& values = getKnobTable(knobTable).highPass[(size_t) pos - 1];
         setHighPassComponentValues(values.C, values.L);
     }
     
@@ -123,38 +688,24 @@ public:
      **/
     void setLowPassComponentValues(float C, float L)
     {
-
-        C_LP1.setCapacitanceValue(C);
-        L_LP1.setInductanceValue(L);
-        L_LP2.setInductanceValue(L);
-        
-        if (! lowPassMod)
-        {
-            float wc = 1e8f;
-            C = (2.0f * root2) / (k * wc);
-            L = (root2 * k) / wc;
-        }
-
-        C_LPm1.setCapacitanceValue(C);
-        L_LPm1.setInductanceValue(L);
-        L_LPm2.setInductanceValue(L);
+        auto next = components;
+        next.setLowPass(C, L, lowPassMod, k);
+        setComponentValues(next);
     }
     
     void setLowPassCutoff(float newCutoff)
     {
-        float wc = newCutoff * twoPi;
-        float C = (2.0f * root2) / (k * wc);
-        float L = (root2 * k) / wc;
-
-        setLowPassComponentValues(C, L);
+        auto next = components;
+        next.setLowPassCutoff(newCutoff, lowPassMod, k);
+        setComponentValues(next);
         
         lowPassCutoff = newCutoff;
     }
     
     void setLowPassKnobPos(int pos)
     {
-        jassert(pos > 0 && pos <= LPVals.size());
-        const auto& values = LPVals[pos - 1];
+        assert(pos > 0 && pos <= (int) lowPassKnobPositions.size());
+        const auto& values = getKnobTable(knobTable).lowPass[(size_t) pos - 1];
         setLowPassComponentValues(values.C, values.L);
     }
 
@@ -184,62 +735,223 @@ public:
 
     inline float processSample (float x) noexcept
     {
+        if (engine == Engine::rtype)
+            return rtypeLadder.processSample(x);
+        
+        if (engine == Engine::flat)
+            return processLadderSample<float>([this](int i) -> float& { return flatState[(size_t) i]; },
+                                              [this](int i) { return flatCoefficients.series[(size_t) i]; },
+                                              [this](int i) { return flatCoefficients.parallel[(size_t) i - 1]; },
+                                              x);
+        
+        if (engine == Engine::alpha)
+            return processLadderSample<float>([this](int i) -> float& { return flatState[(size_t) i]; },
+                                              [this](int i) { return flatCoefficients.series[(size_t) i]; },
+                                              [this](int i) { return flatCoefficients.parallel[(size_t) i - 1]; },
+                                              x,
+                                              [this](int i, float a)
+                                              {
+                                                  const size_t section = i < 6 ? 0 : 1;
+                                                  auto& z = flatState[(size_t) i];
+                                                  z = alphaDecay[section] * z + alphaGain[section] * a;
+                                              });
+        
+        if (engine == Engine::generated)
+            return GeneratedLadder::processSample(generatedState, generatedCoefficients, x);
+        
+        if (engine == Engine::precise)
+            return (float) processLadderSample<double>([this](int i) -> double& { return preciseState[(size_t) i]; },
+                                                       [this](int i) { return preciseCoefficients.series[(size_t) i]; },
+                                                       [this](int i) { return preciseCoefficients.parallel[(size_t) i - 1]; },
+                                                       (double) x,
+                                                       [this](int i, double a)
+                                                       {
+                                                           const size_t section = i < 6 ? 0 : 1;
+                                                           auto& z = preciseState[(size_t) i];
+                                                           z = preciseDecay[section] * z + preciseGain[section] * a;
+                                                       });
+        
         Vs.setVoltage(x);
         Vs.incident(S0.reflected());
         S0.incident(Vs.reflected());
         return voltage<float>(Rt);
     }
     
-#define fftOrder 13
-#define fftSize 2 << fftOrder
+    /**
+     * Runs a unit impulse through the ladder from rest, leaving it reset afterwards.
+     * Take an FFT of this for the full response (see ResponseAnalyser).
+     */
+    void computeImpulseResponse(float* dest, int numSamples) noexcept;
     
-    void computeMagnitudeResponse(std::array<float, fftSize>& result) noexcept
-    {
-        
-        for (int i = 0 ; i < impulse.size(); ++i)
-            result[i] = processSample(impulse[i]);
-
-        fft.performFrequencyOnlyForwardTransform(result.data(), true);
-
-        reset();
-    }
+    /**
+     * Evaluates the magnitude response at arbitrary frequencies straight from the
+     * component values, without running the ladder. Cheap enough for a handful of points.
+     */
+    void computeMagnitudeResponse(const float* freqs, float* mags, int numPoints) const noexcept;
     
     /**
-     * Used for validating frequency response data in Python
+     * Used for validating frequency response data in Python. For every knob setting
+     * at once, see Tools/ResponseSweep.
      */
-    void saveResponseToCSV(const std::array<float, fftSize>& response, const std::string& filename)
-    {
-        
-        std::ofstream file;
-
-        file.open(filename);
-
-        for (auto it = response.begin(); it != response.end(); ++it)
-          {
-              file << *it;
-
-              if (std::next(it) != response.end())
-                  file << ",";
-          }
-        
-        file.close();
-        std::cout << "Data saved to " + filename << std::endl;
-    }
+    static void saveResponseToCSV(const float* response, int numPoints, const std::string& filename);
 
     
+    float getSampleRate() const {return fs;}
     float getHighPassCutoff() {return highPassCutoff;}
     float getLowPassCutoff() {return lowPassCutoff;}
+    
+    const LadderComponents& getComponentValues() const {return components;}
+    
+    /** The hardware's knob positions: nominal cutoff in Hz and the C and L it switches in */
+    struct KnobPosition
+    {
+        int cutoff;
+        float C;
+        float L;
+        
+        bool operator==(const KnobPosition& other) const {return cutoff == other.cutoff && C == other.C && L == other.L;}
+    };
+    
+    static const std::array<KnobPosition, 11> highPassKnobPositions;
+    static const std::array<KnobPosition, 11> lowPassKnobPositions;
+    
+    /** Both knobs' positions, e.g. fitted to a particular unit by Tools/ComponentFit */
+    struct KnobTable
+    {
+        std::array<KnobPosition, 11> highPass = highPassKnobPositions;
+        std::array<KnobPosition, 11> lowPass = lowPassKnobPositions;
+        
+        bool operator==(const KnobTable& other) const {return highPass == other.highPass && lowPass == other.lowPass;}
+    };
+    
+    /**
+     * Table 0 is the built-in one above. Added tables are kept until the process exits, so
+     * an id never comes to mean a different table, and CoefficientCache can key on it.
+     * Lookups are lock-free; adding allocates, so keep it off the audio thread.
+     */
+    static constexpr int maxKnobTables = 64;
+    static const KnobTable& getKnobTable(int id) noexcept;
+    
+    /** The id of the table, reusing an identical one already added, or -1 once maxKnobTables are in use */
+    static int addKnobTable(const KnobTable& table);
+    
+    /**
+     * One position per line, "hp" or "lp", the position (1-11), the nominal cutoff in Hz, then C and L.
+     * Anything after those, and lines starting with '#', are ignored. Positions left out keep the built-in values.
+     */
+    static bool parseKnobTable(const std::string& text, KnobTable& table, std::string& error);
+    static std::string writeKnobTable(const KnobTable& table, const std::string& comment = {});
+    
+    /** Which table setHighPassKnobPos() and setLowPassKnobPos() read; takes effect at the next call */
+    void setKnobTable(int id) {knobTable = id;}
+    int getKnobTableId() const {return knobTable;}
    
     
 private:
     
-    juce::dsp::FFT fft {fftOrder};
+    void updateTree()
+    {
+        // All the wdft types are final, so this recompute chain is resolved at compile time,
+        // rather than every setter walking the parent pointers up to S0 through virtual calls.
+        ScopedDeferImpedancePropagation deferImpedance { Rin, C_HPm1, L_HPm, C_HPm2, C_HP1, L_HP1, C_HP2,
+                                                         L_LP1, C_LP1, L_LP2, L_LPm1, C_LPm1, L_LPm2, Rt,
+                                                         S8, P4, S7, S6, P3, S5, S4, P2, S3, S2, P1, S1, S0 };
+        
+        Rin.setResistanceValue(components.Rin);
+        C_HPm1.setCapacitanceValue(components.C_HPm1);
+        L_HPm.setInductanceValue(components.L_HPm);
+        C_HPm2.setCapacitanceValue(components.C_HPm2);
+        C_HP1.setCapacitanceValue(components.C_HP1);
+        L_HP1.setInductanceValue(components.L_HP1);
+        C_HP2.setCapacitanceValue(components.C_HP2);
+        L_LP1.setInductanceValue(components.L_LP1);
+        C_LP1.setCapacitanceValue(components.C_LP1);
+        L_LP2.setInductanceValue(components.L_LP2);
+        L_LPm1.setInductanceValue(components.L_LPm1);
+        C_LPm1.setCapacitanceValue(components.C_LPm1);
+        L_LPm2.setInductanceValue(components.L_LPm2);
+        Rt.setResistanceValue(components.Rt);
+    }
     
-    float i = juce::Decibels::decibelsToGain(1e-12);
-    const std::array<float, fftSize> impulse = {i};
-
-    const float root2 = juce::MathConstants<float>::sqrt2;
-    const float twoPi = juce::MathConstants<float>::twoPi;
+    /** The engines that leave the tree alone and run on coefficients of their own */
+    bool usesFlatEquations() const
+    {
+        return engine == Engine::flat || engine == Engine::alpha || engine == Engine::generated || engine == Engine::precise;
+    }
+    
+    void updateFlatCoefficients()
+    {
+        if (engine == Engine::flat)
+            flatCoefficients = LadderCoefficients::fromComponents(components, fs);
+        
+        if (engine == Engine::alpha)
+        {
+            const auto warped = AlphaPrewarp::apply(components, fs);
+            flatCoefficients = LadderCoefficients::fromComponents(warped.components, fs, warped.highPassAlpha, warped.lowPassAlpha);
+            
+            // CapacitorAlphaT reflects b = (1 - alpha) / 2 * b[-1] + (1 + alpha) / 2 * a[-1], InductorAlphaT the same with -a[-1]
+            const float alphas[] = {warped.highPassAlpha, warped.lowPassAlpha};
+            
+            for (size_t section = 0; section < 2; ++section)
+            {
+                alphaDecay[section] = (1.f - alphas[section]) * 0.5f;
+                alphaGain[section] = (1.f + alphas[section]) * 0.5f;
+            }
+        }
+        
+        if (engine == Engine::precise)
+        {
+            // the component values themselves stay as they were set, in float
+            const auto warped = AlphaPrewarp::apply(components.convertTo<double>(), (double) fs);
+            preciseCoefficients = LadderCoefficientsT<double>::fromComponents(warped.components, (double) fs,
+                                                                               (double) warped.highPassAlpha,
+                                                                               (double) warped.lowPassAlpha);
+            
+            const double alphas[] = {warped.highPassAlpha, warped.lowPassAlpha};
+            
+            for (size_t section = 0; section < 2; ++section)
+            {
+                preciseDecay[section] = (1.0 - alphas[section]) * 0.5;
+                preciseGain[section] = (1.0 + alphas[section]) * 0.5;
+            }
+        }
+        
+        if (engine == Engine::generated)
+        {
+            // the generated values carry the same element names as the components
+            std::array<float, numStates> reactive;
+            forEachReactive(components, [&](float value, int index) { reactive[(size_t) index] = value; });
+            
+            GeneratedLadder::Values values;
+            forEachReactive(values, [&](float& value, int index) { value = reactive[(size_t) index]; });
+            values.Rin = components.Rin;
+            values.Rt = components.Rt;
+            
+            generatedCoefficients = GeneratedLadder::computeCoefficients(values, fs);
+        }
+    }
+    
+    /**
+     * Calls callback(element, index) for each reactive element of the tree, in State order.
+     * Works just as well on anything else with the same member names: LadderComponents, and
+     * GeneratedLadder's Values and State.
+     */
+    template <typename Self, typename Callback>
+    static void forEachReactive(Self& self, Callback&& callback)
+    {
+        callback(self.C_HPm1, 0);
+        callback(self.L_HPm, 1);
+        callback(self.C_HPm2, 2);
+        callback(self.C_HP1, 3);
+        callback(self.L_HP1, 4);
+        callback(self.C_HP2, 5);
+        callback(self.L_LP1, 6);
+        callback(self.C_LP1, 7);
+        callback(self.L_LP2, 8);
+        callback(self.L_LPm1, 9);
+        callback(self.C_LPm1, 10);
+        callback(self.L_LPm2, 11);
+    }
     
     int highPassMod = 1;
     int lowPassMod = 1;
@@ -253,6 +965,24 @@ private:
     float k = 560.0f;
 
     float fs = 48000;
+    
+    int knobTable = 0;
+    
+    LadderComponents components;
+    
+    Engine engine = Engine::wdfTree;
+    RtypeLadder<float> rtypeLadder;
+    
+    State flatState {};
+    LadderCoefficients flatCoefficients;
+    std::array<float, 2> alphaDecay {}, alphaGain {};    // HP, LP section
+    
+    std::array<double, numStates> preciseState {};
+    LadderCoefficientsT<double> preciseCoefficients;
+    std::array<double, 2> preciseDecay {}, preciseGain {};
+    
+    GeneratedLadder::State generatedState;
+    GeneratedLadder::Coefficients generatedCoefficients;
         
     ResistorT<float> Rt {outputImpedance};
     InductorT<float> L_LPm2 {1.0e-3f, double (48000)};
@@ -296,74 +1026,6 @@ private:
     WDFSeriesT<float, decltype(Rin), decltype(S1)> S0 {Rin, S1};
     IdealVoltageSourceT<float, decltype(S0)> Vs {S0};
     
-    struct ComponentValues
-    {
-        float C;
-        float L;
-    };
-
-    std::vector<ComponentValues> HPVals =
-    {
-        {99999, 99999},
-        {1.6e-6, 255.6e-3},
-        {1.15e-6, 176.9e-3},
-        {0.8e-6, 126.4e-3},
-        {0.57e-6, 90.11e-3},
-        {0.4e-6, 63.9e-3},
-        {0.272e-6, 44.56e-3},
-        {0.2e-6, 31.79e-3},
-        {0.15e-6, 21.77e-3},
-        {0.1e-6, 15.63e-3},
-        {0.069e-6, 11.18e-3}
-    };
-    
-    std::vector<ComponentValues> LPVals =
-    {
-        {3.22e-6, 511.1e-3},
-        {2.3e-6, 365.2e-3},
-        {1.6e-6, 255.6e-3},
-        {1.15e-6, 178.6e-3},
-        {0.8e-6, 126.4e-3},
-        {0.57e-6, 90.02e-3},
-        {0.4e-6, 63.54e-3},
-        {0.272e-6, 45.08e-3},
-        {0.2e-6, 32.13e-3},
-        {0.15e-6, 22.38e-3},
-        {1e-10, 1e-10}
-    };
-    
-    /** {fc : {C, L}} */
-    
-    std::map<int, ComponentValues> HP_map =
-    {
-        {0, {99999, 99999}},
-        {175, {1.6e-6, 255.6e-3}},
-        {248, {1.15e-6, 176.9e-3}},
-        {352, {0.8e-6, 126.4e-3}},
-        {497, {0.57e-6, 90.11e-3}},
-        {699, {0.4e-6, 63.9e-3}},
-        {1002, {0.272e-6, 44.56e-3}},
-        {1411, {0.2e-6, 31.79e-3}},
-        {2024, {0.15e-6, 21.77e-3}},
-        {2847, {0.1e-6, 15.63e-3}},
-        {3994, {0.069e-6, 11.18e-3}}
-    };
-    
-    std::map<int, ComponentValues> LP_map =
-    {
-        {175, {3.22e-6, 511.1e-3}},
-        {245, {2.3e-6, 365.2e-3}},
-        {350, {1.6e-6, 255.6e-3}},
-        {499, {1.15e-6, 178.6e-3}},
-        {703, {0.8e-6, 126.4e-3}},
-        {996, {0.57e-6, 90.02e-3}},
-        {1408, {0.4e-6, 63.54e-3}},
-        {1989, {0.272e-6, 45.08e-3}},
-        {2803, {0.2e-6, 32.13e-3}},
-        {3992, {0.15e-6, 22.38e-3}},
-        {999999, {1e-10, 1e-10}}
-    };
-    
 };
 
-
+static_assert(std::is_trivially_copyable<RCA_MK2_SEF::Snapshot>::value, "snapshots are sent around as raw bytes");
@@ -0,0 +1,604 @@
+/*
+  ==============================================================================
+
+    RCA_OfflineRender.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Multi-core rendering of long files through a single RCA_MK2_SEF.
+
+    renderParallel() is exact. The ladder is linear, so its output is the zero-state response of each
+    chunk plus the decaying response to the state the chunk really starts in.
+    Every chunk is run from zero state on its own thread. The true start states
+    are then carried across the chunk boundaries with powers of the discrete
+    state-space matrix A, and each chunk adds C A^n s_k until it dies away.
+
+    renderSegmented() is the simple version: every segment gets its own filter,
+    warmed up on the samples before it, with the warm-up long enough that the
+    impulse response tail it misses stays under a given error. Settings whose
+    response takes longer than maxPreRollLength to die away go to renderParallel().
+
+    renderCheckpointed() hands a stream to a LocalRenderFarm one chunk at a
+    time, passing only a serialised RCA_MK2_SEF::Snapshot between chunks. The
+    result is bit-identical to an uninterrupted run.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RCA_MKII_SEF.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace OfflineRender
+{
+    /** x[n+1] = A x[n] + B u[n],  y[n] = C x[n] + D u[n], with x the filter's State */
+    struct StateSpace
+    {
+        static constexpr int order = RCA_MK2_SEF::numStates;
+
+        using Vector = std::array<double, order>;
+        using Matrix = std::array<Vector, order>;   // row major
+
+        Matrix A {};
+        Vector B {};
+        Vector C {};
+        double D = 0.0;
+
+        /** Probes a copy of the filter one state at a time. The filter itself is left untouched */
+        static StateSpace fromFilter (const RCA_MK2_SEF& filter)
+        {
+            StateSpace ss;
+
+            auto probe = std::make_unique<RCA_MK2_SEF>();
+            probe->copySettingsFrom (filter);
+
+            for (int j = 0; j < order; ++j)
+            {
+                RCA_MK2_SEF::State unit {};
+                unit[(size_t) j] = 1.f;
+
+                probe->setState (unit);
+                ss.C[(size_t) j] = probe->processSample (0.f);
+
+                const auto next = probe->getState();
+                for (int i = 0; i < order; ++i)
+                    ss.A[(size_t) i][(size_t) j] = next[(size_t) i];
+            }
+
+            probe->setState ({});
+            ss.D = probe->processSample (1.f);
+
+            const auto next = probe->getState();
+            for (int i = 0; i < order; ++i)
+                ss.B[(size_t) i] = next[(size_t) i];
+
+            return ss;
+        }
+
+        static Vector multiply (const Matrix& m, const Vector& v) noexcept
+        {
+            Vector result {};
+
+            for (int i = 0; i < order; ++i)
+                for (int j = 0; j < order; ++j)
+                    result[(size_t) i] += m[(size_t) i][(size_t) j] * v[(size_t) j];
+
+            return result;
+        }
+
+        static Matrix multiply (const Matrix& a, const Matrix& b) noexcept
+        {
+            Matrix result {};
+
+            for (int i = 0; i < order; ++i)
+                for (int k = 0; k < order; ++k)
+                    for (int j = 0; j < order; ++j)
+                        result[(size_t) i][(size_t) j] += a[(size_t) i][(size_t) k] * b[(size_t) k][(size_t) j];
+
+            return result;
+        }
+
+        /** A^n by repeated squaring */
+        Matrix power (int64_t n) const noexcept
+        {
+            Matrix result {};
+            for (int i = 0; i < order; ++i)
+                result[(size_t) i][(size_t) i] = 1.0;
+
+            auto square = A;
+
+            for (; n > 0; n >>= 1)
+            {
+                if (n & 1)
+                    result = multiply (result, square);
+
+                square = multiply (square, square);
+            }
+
+            return result;
+        }
+    };
+
+    /** Chunks shorter than this aren't worth a thread */
+    constexpr int64_t minChunkSize = 1 << 15;
+
+    /** Runs job(0 .. numJobs - 1), one per thread, with job 0 on the calling thread */
+    template <typename Job>
+    void runOnThreads (int numJobs, const Job& job)
+    {
+        std::vector<std::thread> threads;
+
+        for (int k = 1; k < numJobs; ++k)
+            threads.emplace_back (std::cref (job), k);
+
+        job (0);
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+    inline int getNumChunks (int64_t numSamples, int numThreads)
+    {
+        if (numThreads <= 0)
+            numThreads = (int) std::max (1u, std::thread::hardware_concurrency());
+
+        return (int) std::max<int64_t> (1, std::min<int64_t> (numThreads, numSamples / minChunkSize));
+    }
+
+    /**
+     * Processes numSamples exactly as a run of filter.processSample() would, to within
+     * float rounding, spread over numThreads cores (0 = one per core). The filter is
+     * left in the state it would be in after the serial run. input and output may alias.
+     */
+    inline void renderParallel (RCA_MK2_SEF& filter, const float* input, float* output,
+                                int64_t numSamples, int numThreads = 0)
+    {
+        const auto numChunks = getNumChunks (numSamples, numThreads);
+
+        if (numChunks == 1)
+        {
+            for (int64_t n = 0; n < numSamples; ++n)
+                output[n] = filter.processSample (input[n]);
+
+            return;
+        }
+
+        const auto chunkSize = (numSamples + numChunks - 1) / numChunks;
+        auto chunkStart  = [&] (int k) { return int64_t (k) * chunkSize; };
+        auto chunkLength = [&] (int k) { return std::min (chunkSize, numSamples - chunkStart (k)); };
+
+        const auto ss = StateSpace::fromFilter (filter);
+        const auto initialState = filter.getExactState();
+
+        // 1. zero-state response of every chunk; chunk 0 starts from the real state, so it's already exact
+        std::vector<RCA_MK2_SEF::ExactState> endStates ((size_t) numChunks);
+
+        runOnThreads (numChunks, [&] (int k)
+        {
+            auto chunkFilter = std::make_unique<RCA_MK2_SEF>();
+            chunkFilter->copySettingsFrom (filter);
+            chunkFilter->setExactState (k == 0 ? initialState : RCA_MK2_SEF::ExactState {});
+
+            const auto start = chunkStart (k);
+            const auto length = chunkLength (k);
+
+            for (int64_t n = start; n < start + length; ++n)
+                output[n] = chunkFilter->processSample (input[n]);
+
+            endStates[(size_t) k] = chunkFilter->getExactState();
+        });
+
+        // 2. carry the true states across the boundaries: s[k+1] = A^L s[k] + e[k].
+        //    There are only as many chunks as cores, so a serial scan costs next to nothing.
+        const auto stepFull = ss.power (chunkSize);
+
+        std::vector<StateSpace::Vector> startStates ((size_t) numChunks + 1);
+
+        startStates[1] = endStates[0];
+
+        for (int k = 1; k < numChunks; ++k)
+        {
+            const auto& step = chunkLength (k) == chunkSize ? stepFull : ss.power (chunkLength (k));
+            auto next = StateSpace::multiply (step, startStates[(size_t) k]);
+
+            for (int i = 0; i < StateSpace::order; ++i)
+                next[(size_t) i] += endStates[(size_t) k][(size_t) i];
+
+            startStates[(size_t) k + 1] = next;
+        }
+
+        // 3. add each chunk's response to its start state, until it has decayed below float resolution
+        runOnThreads (numChunks, [&] (int k)
+        {
+            if (k == 0)
+                return;
+
+            auto x = startStates[(size_t) k];
+            const auto start = chunkStart (k);
+            const auto length = chunkLength (k);
+
+            for (int64_t n = 0; n < length; ++n)
+            {
+                double y = 0.0, energy = 0.0;
+
+                for (int i = 0; i < StateSpace::order; ++i)
+                {
+                    y += ss.C[(size_t) i] * x[(size_t) i];
+                    energy += x[(size_t) i] * x[(size_t) i];
+                }
+
+                // the ladder is passive, so once the state is this small it stays small
+                if (energy < 1.0e-24)
+                    break;
+
+                output[start + n] += (float) y;
+                x = StateSpace::multiply (ss.A, x);
+            }
+        });
+
+        filter.setExactState (startStates[(size_t) numChunks]);
+    }
+
+    /** Longest pre-roll renderSegmented() will use before it hands the render to renderParallel() */
+    constexpr int64_t maxPreRollLength = 1 << 18;
+
+    struct PreRoll
+    {
+        int64_t length = 0;
+
+        /** sum |h[m]| over m > length, up to the history searched */
+        double missingTail = 0.0;
+
+        bool isWithinLimit = false;
+    };
+
+    /**
+     * Shortest pre-roll that leaves out at most threshold of sum |h[m]| over the first
+     * historyLength samples of the impulse response, or isWithinLimit = false if that's
+     * longer than maxLength. |h| is summed a block at a time from the state-space form,
+     * h[n + k] = C A^k x[n], so nothing is kept per sample. The sum stops early once the
+     * state has died away or settles, and as soon as the tail past maxLength is too big.
+     */
+    inline PreRoll findPreRoll (const RCA_MK2_SEF& filter, int64_t maxLength, int64_t historyLength, double threshold)
+    {
+        constexpr int blockLength = 1024;
+        using Vector = StateSpace::Vector;
+
+        const auto ss = StateSpace::fromFilter (filter);
+        const auto step = ss.power (blockLength);
+
+        auto dot = [] (const Vector& a, const Vector& b)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < StateSpace::order; ++i)
+                sum += a[(size_t) i] * b[(size_t) i];
+
+            return sum;
+        };
+
+        // rows[k] = C A^k
+        std::vector<Vector> rows ((size_t) blockLength);
+        rows[0] = ss.C;
+
+        for (size_t k = 1; k < rows.size(); ++k)
+            for (int i = 0; i < StateSpace::order; ++i)
+                for (int j = 0; j < StateSpace::order; ++j)
+                    rows[k][(size_t) j] += rows[k - 1][(size_t) i] * ss.A[(size_t) i][(size_t) j];
+
+        auto sumBlock = [&] (const Vector& x)
+        {
+            double sum = 0.0;
+            for (const auto& row : rows)
+                sum += std::abs (dot (row, x));
+
+            return sum;
+        };
+
+        // block j holds h[1 + j L] .. h[(j + 1) L], starting from x[1] = B
+        const auto numBlocks = (historyLength + blockLength - 1) / blockLength;
+        const auto firstBlockPastLimit = maxLength / blockLength + 1;
+
+        std::vector<double> blockSums;
+        double settledTail = 0.0, pastLimit = 0.0;
+        auto x = ss.B;
+
+        PreRoll result;
+
+        for (int64_t j = 0; j < numBlocks; ++j)
+        {
+            blockSums.push_back (sumBlock (x));
+
+            if (j >= firstBlockPastLimit && (pastLimit += blockSums.back()) > threshold)
+                return result;
+
+            const auto next = StateSpace::multiply (step, x);
+
+            double size = 0.0, change = 0.0;
+            for (int i = 0; i < StateSpace::order; ++i)
+            {
+                size += x[(size_t) i] * x[(size_t) i];
+                change += (next[(size_t) i] - x[(size_t) i]) * (next[(size_t) i] - x[(size_t) i]);
+            }
+
+            if (size < 1.0e-30)
+                break;
+
+            // a state that A^L leaves where it is repeats this block's sum for the rest of the history
+            if (change <= 1.0e-18 * size)
+            {
+                settledTail = blockSums.back() * double (numBlocks - j - 1);
+                break;
+            }
+
+            x = next;
+        }
+
+        // walk back from the end to the block the pre-roll ends in, then through it a sample at a time
+        auto tail = settledTail;
+        auto j = (int64_t) blockSums.size() - 1;
+
+        while (j >= 0 && tail + blockSums[(size_t) j] <= threshold)
+            tail += blockSums[(size_t) j--];
+
+        if (j >= 0)
+        {
+            const auto start = StateSpace::multiply (ss.power (j * blockLength), ss.B);
+            int k = blockLength - 1;
+
+            while (k > 0 && tail + std::abs (dot (rows[(size_t) k], start)) <= threshold)
+                tail += std::abs (dot (rows[(size_t) k--], start));
+
+            result.length = 1 + j * blockLength + k;
+        }
+
+        result.missingTail = tail;
+        result.isWithinLimit = result.length <= maxLength;
+        return result;
+    }
+
+    struct SegmentedRenderResult
+    {
+        int64_t preRollLength = 0;
+
+        /**
+         * Bound on how far the stitching takes the output from a serial render, in dB
+         * relative to full scale. Float rounding adds its own ~-110 dB on top of this.
+         */
+        double worstCaseErrorDb = -300.0;
+
+        /** The response outlasted maxPreRollLength, so the render went to renderParallel() instead */
+        bool usedParallelRender = false;
+    };
+
+    /**
+     * Renders each segment on its own filter, pre-rolled over the preRollLength samples
+     * before it. Leaving out everything older than the pre-roll changes a sample by at most
+     * peak |input| * sum |h[m]| over m > preRollLength, so preRollLength is the shortest
+     * one that keeps that below maxErrorDb. The achieved bound is returned. Settings that
+     * would need more than maxPreRollLength (or a whole segment) of it are rendered with
+     * renderParallel() instead.
+     *
+     * Unlike renderParallel() the input is read on either side of each segment boundary,
+     * so input and output must not alias.
+     */
+    inline SegmentedRenderResult renderSegmented (RCA_MK2_SEF& filter, const float* input, float* output,
+                                                  int64_t numSamples, double maxErrorDb = -120.0, int numThreads = 0)
+    {
+        SegmentedRenderResult result;
+
+        float peak = 0.f;
+        for (int64_t n = 0; n < numSamples; ++n)
+            peak = std::max (peak, std::abs (input[n]));
+
+        const auto numChunks = getNumChunks (numSamples, numThreads);
+
+        if (numChunks == 1 || peak == 0.f)
+        {
+            for (int64_t n = 0; n < numSamples; ++n)
+                output[n] = filter.processSample (input[n]);
+
+            return result;
+        }
+
+        const auto chunkSize = (numSamples + numChunks - 1) / numChunks;
+        const auto maxError = std::pow (10.0, maxErrorDb / 20.0) / peak;
+
+        // a pre-roll as long as a segment does the serial work twice over, which renderParallel() never does
+        const auto found = findPreRoll (filter, std::min (chunkSize, maxPreRollLength), numSamples, maxError);
+
+        if (! found.isWithinLimit)
+        {
+            renderParallel (filter, input, output, numSamples, numThreads);
+            result.usedParallelRender = true;
+            return result;
+        }
+
+        const auto preRoll = found.length;
+        result.preRollLength = preRoll;
+        const auto initialState = filter.getExactState();
+
+        std::vector<RCA_MK2_SEF::ExactState> endStates ((size_t) numChunks);
+
+        runOnThreads (numChunks, [&] (int k)
+        {
+            auto chunkFilter = std::make_unique<RCA_MK2_SEF>();
+            chunkFilter->copySettingsFrom (filter);
+
+            const auto start = int64_t (k) * chunkSize;
+            const auto end = std::min (start + chunkSize, numSamples);
+
+            // a pre-roll reaching back to the start of the file makes this segment exact
+            auto preRollStart = start - preRoll;
+
+            if (preRollStart <= 0)
+            {
+                preRollStart = 0;
+                chunkFilter->setExactState (initialState);
+            }
+
+            for (auto n = preRollStart; n < start; ++n)
+                chunkFilter->processSample (input[n]);
+
+            for (auto n = start; n < end; ++n)
+                output[n] = chunkFilter->processSample (input[n]);
+
+            endStates[(size_t) k] = chunkFilter->getExactState();
+        });
+
+        filter.setExactState (endStates.back());
+
+        const auto bound = double (peak) * found.missingTail;
+
+        if (preRoll < int64_t (numChunks - 1) * chunkSize && bound > 0.0)
+            result.worstCaseErrorDb = 20.0 * std::log10 (bound);
+
+        return result;
+    }
+
+    //==============================================================================
+    using SnapshotBytes = std::array<char, sizeof (RCA_MK2_SEF::Snapshot)>;
+
+    inline SnapshotBytes toBytes (const RCA_MK2_SEF::Snapshot& snapshot)
+    {
+        SnapshotBytes bytes;
+        std::memcpy (bytes.data(), &snapshot, sizeof (snapshot));
+        return bytes;
+    }
+
+    inline RCA_MK2_SEF::Snapshot fromBytes (const SnapshotBytes& bytes)
+    {
+        RCA_MK2_SEF::Snapshot snapshot;
+        std::memcpy (&snapshot, bytes.data(), sizeof (snapshot));
+        return snapshot;
+    }
+
+    /**
+     * Local stand-in for a pool of render worker processes. Each worker owns one filter,
+     * and a job only gets the snapshot bytes it is sent and its own samples, just as a
+     * remote worker would. It replies with the bytes of the snapshot it ended on.
+     */
+    class LocalRenderFarm
+    {
+    public:
+        explicit LocalRenderFarm (int numWorkers = 0)
+        {
+            if (numWorkers <= 0)
+                numWorkers = (int) std::max (1u, std::thread::hardware_concurrency());
+
+            for (int i = 0; i < numWorkers; ++i)
+                workers.emplace_back ([this] { runWorker(); });
+        }
+
+        ~LocalRenderFarm()
+        {
+            {
+                const std::lock_guard<std::mutex> lock (jobLock);
+                shouldQuit = true;
+            }
+
+            jobAvailable.notify_all();
+
+            for (auto& worker : workers)
+                worker.join();
+        }
+
+        LocalRenderFarm (const LocalRenderFarm&) = delete;
+        LocalRenderFarm& operator= (const LocalRenderFarm&) = delete;
+
+        /** The future throws if a worker couldn't read the snapshot */
+        std::future<SnapshotBytes> submit (const SnapshotBytes& start, const float* input, float* output, int64_t numSamples)
+        {
+            Job job { start, input, output, numSamples, {} };
+            auto result = job.done.get_future();
+
+            {
+                const std::lock_guard<std::mutex> lock (jobLock);
+                jobs.push_back (std::move (job));
+            }
+
+            jobAvailable.notify_one();
+            return result;
+        }
+
+    private:
+        struct Job
+        {
+            SnapshotBytes start;
+            const float* input;
+            float* output;
+            int64_t numSamples;
+            std::promise<SnapshotBytes> done;
+        };
+
+        void runWorker()
+        {
+            auto filter = std::make_unique<RCA_MK2_SEF>();
+
+            for (;;)
+            {
+                Job job;
+
+                {
+                    std::unique_lock<std::mutex> lock (jobLock);
+                    jobAvailable.wait (lock, [this] { return shouldQuit || ! jobs.empty(); });
+
+                    if (jobs.empty())
+                        return;
+
+                    job = std::move (jobs.front());
+                    jobs.pop_front();
+                }
+
+                if (! filter->restoreState (fromBytes (job.start)))
+                {
+                    job.done.set_exception (std::make_exception_ptr (std::runtime_error ("unreadable filter snapshot")));
+                    continue;
+                }
+
+                for (int64_t n = 0; n < job.numSamples; ++n)
+                    job.output[n] = filter->processSample (job.input[n]);
+
+                job.done.set_value (toBytes (filter->saveState()));
+            }
+        }
+
+        std::vector<std::thread> workers;
+
+        std::mutex jobLock;
+        std::condition_variable jobAvailable;
+        std::deque<Job> jobs;
+        bool shouldQuit = false;
+    };
+
+    /**
+     * Renders one stream on the farm in chunks of chunkSize, carrying the snapshot from
+     * each chunk to the next. A stream's chunks depend on each other, so they run in turn;
+     * the farm keeps its cores busy when several streams (channels, files) are in flight.
+     * filter supplies the settings and start state, and is left where the stream ends.
+     */
+    inline void renderCheckpointed (RCA_MK2_SEF& filter, const float* input, float* output,
+                                    int64_t numSamples, int64_t chunkSize, LocalRenderFarm& farm)
+    {
+        auto checkpoint = toBytes (filter.saveState());
+
+        for (int64_t start = 0; start < numSamples; start += chunkSize)
+        {
+            const auto length = std::min (chunkSize, numSamples - start);
+            checkpoint = farm.submit (checkpoint, input + start, output + start, length).get();
+        }
+
+        filter.restoreState (fromBytes (checkpoint));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,351 @@
+/*
+  ==============================================================================
+
+    RCA_RtypeLadder.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    The RCA ladder with every series/parallel connection collapsed into one
+    R-type scattering junction. The source, the twelve reactive elements and
+    the load all hang directly off the root, so each sample is one 14x14
+    mat-vec instead of seventeen nested adaptor calls.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "chowdsp_wdf.h"
+#include <array>
+
+
+using namespace chowdsp::wdft;
+
+
+namespace RtypeLadderDetail
+{
+    constexpr int numPorts = 14;
+    constexpr int numLoops = 5;
+
+    /**
+     * Fundamental loop matrix of the ladder, one row per mesh, one column per port.
+     * Port order: Vin, C_HPm1, L_HPm, C_HPm2, C_HP1, L_HP1, C_HP2,
+     *             L_LP1, C_LP1, L_LP2, L_LPm1, C_LPm1, L_LPm2, Rt
+     */
+    constexpr int loops[numLoops][numPorts] =
+    {
+        {  1, 1, 1, 0, 0,  0, 0, 0,  0, 0, 0,  0, 0, 0 },
+        {  0, 0,-1, 1, 1,  1, 0, 0,  0, 0, 0,  0, 0, 0 },
+        {  0, 0, 0, 0, 0, -1, 1, 1,  1, 0, 0,  0, 0, 0 },
+        {  0, 0, 0, 0, 0,  0, 0, 0, -1, 1, 1,  1, 0, 0 },
+        {  0, 0, 0, 0, 0,  0, 0, 0,  0, 0, 0, -1, 1, 1 },
+    };
+
+    /**
+     * The loops a port is in, at most two as neighbouring meshes share one branch, and its
+     * direction in each. A port in only one loop has a second entry with sign 0, so every
+     * loop over these has a fixed trip count.
+     */
+    struct PortLoops
+    {
+        int loop[2] {};
+        double sign[2] {};
+    };
+
+    constexpr std::array<PortLoops, numPorts> makePortLoops()
+    {
+        std::array<PortLoops, numPorts> ports {};
+
+        for (int p = 0; p < numPorts; ++p)
+        {
+            int count = 0;
+
+            for (int i = 0; i < numLoops; ++i)
+            {
+                if (loops[i][p] != 0)
+                {
+                    ports[(size_t) p].loop[count] = i;
+                    ports[(size_t) p].sign[count] = loops[i][p];
+                    ++count;
+                }
+            }
+        }
+
+        return ports;
+    }
+
+    constexpr auto portLoops = makePortLoops();
+
+    /**
+     * Scattering matrix of a junction whose ports obey B v = 0 and i = B^T l:
+     * S = I - 2 R B^T (B R B^T)^-1 B
+     *
+     * B is mostly zeros, so only its nonzero entries are visited: each column has
+     * at most two, so Z = B R B^T, W = Z^-1 B and B^T W each take two terms an entry.
+     */
+    struct ScatteringMatrix
+    {
+        template <typename RType>
+        static void calcImpedance (RType& rtype)
+        {
+            using T = std::remove_reference_t<decltype (rtype.getPortImpedances()[0])>;
+            const auto R = rtype.getPortImpedances();
+
+            // Z = B R B^T (5x5, symmetric positive definite)
+            double Z[numLoops][numLoops] {};
+            for (int p = 0; p < numPorts; ++p)
+            {
+                const auto& port = portLoops[(size_t) p];
+
+                for (int a = 0; a < 2; ++a)
+                    for (int b = 0; b < 2; ++b)
+                        Z[port.loop[a]][port.loop[b]] += port.sign[a] * port.sign[b] * double (R[(size_t) p]);
+            }
+
+            // Z^-1, by Gauss-Jordan elimination on [Z | I]
+            double Zinv[numLoops][numLoops] {};
+            for (int i = 0; i < numLoops; ++i)
+                Zinv[i][i] = 1.0;
+
+            for (int col = 0; col < numLoops; ++col)
+            {
+                const double pivot = 1.0 / Z[col][col];
+
+                for (int k = 0; k < numLoops; ++k)
+                {
+                    Z[col][k] *= pivot;
+                    Zinv[col][k] *= pivot;
+                }
+
+                for (int row = 0; row < numLoops; ++row)
+                {
+                    if (row == col)
+                        continue;
+
+                    const double factor = Z[row][col];
+                    for (int k = 0; k < numLoops; ++k)
+                    {
+                        Z[row][k] -= factor * Z[col][k];
+                        Zinv[row][k] -= factor * Zinv[col][k];
+                    }
+                }
+            }
+
+            // W = Z^-1 B
+            double W[numLoops][numPorts];
+            for (int k = 0; k < numLoops; ++k)
+            {
+                for (int j = 0; j < numPorts; ++j)
+                {
+                    const auto& port = portLoops[(size_t) j];
+                    W[k][j] = port.sign[0] * Zinv[k][port.loop[0]] + port.sign[1] * Zinv[k][port.loop[1]];
+                }
+            }
+
+            T S[numPorts][numPorts];
+            for (int i = 0; i < numPorts; ++i)
+            {
+                const auto& port = portLoops[(size_t) i];
+                const double twoR = 2.0 * double (R[(size_t) i]);
+
+                for (int j = 0; j < numPorts; ++j)
+                {
+                    const double BtW = port.sign[0] * W[port.loop[0]][j] + port.sign[1] * W[port.loop[1]][j];
+                    S[i][j] = T ((i == j ? 1.0 : 0.0) - twoR * BtW);
+                }
+            }
+
+            rtype.setSMatrixData (S);
+        }
+    };
+
+    /**
+     * Same as chowdsp's RootRtypeAdaptor, except compute() collects the reflected
+     * waves before scattering. RootRtypeAdaptor reads them after, which is fine for
+     * reactive ports but delays a source port's wave by one sample.
+     */
+    template <typename T, typename ImpedanceCalculator, typename... PortTypes>
+    class RootAdaptor : public RootWDF
+    {
+    public:
+        static constexpr auto numPorts = int (sizeof...(PortTypes));
+
+        explicit RootAdaptor (PortTypes&... dps) : downPorts (std::tie (dps...))
+        {
+            b_vec.clear();
+            a_vec.clear();
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t) { port.connectToParent (this); },
+                                          downPorts);
+        }
+
+        void calcImpedance() override
+        {
+            ImpedanceCalculator::calcImpedance (*this);
+        }
+
+        auto getPortImpedances()
+        {
+            std::array<T, numPorts> portImpedances {};
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { portImpedances[i] = port.wdf.R; },
+                                          downPorts);
+
+            return portImpedances;
+        }
+
+        void setSMatrixData (const T (&mat)[numPorts][numPorts])
+        {
+            for (int i = 0; i < numPorts; ++i)
+                for (int j = 0; j < numPorts; ++j)
+                    S_matrix[j][i] = mat[i][j];
+        }
+
+        inline void compute() noexcept
+        {
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { a_vec[i] = port.reflected(); },
+                                          downPorts);
+
+            rtype_detail::RtypeScatter (S_matrix, a_vec, b_vec);
+
+            rtype_detail::forEachInTuple ([&] (auto& port, size_t i) { port.incident (b_vec[i]); },
+                                          downPorts);
+        }
+
+    private:
+        std::tuple<PortTypes&...> downPorts;
+
+        rtype_detail::Matrix<T, numPorts> S_matrix;
+        rtype_detail::AlignedArray<T, numPorts> a_vec;
+        rtype_detail::AlignedArray<T, numPorts> b_vec;
+    };
+}
+
+
+template <typename T>
+class RtypeLadder
+{
+public:
+    RtypeLadder()
+    {
+        root.propagateImpedanceChange();
+    }
+
+    RtypeLadder (const RtypeLadder&) = delete;
+    RtypeLadder& operator= (const RtypeLadder&) = delete;
+
+    void prepare (T sampleRate)
+    {
+        {
+            ScopedDeferImpedancePropagation deferImpedance { C_HPm1, L_HPm, C_HPm2, C_HP1, L_HP1, C_HP2,
+                                                             L_LP1, C_LP1, L_LP2, L_LPm1, C_LPm1, L_LPm2 };
+
+            C_HPm1.prepare (sampleRate);
+            L_HPm.prepare (sampleRate);
+            C_HPm2.prepare (sampleRate);
+            C_HP1.prepare (sampleRate);
+            L_HP1.prepare (sampleRate);
+            C_HP2.prepare (sampleRate);
+            L_LP1.prepare (sampleRate);
+            C_LP1.prepare (sampleRate);
+            L_LP2.prepare (sampleRate);
+            L_LPm1.prepare (sampleRate);
+            C_LPm1.prepare (sampleRate);
+            L_LPm2.prepare (sampleRate);
+        }
+
+        root.propagateImpedanceChange();
+    }
+
+    void reset()
+    {
+        setState (State {});
+    }
+
+    /** Wave states of the reactive elements, in port order after Vin */
+    using State = std::array<T, 12>;
+
+    State getState() const
+    {
+        return { C_HPm1.wdf.a, L_HPm.wdf.a, C_HPm2.wdf.a, C_HP1.wdf.a, L_HP1.wdf.a, C_HP2.wdf.a,
+                 L_LP1.wdf.a, C_LP1.wdf.a, L_LP2.wdf.a, L_LPm1.wdf.a, C_LPm1.wdf.a, L_LPm2.wdf.a };
+    }
+
+    /** incident() sets both z and the stored wave, which keeps getState() valid */
+    void setState (const State& state)
+    {
+        C_HPm1.incident (state[0]);
+        L_HPm.incident (state[1]);
+        C_HPm2.incident (state[2]);
+        C_HP1.incident (state[3]);
+        L_HP1.incident (state[4]);
+        C_HP2.incident (state[5]);
+        L_LP1.incident (state[6]);
+        C_LP1.incident (state[7]);
+        L_LP2.incident (state[8]);
+        L_LPm1.incident (state[9]);
+        C_LPm1.incident (state[10]);
+        L_LPm2.incident (state[11]);
+    }
+
+    /** Sets every element, then rebuilds the scattering matrix once */
+    template <typename Components>
+    void setComponentValues (const Components& c)
+    {
+        {
+            ScopedDeferImpedancePropagation deferImpedance { Vin, C_HPm1, L_HPm, C_HPm2, C_HP1, L_HP1, C_HP2,
+                                                             L_LP1, C_LP1, L_LP2, L_LPm1, C_LPm1, L_LPm2, Rt };
+
+            Vin.setResistanceValue ((T) c.Rin);
+            C_HPm1.setCapacitanceValue ((T) c.C_HPm1);
+            L_HPm.setInductanceValue ((T) c.L_HPm);
+            C_HPm2.setCapacitanceValue ((T) c.C_HPm2);
+            C_HP1.setCapacitanceValue ((T) c.C_HP1);
+            L_HP1.setInductanceValue ((T) c.L_HP1);
+            C_HP2.setCapacitanceValue ((T) c.C_HP2);
+            L_LP1.setInductanceValue ((T) c.L_LP1);
+            C_LP1.setCapacitanceValue ((T) c.C_LP1);
+            L_LP2.setInductanceValue ((T) c.L_LP2);
+            L_LPm1.setInductanceValue ((T) c.L_LPm1);
+            C_LPm1.setCapacitanceValue ((T) c.C_LPm1);
+            L_LPm2.setInductanceValue ((T) c.L_LPm2);
+            Rt.setResistanceValue ((T) c.Rt);
+        }
+
+        root.propagateImpedanceChange();
+    }
+
+    inline T processSample (T x) noexcept
+    {
+        Vin.setVoltage (x);
+        root.compute();
+        return voltage<T> (Rt);
+    }
+
+private:
+    ResistiveVoltageSourceT<T> Vin { (T) 560 };
+
+    CapacitorT<T> C_HPm1 { (T) 5.0e-8 };
+    InductorT<T> L_HPm { (T) 1.0e-3 };
+    CapacitorT<T> C_HPm2 { (T) 5.0e-8 };
+    CapacitorT<T> C_HP1 { (T) 5.0e-8 };
+    InductorT<T> L_HP1 { (T) 1.0e-3 };
+    CapacitorT<T> C_HP2 { (T) 1.0e-8 };
+
+    InductorT<T> L_LP1 { (T) 1.0e-3 };
+    CapacitorT<T> C_LP1 { (T) 1.0e-8 };
+    InductorT<T> L_LP2 { (T) 1.0e-3 };
+    InductorT<T> L_LPm1 { (T) 1.0e-3 };
+    CapacitorT<T> C_LPm1 { (T) 1.0e-8 };
+    InductorT<T> L_LPm2 { (T) 1.0e-3 };
+
+    ResistorT<T> Rt { (T) 560 };
+
+    RtypeLadderDetail::RootAdaptor<T, RtypeLadderDetail::ScatteringMatrix,
+                                   decltype (Vin),
+                                   decltype (C_HPm1), decltype (L_HPm), decltype (C_HPm2),
+                                   decltype (C_HP1), decltype (L_HP1), decltype (C_HP2),
+                                   decltype (L_LP1), decltype (C_LP1), decltype (L_LP2),
+                                   decltype (L_LPm1), decltype (C_LPm1), decltype (L_LPm2),
+                                   decltype (Rt)>
+        root { Vin, C_HPm1, L_HPm, C_HPm2, C_HP1, L_HP1, C_HP2, L_LP1, C_LP1, L_LP2, L_LPm1, C_LPm1, L_LPm2, Rt };
+};
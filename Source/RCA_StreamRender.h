@@ -0,0 +1,315 @@
+/*
+  ==============================================================================
+
+    RCA_StreamRender.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    A three-stage pipeline for files too long to hold in memory: one thread
+    reads blocks, one filters them and one writes them out, so disk and CPU
+    work overlap and the slowest stage sets the pace. Tools/StreamRender runs
+    RCA_MK2_SEF through it between memory-mapped WAV files.
+
+    Every block comes from a pool allocated up front and goes round and round:
+    free -> read -> filtered -> written -> free. The stages hand blocks on
+    through single-producer single-consumer rings, so there are no locks and,
+    once run() has started, no allocation. A stage with nothing to do yields
+    until there is; each keeps track of how long it spent working and waiting.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RCA_OfflineRender.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+namespace StreamRender
+{
+    /** Bounded ring for one producer thread and one consumer thread; never allocates after construction */
+    template <typename T>
+    class SpscQueue
+    {
+    public:
+        explicit SpscQueue (size_t minCapacity)
+        {
+            size_t capacity = 1;
+
+            while (capacity < minCapacity)
+                capacity *= 2;
+
+            slots.resize (capacity);
+            mask = capacity - 1;
+        }
+
+        /** Producer only. False if the ring is full */
+        bool push (const T& item) noexcept
+        {
+            const auto tail = writePosition.load (std::memory_order_relaxed);
+
+            if (tail - cachedReadPosition == slots.size())
+            {
+                cachedReadPosition = readPosition.load (std::memory_order_acquire);
+
+                if (tail - cachedReadPosition == slots.size())
+                    return false;
+            }
+
+            slots[tail & mask] = item;
+            writePosition.store (tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Consumer only. False if the ring is empty */
+        bool pop (T& item) noexcept
+        {
+            const auto head = readPosition.load (std::memory_order_relaxed);
+
+            if (head == cachedWritePosition)
+            {
+                cachedWritePosition = writePosition.load (std::memory_order_acquire);
+
+                if (head == cachedWritePosition)
+                    return false;
+            }
+
+            item = slots[head & mask];
+            readPosition.store (head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::vector<T> slots;
+        size_t mask = 0;
+
+        // each end on its own cache line, with its copy of the other end's position
+        alignas (64) std::atomic<size_t> writePosition { 0 };
+        size_t cachedReadPosition = 0;
+
+        alignas (64) std::atomic<size_t> readPosition { 0 };
+        size_t cachedWritePosition = 0;
+    };
+
+    //==============================================================================
+    /** Each stage writes its own, so they're kept a cache line apart */
+    struct alignas (64) StageStats
+    {
+        int64_t numFrames = 0;
+        double busySeconds = 0.0;
+        double waitSeconds = 0.0;
+
+        /** How fast the stage would go if the others never held it up */
+        double getFramesPerSecond() const noexcept { return busySeconds > 0.0 ? (double) numFrames / busySeconds : 0.0; }
+    };
+
+    struct Stats
+    {
+        StageStats read, process, write;
+        double wallSeconds = 0.0;
+    };
+
+    class Pipeline
+    {
+    public:
+        /** numBlocks of numChannels x blockSize frames are allocated here, once */
+        Pipeline (int numChannelsToUse, int blockSizeToUse, int numBlocks)
+            : numChannels (numChannelsToUse), blockSize (blockSizeToUse),
+              storage ((size_t) numBlocks * (size_t) numChannels * (size_t) blockSize),
+              channelPointers ((size_t) numBlocks * (size_t) numChannels),
+              blocks ((size_t) numBlocks),
+              freeBlocks ((size_t) numBlocks), readBlocks ((size_t) numBlocks), processedBlocks ((size_t) numBlocks)
+        {
+            assert (numChannels > 0 && blockSize > 0 && numBlocks >= 3);
+
+            for (size_t b = 0; b < blocks.size(); ++b)
+            {
+                for (size_t c = 0; c < (size_t) numChannels; ++c)
+                    channelPointers[b * (size_t) numChannels + c] = storage.data() + (b * (size_t) numChannels + c) * (size_t) blockSize;
+
+                blocks[b].channels = channelPointers.data() + b * (size_t) numChannels;
+            }
+        }
+
+        /**
+         * Streams a whole file through the three stages, each on its own thread:
+         *
+         *   int read (int64_t start, float* const* channels, int maxFrames)
+         *       frames read into channels from frame start on: 0 at the end, < 0 on an error
+         *   void process (float* const* channels, int numFrames)
+         *       in place
+         *   bool write (const float* const* channels, int numFrames)
+         *       false on an error
+         *
+         * Returns false if read or write failed, in which case the other stages stop too.
+         * A Pipeline runs once.
+         */
+        template <typename Read, typename Process, typename Write>
+        bool run (Read&& read, Process&& process, Write&& write)
+        {
+            for (auto& block : blocks)
+                freeBlocks.push (&block);
+
+            const auto start = Clock::now();
+
+            // the writer is job 0, on the calling thread, as it's the one that finishes last
+            OfflineRender::runOnThreads (3, [&] (int stage)
+            {
+                if (stage == 1)
+                    runReader (read);
+                else if (stage == 2)
+                    runProcessor (process);
+                else
+                    runWriter (write);
+            });
+
+            stats.wallSeconds = seconds (start, Clock::now());
+            return ! failed.load();
+        }
+
+        const Stats& getStats() const noexcept { return stats; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Block
+        {
+            float* const* channels = nullptr;
+            int numFrames = 0;      // 0 marks the end of the stream
+        };
+
+        static double seconds (Clock::time_point start, Clock::time_point end) noexcept
+        {
+            return std::chrono::duration<double> (end - start).count();
+        }
+
+        /** Waits for the next block, or returns nullptr once another stage has failed */
+        Block* take (SpscQueue<Block*>& queue, StageStats& stage) noexcept
+        {
+            const auto start = Clock::now();
+            Block* block = nullptr;
+
+            while (! queue.pop (block))
+            {
+                if (failed.load (std::memory_order_relaxed))
+                    return nullptr;
+
+                std::this_thread::yield();
+            }
+
+            stage.waitSeconds += seconds (start, Clock::now());
+            return block;
+        }
+
+        /** Every queue can hold the whole pool, so this always goes straight in */
+        static void give (SpscQueue<Block*>& queue, Block* block) noexcept
+        {
+            const bool pushed = queue.push (block);
+            assert (pushed);
+            (void) pushed;
+        }
+
+        template <typename Read>
+        void runReader (Read& read)
+        {
+            int64_t position = 0;
+
+            for (;;)
+            {
+                auto* block = take (freeBlocks, stats.read);
+
+                if (block == nullptr)
+                    return;
+
+                const auto start = Clock::now();
+                const int numFrames = read (position, block->channels, blockSize);
+                stats.read.busySeconds += seconds (start, Clock::now());
+
+                if (numFrames < 0)
+                {
+                    failed = true;
+                    return;
+                }
+
+                block->numFrames = numFrames;
+                position += numFrames;
+                stats.read.numFrames += numFrames;
+
+                give (readBlocks, block);
+
+                if (numFrames == 0)
+                    return;
+            }
+        }
+
+        template <typename Process>
+        void runProcessor (Process& process)
+        {
+            for (;;)
+            {
+                auto* block = take (readBlocks, stats.process);
+
+                if (block == nullptr)
+                    return;
+
+                if (block->numFrames > 0)
+                {
+                    const auto start = Clock::now();
+                    process (block->channels, block->numFrames);
+                    stats.process.busySeconds += seconds (start, Clock::now());
+                    stats.process.numFrames += block->numFrames;
+                }
+
+                give (processedBlocks, block);
+
+                if (block->numFrames == 0)
+                    return;
+            }
+        }
+
+        template <typename Write>
+        void runWriter (Write& write)
+        {
+            for (;;)
+            {
+                auto* block = take (processedBlocks, stats.write);
+
+                if (block == nullptr)
+                    return;
+
+                if (block->numFrames == 0)
+                    return;
+
+                const auto start = Clock::now();
+                const bool written = write (block->channels, block->numFrames);
+                stats.write.busySeconds += seconds (start, Clock::now());
+
+                if (! written)
+                {
+                    failed = true;
+                    return;
+                }
+
+                stats.write.numFrames += block->numFrames;
+                give (freeBlocks, block);
+            }
+        }
+
+        const int numChannels, blockSize;
+
+        std::vector<float> storage;
+        std::vector<float*> channelPointers;
+        std::vector<Block> blocks;
+
+        SpscQueue<Block*> freeBlocks, readBlocks, processedBlocks;
+        std::atomic<bool> failed { false };
+
+        // each written by its own stage only, and read once they've all finished
+        Stats stats;
+    };
+}
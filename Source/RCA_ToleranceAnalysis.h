@@ -0,0 +1,290 @@
+/*
+  ==============================================================================
+
+    RCA_ToleranceAnalysis.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Monte Carlo spread of the ladder's response over component tolerances:
+    how much real MK II units, built from parts within +-5..20%, differ from
+    the nominal values in the knob tables.
+
+    Every trial draws its own value for each capacitor and inductor around a
+    nominal LadderComponents, and its response is ladderTransferFunction()
+    evaluated straight from those values. Lanes::width trials go through it
+    side by side, batches of those are shared out over threads, and each
+    frequency's magnitudes are then reduced to the percentiles asked for.
+    A couple of thousand trials at the analyser's coarse points take a few
+    milliseconds, so the envelope can follow a tolerance knob.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "RCA_MKII_SEF.h"
+#include "RCA_Lanes.h"
+#include "RCA_OfflineRender.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+namespace ToleranceAnalysis
+{
+    /** Just enough of std::complex for ladderTransferFunction(), a trial per lane */
+    struct ComplexLanes
+    {
+        Lanes re, im;
+
+        ComplexLanes (const Lanes& real = {}, const Lanes& imag = {}) noexcept : re (real), im (imag) {}
+        ComplexLanes (int real) noexcept : re ((float) real) {}
+
+        friend ComplexLanes operator+ (const ComplexLanes& a, const ComplexLanes& b) noexcept
+        {
+            return { a.re + b.re, a.im + b.im };
+        }
+
+        friend ComplexLanes operator* (const ComplexLanes& a, const ComplexLanes& b) noexcept
+        {
+            return { a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+        }
+
+        friend ComplexLanes operator/ (const ComplexLanes& a, const ComplexLanes& b) noexcept
+        {
+            const Lanes scale = Lanes (1.f) / (b.re * b.re + b.im * b.im);
+            return { (a.re * b.re + a.im * b.im) * scale, (a.im * b.re - a.re * b.im) * scale };
+        }
+
+        Lanes magnitude() const noexcept
+        {
+            Lanes result;
+
+            for (int i = 0; i < Lanes::width; ++i)
+                result.v[i] = std::sqrt (re.v[i] * re.v[i] + im.v[i] * im.v[i]);
+
+            return result;
+        }
+    };
+
+    /** LadderComponents' element names, one trial per lane */
+    struct TrialComponents
+    {
+        Lanes Rin, Rt;
+
+        Lanes C_HPm1, L_HPm, C_HPm2;
+        Lanes C_HP1, L_HP1, C_HP2;
+        Lanes L_LP1, C_LP1, L_LP2;
+        Lanes L_LPm1, C_LPm1, L_LPm2;
+    };
+
+    enum class Distribution
+    {
+        uniform,    // anywhere within the tolerance
+        gaussian    // the tolerance is 3 sigma, and nothing lands outside it
+    };
+
+    struct Settings
+    {
+        /** Usually a knob position (RCA_MK2_SEF::highPassKnobPositions and lowPassKnobPositions) */
+        LadderComponents nominal;
+
+        /** +- fractions of the nominal value, e.g. 0.1 for 10% parts. Rin and Rt are left alone */
+        float capacitorTolerance = 0.1f;
+        float inductorTolerance = 0.1f;
+
+        Distribution distribution = Distribution::uniform;
+
+        int numTrials = 2048;
+        uint32_t seed = 1;
+
+        /** 0 for the analog ladder, otherwise the bilinear WDF's response at this rate */
+        double sampleRate = 0.0;
+
+        /** Threads to share the trials over, 0 for one per core */
+        int numThreads = 0;
+    };
+
+    class Analyser
+    {
+    public:
+        /**
+         * Runs the trials and reduces them to the percentiles (0 to 100) at each frequency.
+         * Allocates if the sizes have grown since last time, and starts its own threads,
+         * so keep it off the audio thread.
+         */
+        void run (const Settings& settings, const float* frequencies, int numFrequenciesToUse,
+                  const float* percentilesToUse, int numPercentilesToUse)
+        {
+            numFrequencies = numFrequenciesToUse;
+            numPercentiles = numPercentilesToUse;
+
+            const int numBlocks = (std::max (1, settings.numTrials) + Lanes::width - 1) / Lanes::width;
+            numTrials = numBlocks * Lanes::width;
+
+            drawTrials (settings, numBlocks);
+            setFrequencies (settings.sampleRate, frequencies);
+
+            magnitudes.resize ((size_t) numFrequencies * (size_t) numTrials);
+            envelopes.resize ((size_t) numPercentiles * (size_t) numFrequencies);
+            percentiles.assign (percentilesToUse, percentilesToUse + numPercentiles);
+
+            const int numThreads = settings.numThreads > 0 ? settings.numThreads
+                                                           : (int) std::max (1u, std::thread::hardware_concurrency());
+
+            // trials first, a batch of blocks at a time, then the percentiles a frequency at a time
+            constexpr int blocksPerBatch = 4;
+            const int numBatches = (numBlocks + blocksPerBatch - 1) / blocksPerBatch;
+
+            std::atomic<int> nextBatch { 0 };
+            std::atomic<int> nextFrequency { 0 };
+
+            OfflineRender::runOnThreads (std::min (numThreads, numBatches), [&] (int)
+            {
+                for (int batch = nextBatch++; batch < numBatches; batch = nextBatch++)
+                    for (int block = batch * blocksPerBatch; block < std::min (numBlocks, (batch + 1) * blocksPerBatch); ++block)
+                        evaluateBlock (block);
+            });
+
+            OfflineRender::runOnThreads (std::min (numThreads, numFrequencies), [&] (int)
+            {
+                std::vector<float> sorted ((size_t) numTrials);
+
+                for (int f = nextFrequency++; f < numFrequencies; f = nextFrequency++)
+                    reduce (f, sorted);
+            });
+        }
+
+        int getNumTrials() const noexcept { return numTrials; }
+
+        /** Magnitude (linear) at frequency f below which percentile p of the trials fall */
+        float getEnvelope (int p, int f) const noexcept
+        {
+            return envelopes[(size_t) p * (size_t) numFrequencies + (size_t) f];
+        }
+
+        const float* getEnvelope (int p) const noexcept
+        {
+            return envelopes.data() + (size_t) p * (size_t) numFrequencies;
+        }
+
+        /** Every trial's magnitude at frequency f */
+        const float* getMagnitudes (int f) const noexcept
+        {
+            return magnitudes.data() + (size_t) f * (size_t) numTrials;
+        }
+
+    private:
+        /** All the random draws happen here, in one order, so a seed always gives the same units */
+        void drawTrials (const Settings& settings, int numBlocks)
+        {
+            trials.resize ((size_t) numBlocks);
+
+            std::mt19937 rng (settings.seed);
+            std::uniform_real_distribution<float> uniform (-1.f, 1.f);
+            std::normal_distribution<float> normal (0.f, 1.f / 3.f);
+
+            auto draw = [&] (float nominal, float tolerance)
+            {
+                const float deviation = settings.distribution == Distribution::uniform
+                                      ? uniform (rng)
+                                      : std::clamp (normal (rng), -1.f, 1.f);
+
+                return nominal * (1.f + tolerance * deviation);
+            };
+
+            const auto& n = settings.nominal;
+            const float tc = settings.capacitorTolerance;
+            const float tl = settings.inductorTolerance;
+
+            for (auto& block : trials)
+            {
+                block.Rin = n.Rin;
+                block.Rt = n.Rt;
+
+                for (int lane = 0; lane < Lanes::width; ++lane)
+                {
+                    block.C_HPm1.v[lane] = draw (n.C_HPm1, tc);
+                    block.L_HPm.v[lane]  = draw (n.L_HPm, tl);
+                    block.C_HPm2.v[lane] = draw (n.C_HPm2, tc);
+                    block.C_HP1.v[lane]  = draw (n.C_HP1, tc);
+                    block.L_HP1.v[lane]  = draw (n.L_HP1, tl);
+                    block.C_HP2.v[lane]  = draw (n.C_HP2, tc);
+                    block.L_LP1.v[lane]  = draw (n.L_LP1, tl);
+                    block.C_LP1.v[lane]  = draw (n.C_LP1, tc);
+                    block.L_LP2.v[lane]  = draw (n.L_LP2, tl);
+                    block.L_LPm1.v[lane] = draw (n.L_LPm1, tl);
+                    block.C_LPm1.v[lane] = draw (n.C_LPm1, tc);
+                    block.L_LPm2.v[lane] = draw (n.L_LPm2, tl);
+                }
+            }
+        }
+
+        /** The imaginary part of s at each frequency, as computeMagnitudeResponse() has it */
+        void setFrequencies (double sampleRate, const float* frequencies)
+        {
+            omegas.resize ((size_t) numFrequencies);
+
+            for (int f = 0; f < numFrequencies; ++f)
+            {
+                const double w = LadderComponentsT<double>::twoPi * frequencies[f];
+
+                if (sampleRate > 0.0)
+                    omegas[(size_t) f] = float (2.0 * sampleRate * std::tan (0.5 * std::min (w / sampleRate, 0.999 * LadderComponentsT<double>::twoPi * 0.5)));
+                else
+                    omegas[(size_t) f] = float (w);
+            }
+        }
+
+        void evaluateBlock (int block)
+        {
+            const auto& components = trials[(size_t) block];
+
+            for (int f = 0; f < numFrequencies; ++f)
+            {
+                const ComplexLanes s ({}, omegas[(size_t) f]);
+                const auto magnitude = ladderTransferFunction (components, s).magnitude();
+
+                std::copy (std::begin (magnitude.v), std::end (magnitude.v),
+                           magnitudes.begin() + (ptrdiff_t) ((size_t) f * (size_t) numTrials + (size_t) block * Lanes::width));
+            }
+        }
+
+        /** Linear interpolation between the two nearest trials, as numpy.percentile does by default */
+        void reduce (int f, std::vector<float>& sorted)
+        {
+            const auto* column = getMagnitudes (f);
+            std::copy (column, column + numTrials, sorted.begin());
+
+            for (int p = 0; p < numPercentiles; ++p)
+            {
+                const double position = std::clamp ((double) percentiles[(size_t) p], 0.0, 100.0) / 100.0 * (numTrials - 1);
+                const auto below = (size_t) position;
+                const float t = float (position - (double) below);
+
+                std::nth_element (sorted.begin(), sorted.begin() + (ptrdiff_t) below, sorted.end());
+                float value = sorted[below];
+
+                if (t > 0.f)
+                {
+                    const float above = *std::min_element (sorted.begin() + (ptrdiff_t) below + 1, sorted.end());
+                    value += t * (above - value);
+                }
+
+                envelopes[(size_t) p * (size_t) numFrequencies + (size_t) f] = value;
+            }
+        }
+
+        int numTrials = 0, numFrequencies = 0, numPercentiles = 0;
+
+        std::vector<TrialComponents> trials;
+        std::vector<float> omegas;
+        std::vector<float> percentiles;
+
+        std::vector<float> magnitudes;  // [frequency][trial]
+        std::vector<float> envelopes;   // [percentile][frequency]
+    };
+}
@@ -0,0 +1,561 @@
+/*
+  ==============================================================================
+
+    RCA_WdfNetlist.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Wave digital filters described in a small text netlist, built at runtime,
+    so a circuit variant (an extra section, a different termination) is an
+    edit to a string or a file rather than to RCA_MK2_SEF's templates.
+
+    Each line is one of
+
+        R|C|L <name> <value>            a resistor, capacitor or inductor
+        series|parallel <name> <a> <b>  an adaptor joining two earlier ports
+        source <name> <port>            the ideal voltage source at the root
+        output <port>                   whose voltage processSample() returns
+
+    Values take the usual suffixes (p, n, u, m, k, M). Anything after '#' is a
+    comment. Every port other than the root's must feed exactly one adaptor,
+    so what comes out is a tree.
+
+    The compiled circuit is one array of nodes (leaves first, then adaptors
+    children before parents) and one instruction per adaptor. Running the list
+    forwards is the reflected pass, backwards the incident pass. The arithmetic
+    is chowdsp's, in the same order, so a netlist wired like RCA_MK2_SEF gives
+    the same samples as its wdft tree.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace WdfNetlist
+{
+    /** The ladder RCA_MK2_SEF builds from templates, with the same element names and starting values */
+    inline const char* const rcaLadder = R"(
+        # RCA MK II sound effects filter, load first
+        R Rt      560
+        L L_LPm2  1m
+        series S8 L_LPm2 Rt
+        C C_LPm1  10n
+        parallel P4 C_LPm1 S8
+        L L_LPm1  1m
+        series S7 L_LPm1 P4
+        L L_LP2   1m
+        series S6 L_LP2 S7
+        C C_LP1   10n
+        parallel P3 C_LP1 S6
+        L L_LP1   1m
+        series S5 L_LP1 P3
+        C C_HP2   10n
+        series S4 C_HP2 S5
+        L L_HP1   1m
+        parallel P2 L_HP1 S4
+        C C_HP1   50n
+        series S3 C_HP1 P2
+        C C_HPm2  50n
+        series S2 C_HPm2 S3
+        L L_HPm   1m
+        parallel P1 L_HPm S2
+        C C_HPm1  50n
+        series S1 C_HPm1 P1
+        R Rin     560
+        series S0 Rin S1
+        source Vs S0
+        output Rt
+    )";
+
+    class Circuit
+    {
+    public:
+        /**
+         * Builds the circuit from a netlist, replacing whatever was there. On failure the
+         * circuit is left empty and error says what went wrong, and on which line.
+         * Not realtime safe.
+         */
+        bool compile (const std::string& netlist, std::string& error)
+        {
+            *this = Circuit();
+
+            std::vector<Definition> definitions;
+            std::unordered_map<std::string, int> byName;
+            std::string sourceName, sourcePort, outputPort;
+
+            std::istringstream lines (netlist);
+            std::string line;
+
+            for (int lineNumber = 1; std::getline (lines, line); ++lineNumber)
+            {
+                auto fail = [&] (const std::string& message)
+                {
+                    error = "line " + std::to_string (lineNumber) + ": " + message;
+                    *this = Circuit();
+                    return false;
+                };
+
+                std::istringstream tokens (line.substr (0, line.find ('#')));
+                std::string keyword, name, first, second, extra;
+
+                if (! (tokens >> keyword))
+                    continue;
+
+                if (keyword == "R" || keyword == "C" || keyword == "L")
+                {
+                    if (! (tokens >> name >> first) || (tokens >> extra))
+                        return fail ("expected '" + keyword + " <name> <value>'");
+
+                    Definition d;
+                    d.kind = keyword == "R" ? Kind::resistor : keyword == "C" ? Kind::capacitor : Kind::inductor;
+
+                    if (! parseValue (first, d.value) || ! (d.value > 0.f))
+                        return fail ("'" + first + "' isn't a positive value");
+
+                    if (! byName.emplace (name, (int) definitions.size()).second)
+                        return fail ("'" + name + "' is already defined");
+
+                    definitions.push_back (d);
+                }
+                else if (keyword == "series" || keyword == "parallel")
+                {
+                    if (! (tokens >> name >> first >> second) || (tokens >> extra))
+                        return fail ("expected '" + keyword + " <name> <port> <port>'");
+
+                    Definition d;
+                    d.kind = keyword == "series" ? Kind::series : Kind::parallel;
+
+                    for (auto* port : { &first, &second })
+                    {
+                        const auto found = byName.find (*port);
+
+                        if (found == byName.end())
+                            return fail ("'" + *port + "' isn't defined (yet)");
+
+                        auto& child = definitions[(size_t) found->second];
+
+                        if (child.parent >= 0)
+                            return fail ("'" + *port + "' is already connected");
+
+                        child.parent = (int) definitions.size();
+                        (port == &first ? d.port1 : d.port2) = found->second;
+                    }
+
+                    if (! byName.emplace (name, (int) definitions.size()).second)
+                        return fail ("'" + name + "' is already defined");
+
+                    definitions.push_back (d);
+                }
+                else if (keyword == "source")
+                {
+                    if (! (tokens >> name >> first) || (tokens >> extra))
+                        return fail ("expected 'source <name> <port>'");
+
+                    if (! sourceName.empty())
+                        return fail ("there can only be one source");
+
+                    sourceName = name;
+                    sourcePort = first;
+                }
+                else if (keyword == "output")
+                {
+                    if (! (tokens >> first) || (tokens >> extra))
+                        return fail ("expected 'output <port>'");
+
+                    outputPort = first;
+                }
+                else
+                {
+                    return fail ("unknown keyword '" + keyword + "'");
+                }
+            }
+
+            auto failAtEnd = [&] (const std::string& message)
+            {
+                error = message;
+                *this = Circuit();
+                return false;
+            };
+
+            if (sourceName.empty())
+                return failAtEnd ("no source");
+
+            if (outputPort.empty())
+                return failAtEnd ("no output");
+
+            const auto root = byName.find (sourcePort);
+
+            if (root == byName.end() || definitions[(size_t) root->second].parent >= 0)
+                return failAtEnd ("the source's port '" + sourcePort + "' has to be defined and not connected to anything else");
+
+            for (const auto& [name, index] : byName)
+                if (index != root->second && definitions[(size_t) index].parent < 0)
+                    return failAtEnd ("'" + name + "' isn't connected to anything");
+
+            if (byName.count (outputPort) == 0)
+                return failAtEnd ("the output '" + outputPort + "' isn't defined");
+
+            // leaves first, capacitors then inductors then resistors, so their reflections are three plain loops
+            std::vector<int> order;
+
+            for (auto kind : { Kind::capacitor, Kind::inductor, Kind::resistor })
+                for (size_t i = 0; i < definitions.size(); ++i)
+                    if (definitions[i].kind == kind)
+                        order.push_back ((int) i);
+
+            numCapacitors = countKind (definitions, Kind::capacitor);
+            numInductors = countKind (definitions, Kind::inductor);
+            numLeaves = (int) order.size();
+
+            // then adaptors, children before parents; a definition can only name ports defined above it
+            for (size_t i = 0; i < definitions.size(); ++i)
+                if (definitions[i].kind == Kind::series || definitions[i].kind == Kind::parallel)
+                    order.push_back ((int) i);
+
+            std::vector<int> position (definitions.size());
+
+            for (size_t i = 0; i < order.size(); ++i)
+                position[(size_t) order[i]] = (int) i;
+
+            nodes.resize (order.size());
+            values.resize ((size_t) numLeaves);
+            kinds.resize (order.size());
+
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                const auto& d = definitions[(size_t) order[i]];
+                kinds[i] = d.kind;
+
+                if (i < (size_t) numLeaves)
+                    values[i] = d.value;
+                else
+                {
+                    Instruction op;
+                    op.type = d.kind == Kind::series ? Op::series : Op::parallel;
+                    op.node = (int32_t) i;
+                    op.port1 = (int32_t) position[(size_t) d.port1];
+                    op.port2 = (int32_t) position[(size_t) d.port2];
+                    program.push_back (op);
+                }
+            }
+
+            // which waves can stay in a register from one instruction to the next, in either direction
+            for (size_t i = 1; i < program.size(); ++i)
+            {
+                auto& op = program[i];
+                const auto previous = program[i - 1].node;
+
+                op.carried = op.port1 == previous ? Carry::port1 : op.port2 == previous ? Carry::port2 : Carry::none;
+                op.sendsDown = op.carried == Carry::none ? Carry::port2 : op.carried;
+                program[i - 1].carriedDown = op.carried != Carry::none;
+            }
+
+            if (! program.empty())
+                program.back().carriedDown = true;
+
+            names.resize (order.size());
+
+            for (const auto& [name, index] : byName)
+            {
+                elementIndices[name] = position[(size_t) index];
+                names[(size_t) position[(size_t) index]] = name;
+            }
+
+            rootIndex = position[(size_t) root->second];
+            outputIndex = elementIndices[outputPort];
+
+            updateImpedances();
+            return true;
+        }
+
+        bool isCompiled() const noexcept { return ! nodes.empty(); }
+
+        void prepare (float sampleRate)
+        {
+            fs = sampleRate;
+            updateImpedances();
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            for (auto& node : nodes)
+                node.a = node.b = node.bDiff = 0.f;
+        }
+
+        //==============================================================================
+        /** -1 if there's no element or adaptor called name */
+        int getIndex (const std::string& name) const
+        {
+            const auto found = elementIndices.find (name);
+            return found != elementIndices.end() ? found->second : -1;
+        }
+
+        /** Sets a resistance, capacitance or inductance (by getIndex()) and updates the impedances */
+        void setValue (int index, float newValue) noexcept
+        {
+            if (index < 0 || index >= numLeaves || values[(size_t) index] == newValue)
+                return;
+
+            values[(size_t) index] = newValue;
+            updateImpedances();
+        }
+
+        bool setValue (const std::string& name, float newValue)
+        {
+            const auto index = getIndex (name);
+
+            if (index < 0 || index >= numLeaves)
+                return false;
+
+            setValue (index, newValue);
+            return true;
+        }
+
+        int getNumNodes() const noexcept        { return (int) nodes.size(); }
+        int getNumInstructions() const noexcept { return (int) program.size(); }
+
+        //==============================================================================
+        enum class Kind : uint8_t { resistor, capacitor, inductor, series, parallel };
+
+        /** One compiled node, for tools that turn a circuit into code (see Tools/WdfCodegen) */
+        struct NodeInfo
+        {
+            std::string name;
+            Kind kind = Kind::resistor;
+            float value = 0.f;          // leaves: as set, before any sample rate comes into it
+            int port1 = -1, port2 = -1; // adaptors: the node indices of their ports
+        };
+
+        /** Nodes are numbered leaves first, then adaptors with children before parents */
+        NodeInfo getNodeInfo (int index) const
+        {
+            NodeInfo info;
+            info.name = names[(size_t) index];
+            info.kind = kinds[(size_t) index];
+
+            if (index < numLeaves)
+            {
+                info.value = values[(size_t) index];
+            }
+            else
+            {
+                const auto& op = program[(size_t) (index - numLeaves)];
+                info.port1 = op.port1;
+                info.port2 = op.port2;
+            }
+
+            return info;
+        }
+
+        /** The node the source drives, and the one processSample() reads the voltage of */
+        int getRootIndex() const noexcept   { return rootIndex; }
+        int getOutputIndex() const noexcept { return outputIndex; }
+
+        //==============================================================================
+        inline float processSample (float x) noexcept
+        {
+            auto* n = nodes.data();
+
+            // leaves: a capacitor reflects its last incident wave, an inductor its negation, a resistor nothing
+            for (int i = 0; i < numCapacitors; ++i)
+                n[i].b = n[i].a;
+
+            for (int i = numCapacitors; i < numCapacitors + numInductors; ++i)
+                n[i].b = -n[i].a;
+
+            for (int i = numCapacitors + numInductors; i < numLeaves; ++i)
+                n[i].b = 0.f;
+
+            // Reflected, children before parents. The wave an adaptor has just sent up is usually
+            // the next one's port, so it's carried over in a register rather than read back.
+            float up = program.empty() ? n[rootIndex].b : 0.f;
+
+            for (const auto& op : program)
+            {
+                auto& node = n[op.node];
+                const float b1 = op.carried == Carry::port1 ? up : n[op.port1].b;
+                const float b2 = op.carried == Carry::port2 ? up : n[op.port2].b;
+
+                if (op.type == Op::series)
+                {
+                    up = -(b1 + b2);
+                }
+                else
+                {
+                    node.bDiff = b2 - b1;
+                    up = b2 - node.reflect * node.bDiff;
+                }
+
+                node.b = up;
+            }
+
+            // the ideal source; the root adaptor is always the last instruction
+            float down = -up + 2.f * x;
+            n[rootIndex].a = down;
+
+            // incident, parents before children, carrying the wave down the same way
+            for (auto op = program.rbegin(); op != program.rend(); ++op)
+            {
+                auto& node = n[op->node];
+                auto& p1 = n[op->port1];
+                auto& p2 = n[op->port2];
+
+                const float a = op->carriedDown ? down : node.a;
+                node.a = a;
+
+                float a1, a2;
+
+                if (op->type == Op::series)
+                {
+                    a1 = p1.b - node.reflect * (a + p1.b + p2.b);
+                    a2 = -(a + a1);
+                }
+                else
+                {
+                    a2 = node.b - p2.b + a;
+                    a1 = a2 + node.bDiff;
+                }
+
+                // a leaf's incident wave is its state for next time
+                p1.a = a1;
+                p2.a = a2;
+
+                down = op->sendsDown == Carry::port1 ? a1 : a2;
+            }
+
+            return (n[outputIndex].a + n[outputIndex].b) * 0.5f;
+        }
+
+    private:
+        struct Definition
+        {
+            Kind kind = Kind::resistor;
+            float value = 0.f;
+            int port1 = -1, port2 = -1;
+            int parent = -1;
+        };
+
+        enum class Op : uint8_t { series, parallel };
+        enum class Carry : uint8_t { none, port1, port2 };
+
+        struct Instruction
+        {
+            Op type;
+            Carry carried = Carry::none;    // which port's reflected wave is the previous instruction's
+            Carry sendsDown = Carry::none;  // which port's incident wave the next one (going down) takes
+            bool carriedDown = false;       // whether this one's incident wave came from the one before
+            int32_t node, port1, port2;
+        };
+
+        /** Everything one port of the tree holds, packed so an adaptor and its ports are a few cache lines */
+        struct Node
+        {
+            float a = 0.f, b = 0.f;     // incident and reflected waves
+            float R = 1.f, G = 1.f;
+            float reflect = 1.f;        // adaptors: port 1's reflection coefficient
+            float bDiff = 0.f;          // parallel adaptors: carried from reflected to incident
+        };
+
+        static int countKind (const std::vector<Definition>& definitions, Kind kind)
+        {
+            int count = 0;
+
+            for (const auto& d : definitions)
+                count += d.kind == kind ? 1 : 0;
+
+            return count;
+        }
+
+        static bool parseValue (const std::string& text, float& value)
+        {
+            char* end = nullptr;
+            const double number = std::strtod (text.c_str(), &end);
+
+            if (end == text.c_str())
+                return false;
+
+            double scale = 1.0;
+
+            if (*end != '\0')
+            {
+                switch (*end++)
+                {
+                    case 'f': scale = 1.0e-15; break;
+                    case 'p': scale = 1.0e-12; break;
+                    case 'n': scale = 1.0e-9;  break;
+                    case 'u': scale = 1.0e-6;  break;
+                    case 'm': scale = 1.0e-3;  break;
+                    case 'k': scale = 1.0e3;   break;
+                    case 'M': scale = 1.0e6;   break;
+                    default: return false;
+                }
+
+                if (*end != '\0')
+                    return false;
+            }
+
+            value = float (number * scale);
+            return true;
+        }
+
+        /** calcImpedance() for every node, leaves up, the way chowdsp's elements and adaptors do it */
+        void updateImpedances() noexcept
+        {
+            for (int i = 0; i < numLeaves; ++i)
+            {
+                auto& node = nodes[(size_t) i];
+                const float v = values[(size_t) i];
+
+                if (kinds[(size_t) i] == Kind::capacitor)
+                    node.R = 1.f / (2.f * v * fs);
+                else if (kinds[(size_t) i] == Kind::inductor)
+                    node.R = 2.f * v * fs;
+                else
+                    node.R = v;
+
+                node.G = 1.f / node.R;
+            }
+
+            for (const auto& op : program)
+            {
+                auto& node = nodes[(size_t) op.node];
+                const auto& p1 = nodes[(size_t) op.port1];
+                const auto& p2 = nodes[(size_t) op.port2];
+
+                if (op.type == Op::series)
+                {
+                    node.R = p1.R + p2.R;
+                    node.G = 1.f / node.R;
+                    node.reflect = p1.R / node.R;
+                }
+                else
+                {
+                    node.G = p1.G + p2.G;
+                    node.R = 1.f / node.G;
+                    node.reflect = p1.G / node.G;
+                }
+            }
+        }
+
+        float fs = 48000.f;
+
+        std::vector<Node> nodes;
+        std::vector<Instruction> program;
+        std::vector<float> values;
+        std::vector<Kind> kinds;
+        std::vector<std::string> names;
+        std::unordered_map<std::string, int> elementIndices;
+
+        int numCapacitors = 0, numInductors = 0, numLeaves = 0;
+        int rootIndex = 0, outputIndex = 0;
+    };
+}
@@ -0,0 +1,271 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+  ==============================================================================
+*/
+
+#include "RealtimeGuard.h"
+
+#if RCA_ENABLE_REALTIME_GUARD && JUCE_LINUX
+ #include <cerrno>
+ #include <dlfcn.h>
+ #include <pthread.h>
+
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void  __libc_free (void*);
+}
+#elif RCA_ENABLE_REALTIME_GUARD && JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+
+namespace RealtimeGuard
+{
+    namespace
+    {
+        thread_local int scopeDepth = 0;
+        thread_local int exemptionDepth = 0;
+        thread_local bool isReporting = false;
+
+        std::atomic<int> violationCount { 0 };
+        std::atomic<FailureMode> failureMode { FailureMode::assertion };
+
+        const char* getDescription (ViolationType type) noexcept
+        {
+            switch (type)
+            {
+                case ViolationType::allocation:   return "heap allocation";
+                case ViolationType::deallocation: return "heap deallocation";
+                case ViolationType::lock:         return "mutex lock";
+            }
+
+            return "unknown";
+        }
+    }
+
+    bool isInRealtimeScope() noexcept
+    {
+        return scopeDepth > 0 && exemptionDepth == 0 && ! isReporting;
+    }
+
+    void reportIfRealtime (ViolationType type) noexcept
+    {
+        if (! isInRealtimeScope())
+            return;
+
+        // reporting allocates and locks, so the guard is lifted while we do it
+        isReporting = true;
+        ++violationCount;
+
+        juce::Logger::writeToLog (juce::String ("RealtimeGuard: ") + getDescription (type)
+                                  + " on the audio thread\n" + juce::SystemStats::getStackBacktrace());
+
+        isReporting = false;
+
+        if (failureMode.load() == FailureMode::assertion)
+            jassertfalse;
+    }
+
+    void setFailureMode (FailureMode newMode) noexcept  { failureMode = newMode; }
+    int getViolationCount() noexcept                    { return violationCount.load(); }
+    void resetViolationCount() noexcept                 { violationCount = 0; }
+
+    ScopedRealtimeScope::ScopedRealtimeScope() noexcept      { ++scopeDepth; }
+    ScopedRealtimeScope::~ScopedRealtimeScope() noexcept     { --scopeDepth; }
+
+    ScopedRealtimeExemption::ScopedRealtimeExemption() noexcept  { ++exemptionDepth; }
+    ScopedRealtimeExemption::~ScopedRealtimeExemption() noexcept { --exemptionDepth; }
+}
+
+
+#if RCA_ENABLE_REALTIME_GUARD
+
+namespace
+{
+    using RealtimeGuard::ViolationType;
+    using RealtimeGuard::reportIfRealtime;
+
+   #if JUCE_LINUX
+    void* rawAlloc (std::size_t size) noexcept  { return __libc_malloc (size); }
+    void rawFree (void* ptr) noexcept            { __libc_free (ptr); }
+
+    void* rawAlignedAlloc (std::size_t size, std::size_t alignment) noexcept  { return __libc_memalign (alignment, size); }
+    void rawAlignedFree (void* ptr) noexcept                                 { __libc_free (ptr); }
+   #elif JUCE_WINDOWS
+    void* rawAlloc (std::size_t size) noexcept  { return std::malloc (size); }
+    void rawFree (void* ptr) noexcept            { std::free (ptr); }
+
+    // the CRT can't free() these, so aligned blocks go back through their own call
+    void* rawAlignedAlloc (std::size_t size, std::size_t alignment) noexcept  { return _aligned_malloc (size, alignment); }
+    void rawAlignedFree (void* ptr) noexcept                                 { _aligned_free (ptr); }
+   #else
+    void* rawAlloc (std::size_t size) noexcept  { return std::malloc (size); }
+    void rawFree (void* ptr) noexcept            { std::free (ptr); }
+
+    void* rawAlignedAlloc (std::size_t size, std::size_t alignment) noexcept
+    {
+        void* ptr = nullptr;
+        return posix_memalign (&ptr, std::max (alignment, sizeof (void*)), size) == 0 ? ptr : nullptr;
+    }
+
+    void rawAlignedFree (void* ptr) noexcept  { std::free (ptr); }
+   #endif
+
+    void* guardedNew (std::size_t size)
+    {
+        reportIfRealtime (ViolationType::allocation);
+
+        if (auto* ptr = rawAlloc (size == 0 ? 1 : size))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    void* guardedNewNoThrow (std::size_t size) noexcept
+    {
+        reportIfRealtime (ViolationType::allocation);
+        return rawAlloc (size == 0 ? 1 : size);
+    }
+
+    void guardedDelete (void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        reportIfRealtime (ViolationType::deallocation);
+        rawFree (ptr);
+    }
+
+    void* guardedAlignedNew (std::size_t size, std::align_val_t alignment)
+    {
+        reportIfRealtime (ViolationType::allocation);
+
+        if (auto* ptr = rawAlignedAlloc (size == 0 ? 1 : size, static_cast<std::size_t> (alignment)))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    void* guardedAlignedNewNoThrow (std::size_t size, std::align_val_t alignment) noexcept
+    {
+        reportIfRealtime (ViolationType::allocation);
+        return rawAlignedAlloc (size == 0 ? 1 : size, static_cast<std::size_t> (alignment));
+    }
+
+    void guardedAlignedDelete (void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        reportIfRealtime (ViolationType::deallocation);
+        rawAlignedFree (ptr);
+    }
+}
+
+void* operator new   (std::size_t size)                           { return guardedNew (size); }
+void* operator new[] (std::size_t size)                           { return guardedNew (size); }
+void* operator new   (std::size_t size, const std::nothrow_t&) noexcept { return guardedNewNoThrow (size); }
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept { return guardedNewNoThrow (size); }
+
+void operator delete   (void* ptr) noexcept                       { guardedDelete (ptr); }
+void operator delete[] (void* ptr) noexcept                       { guardedDelete (ptr); }
+void operator delete   (void* ptr, std::size_t) noexcept          { guardedDelete (ptr); }
+void operator delete[] (void* ptr, std::size_t) noexcept          { guardedDelete (ptr); }
+void operator delete   (void* ptr, const std::nothrow_t&) noexcept { guardedDelete (ptr); }
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept { guardedDelete (ptr); }
+
+void* operator new   (std::size_t size, std::align_val_t alignment)                           { return guardedAlignedNew (size, alignment); }
+void* operator new[] (std::size_t size, std::align_val_t alignment)                           { return guardedAlignedNew (size, alignment); }
+void* operator new   (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return guardedAlignedNewNoThrow (size, alignment); }
+void* operator new[] (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return guardedAlignedNewNoThrow (size, alignment); }
+
+void operator delete   (void* ptr, std::align_val_t) noexcept                           { guardedAlignedDelete (ptr); }
+void operator delete[] (void* ptr, std::align_val_t) noexcept                           { guardedAlignedDelete (ptr); }
+void operator delete   (void* ptr, std::size_t, std::align_val_t) noexcept              { guardedAlignedDelete (ptr); }
+void operator delete[] (void* ptr, std::size_t, std::align_val_t) noexcept              { guardedAlignedDelete (ptr); }
+void operator delete   (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept    { guardedAlignedDelete (ptr); }
+void operator delete[] (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept    { guardedAlignedDelete (ptr); }
+
+
+ #if JUCE_LINUX
+extern "C"
+{
+    void* malloc (size_t size)
+    {
+        reportIfRealtime (ViolationType::allocation);
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t num, size_t size)
+    {
+        reportIfRealtime (ViolationType::allocation);
+        return __libc_calloc (num, size);
+    }
+
+    void* realloc (void* ptr, size_t size)
+    {
+        reportIfRealtime (ViolationType::allocation);
+        return __libc_realloc (ptr, size);
+    }
+
+    void* aligned_alloc (size_t alignment, size_t size)
+    {
+        reportIfRealtime (ViolationType::allocation);
+        return __libc_memalign (alignment, size);
+    }
+
+    int posix_memalign (void** result, size_t alignment, size_t size)
+    {
+        if (alignment < sizeof (void*) || (alignment & (alignment - 1)) != 0)
+            return EINVAL;
+
+        reportIfRealtime (ViolationType::allocation);
+
+        if (auto* ptr = __libc_memalign (alignment, size))
+        {
+            *result = ptr;
+            return 0;
+        }
+
+        return ENOMEM;
+    }
+
+    void free (void* ptr)
+    {
+        if (ptr != nullptr)
+            reportIfRealtime (ViolationType::deallocation);
+
+        __libc_free (ptr);
+    }
+
+    int pthread_mutex_lock (pthread_mutex_t* mutex)
+    {
+        using LockFunction = int (*) (pthread_mutex_t*);
+
+        // constant-initialised, so there's no init guard that would recurse into this lock
+        static std::atomic<LockFunction> realLock { nullptr };
+
+        auto lock = realLock.load (std::memory_order_acquire);
+
+        if (lock == nullptr)
+        {
+            lock = reinterpret_cast<LockFunction> (dlsym (RTLD_NEXT, "pthread_mutex_lock"));
+            realLock.store (lock, std::memory_order_release);
+        }
+
+        reportIfRealtime (ViolationType::lock);
+        return lock (mutex);
+    }
+}
+ #endif
+
+#endif // RCA_ENABLE_REALTIME_GUARD
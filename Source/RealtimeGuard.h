@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Debug helper that flags heap allocation and lock acquisition on the
+    audio thread. Put RCA_SCOPED_REALTIME_GUARD at the top of any function
+    that must stay realtime safe (processBlock).
+
+    - operator new/delete, aligned forms included, are intercepted on every
+      platform.
+    - malloc/calloc/realloc/free, aligned_alloc/posix_memalign and
+      pthread_mutex_lock are interposed on Linux, which only
+      takes effect when this code lives in the main executable (Standalone).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef RCA_ENABLE_REALTIME_GUARD
+ #define RCA_ENABLE_REALTIME_GUARD JUCE_DEBUG
+#endif
+
+
+namespace RealtimeGuard
+{
+    enum class FailureMode
+    {
+        record,     // log the violation with a stack trace and carry on
+        assertion   // log, then hit jassertfalse
+    };
+
+    enum class ViolationType
+    {
+        allocation,
+        deallocation,
+        lock
+    };
+
+    /** True while the calling thread is inside a realtime scope. */
+    bool isInRealtimeScope() noexcept;
+
+    /** Called by the interceptors, reports if the calling thread is in a realtime scope. */
+    void reportIfRealtime (ViolationType type) noexcept;
+
+    void setFailureMode (FailureMode newMode) noexcept;
+
+    /** Number of violations seen since the last call to resetViolationCount(). */
+    int getViolationCount() noexcept;
+    void resetViolationCount() noexcept;
+
+    /** Marks the calling thread as realtime for the lifetime of this object. */
+    class ScopedRealtimeScope
+    {
+    public:
+        ScopedRealtimeScope() noexcept;
+        ~ScopedRealtimeScope() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRealtimeScope)
+    };
+
+    /** Temporarily lifts the guard, e.g. around code that is known to allocate once. */
+    class ScopedRealtimeExemption
+    {
+    public:
+        ScopedRealtimeExemption() noexcept;
+        ~ScopedRealtimeExemption() noexcept;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRealtimeExemption)
+    };
+}
+
+
+#if RCA_ENABLE_REALTIME_GUARD
+ #define RCA_SCOPED_REALTIME_GUARD    RealtimeGuard::ScopedRealtimeScope JUCE_JOIN_MACRO (realtimeGuard_, __LINE__);
+ #define RCA_SCOPED_REALTIME_EXEMPTION RealtimeGuard::ScopedRealtimeExemption JUCE_JOIN_MACRO (realtimeExemption_, __LINE__);
+#else
+ #define RCA_SCOPED_REALTIME_GUARD
+ #define RCA_SCOPED_REALTIME_EXEMPTION
+#endif
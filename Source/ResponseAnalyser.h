@@ -0,0 +1,443 @@
+/*
+  ==============================================================================
+
+    ResponseAnalyser.h
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Computes the filter's magnitude response on a background thread and keeps
+    the last result around, so editors can show it as soon as they open. All
+    open instances share the one thread, which stops with the last of them.
+    With a component tolerance set, it also works out the band most units
+    built from such parts would fall in (see RCA_ToleranceAnalysis.h).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RCA_MKII_SEF.h"
+#include "RCA_ToleranceAnalysis.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/** Everything that affects the shape of the response */
+struct FilterSettings
+{
+    double sampleRate = 48000;
+
+    bool highPassContinuous = true;
+    bool lowPassContinuous = true;
+
+    float highPassCutoff = 20.f;
+    float lowPassCutoff = 20000.f;
+
+    int highPassKnobPos = 1;
+    int lowPassKnobPos = 11;
+
+    /** RCA_MK2_SEF::getKnobTable() id the knob positions come from */
+    int knobTable = 0;
+
+    int highPassMod = 1;
+    int lowPassMod = 1;
+
+    float inputImpedance = 560.f;
+    float outputImpedance = 560.f;
+
+    /** Engine::alpha rather than the bilinear ladder */
+    bool analogMatched = false;
+
+    /** +- fraction the capacitors and inductors may be off by, 0 for no tolerance band */
+    float tolerance = 0.f;
+
+    bool operator== (const FilterSettings& other) const
+    {
+        return sampleRate == other.sampleRate
+            && highPassContinuous == other.highPassContinuous
+            && lowPassContinuous == other.lowPassContinuous
+            && highPassCutoff == other.highPassCutoff
+            && lowPassCutoff == other.lowPassCutoff
+            && highPassKnobPos == other.highPassKnobPos
+            && lowPassKnobPos == other.lowPassKnobPos
+            && knobTable == other.knobTable
+            && highPassMod == other.highPassMod
+            && lowPassMod == other.lowPassMod
+            && inputImpedance == other.inputImpedance
+            && outputImpedance == other.outputImpedance
+            && analogMatched == other.analogMatched
+            && tolerance == other.tolerance;
+    }
+
+    bool operator!= (const FilterSettings& other) const { return ! (*this == other); }
+
+    void applyTo (RCA_MK2_SEF& filter) const
+    {
+        filter.setEngine(analogMatched ? RCA_MK2_SEF::Engine::alpha : RCA_MK2_SEF::Engine::wdfTree);
+
+        filter.setHighPassMod(highPassMod);
+        filter.setLowPassMod(lowPassMod);
+        filter.setKnobTable(knobTable);
+
+        if (highPassContinuous)
+            filter.setHighPassCutoff(highPassCutoff);
+        else
+            filter.setHighPassKnobPos(highPassKnobPos);
+
+        if (lowPassContinuous)
+            filter.setLowPassCutoff(lowPassCutoff);
+        else
+            filter.setLowPassKnobPos(lowPassKnobPos);
+
+        filter.setInputImpedance(inputImpedance);
+        filter.setOutputImpedance(outputImpedance);
+    }
+};
+
+
+class ResponseAnalyser
+{
+public:
+    /** Coarse is a handful of analytic points for use while a knob is being dragged */
+    enum class Resolution
+    {
+        coarse,
+        full
+    };
+    
+    static constexpr int numCoarsePoints = 128;
+    
+    /** The full response is an FFT of the first 2^fftOrder samples of the impulse response */
+    static constexpr int fftOrder = 13;
+    static constexpr int fftSize = 2 << fftOrder;
+    
+    /** Log-spaced frequencies of the coarse points, 20 Hz to 20 kHz */
+    static float getCoarseFrequency (int index)
+    {
+        return 20.f * std::pow(1000.f, float(index) / float(numCoarsePoints - 1));
+    }
+    
+    /** Trials behind the tolerance band, and the percentiles its edges are drawn at */
+    static constexpr int numToleranceTrials = 1024;
+    static constexpr float toleranceLowPercentile = 5.f;
+    static constexpr float toleranceHighPercentile = 95.f;
+    
+    struct Result
+    {
+        std::array<float, fftSize> mags;
+        std::array<float, numCoarsePoints> coarseMags;
+        bool isCoarse = false;
+        
+        /** At the coarse frequencies, whatever the resolution */
+        std::array<float, numCoarsePoints> toleranceLow, toleranceHigh;
+        bool hasTolerance = false;
+    };
+
+    ResponseAnalyser()
+    {
+        latest.mags.fill(0.f);
+        latest.coarseMags.fill(0.f);
+        latest.toleranceLow.fill(0.f);
+        latest.toleranceHigh.fill(0.f);
+        
+        worker->add(*this);
+    }
+
+    ~ResponseAnalyser()
+    {
+        worker->remove(*this);
+    }
+
+    /** Queues a recompute for the given settings. Returns immediately; does nothing if they're already analysed */
+    void requestUpdate (const FilterSettings& settings, Resolution resolution = Resolution::full)
+    {
+        {
+            const juce::ScopedLock sl(settingsLock);
+            pendingSettings = settings;
+            pendingResolution = resolution;
+        }
+
+        ++requested;
+        worker->wake();
+    }
+
+    /** True while a requested update hasn't been published yet */
+    bool isUpdatePending() const noexcept
+    {
+        return completed.load() != requested.load();
+    }
+
+    /** Incremented every time a new response is published */
+    int getVersion() const noexcept
+    {
+        return version.load();
+    }
+
+    /** Copies the most recent response, returning its version (0 if nothing has been computed yet) */
+    int getLatest (Result& dest) const
+    {
+        const juce::ScopedLock sl(resultLock);
+        
+        dest.isCoarse = latest.isCoarse;
+        
+        if (latest.isCoarse)
+            dest.coarseMags = latest.coarseMags;
+        else
+            dest.mags = latest.mags;
+        
+        dest.hasTolerance = latest.hasTolerance;
+        
+        if (latest.hasTolerance)
+        {
+            dest.toleranceLow = latest.toleranceLow;
+            dest.toleranceHigh = latest.toleranceHigh;
+        }
+        
+        return version.load();
+    }
+
+private:
+    /**
+     * One analysis thread, shared like the coefficient cache's fill thread by however many
+     * instances are open. It owns the filter, FFT and scratch space the work needs and goes
+     * round the analysers taking whatever each has asked for.
+     */
+    class Worker
+    {
+    public:
+        Worker() : thread([this] { run(); }) {}
+        
+        ~Worker()
+        {
+            {
+                const std::lock_guard<std::mutex> lock(wakeLock);
+                shouldExit = true;
+            }
+            
+            wakeUp.notify_one();
+            thread.join();
+        }
+        
+        void add(ResponseAnalyser& analyser)
+        {
+            const std::lock_guard<std::mutex> lock(listLock);
+            analysers.push_back(&analyser);
+        }
+        
+        /**
+         * Waits for an analysis of this analyser already under way to finish, so it can go once
+         * this returns. Other instances' analyses don't hold it up.
+         */
+        void remove(ResponseAnalyser& analyser)
+        {
+            std::unique_lock<std::mutex> lock(listLock);
+            analysers.erase(std::remove(analysers.begin(), analysers.end(), &analyser), analysers.end());
+            
+            finishedCurrent.wait(lock, [this, &analyser] { return current != &analyser; });
+        }
+        
+        void wake()
+        {
+            {
+                const std::lock_guard<std::mutex> lock(wakeLock);
+                hasWork = true;
+            }
+            
+            wakeUp.notify_one();
+        }
+        
+    private:
+        void run()
+        {
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(wakeLock);
+                    wakeUp.wait(lock, [this] { return hasWork || shouldExit; });
+                    
+                    if (shouldExit)
+                        return;
+                    
+                    hasWork = false;
+                }
+                
+                // a request that comes in part way round sets hasWork again, so nothing is missed
+                {
+                    const std::lock_guard<std::mutex> lock(listLock);
+                    round = analysers;
+                }
+                
+                for (auto* analyser : round)
+                {
+                    {
+                        const std::lock_guard<std::mutex> lock(listLock);
+                        
+                        // removed since the round started
+                        if (std::find(analysers.begin(), analysers.end(), analyser) == analysers.end())
+                            continue;
+                        
+                        current = analyser;
+                    }
+                    
+                    analyse(*analyser);
+                    
+                    {
+                        const std::lock_guard<std::mutex> lock(listLock);
+                        current = nullptr;
+                    }
+                    
+                    finishedCurrent.notify_all();
+                }
+            }
+        }
+        
+        void analyse(ResponseAnalyser& analyser)
+        {
+            const int request = analyser.requested.load();
+
+            if (request == analyser.completed.load())
+                return;
+
+            FilterSettings settings;
+            Resolution resolution;
+
+            {
+                const juce::ScopedLock sl(analyser.settingsLock);
+                settings = analyser.pendingSettings;
+                resolution = analyser.pendingResolution;
+            }
+            
+            // a full result also satisfies a coarse request for the same settings; only this thread writes latest
+            const bool isUpToDate = analyser.version.load() > 0
+                                 && settings == analyser.analysedSettings
+                                 && (resolution == Resolution::coarse || ! analyser.latest.isCoarse);
+
+            if (! isUpToDate)
+            {
+                if (settings.sampleRate != preparedSampleRate)
+                {
+                    filter.prepare(float(settings.sampleRate));
+                    preparedSampleRate = settings.sampleRate;
+                }
+
+                settings.applyTo(filter);
+                
+                scratch.isCoarse = resolution == Resolution::coarse;
+                
+                if (scratch.isCoarse)
+                    filter.computeMagnitudeResponse(coarseFrequencies.data(), scratch.coarseMags.data(), numCoarsePoints);
+                else
+                    computeFullResponse();
+                
+                scratch.hasTolerance = settings.tolerance > 0.f;
+                
+                if (scratch.hasTolerance)
+                    computeToleranceBand(settings);
+
+                {
+                    const juce::ScopedLock sl(analyser.resultLock);
+                    auto& latest = analyser.latest;
+                    latest.isCoarse = scratch.isCoarse;
+                    
+                    if (scratch.isCoarse)
+                        latest.coarseMags = scratch.coarseMags;
+                    else
+                        latest.mags = scratch.mags;
+                    
+                    latest.hasTolerance = scratch.hasTolerance;
+                    latest.toleranceLow = scratch.toleranceLow;
+                    latest.toleranceHigh = scratch.toleranceHigh;
+                }
+
+                analyser.analysedSettings = settings;
+                ++analyser.version;
+            }
+
+            analyser.completed = request;
+        }
+        
+        void computeFullResponse()
+        {
+            auto& data = scratch.mags;
+            
+            filter.computeImpulseResponse(data.data(), fft.getSize());
+            std::fill(data.begin() + fft.getSize(), data.end(), 0.f);
+            
+            fft.performFrequencyOnlyForwardTransform(data.data(), true);
+        }
+        
+        /** Around the components the filter has just been set to; the same seed every time, so the band holds still */
+        void computeToleranceBand(const FilterSettings& settings)
+        {
+            ToleranceAnalysis::Settings trials;
+            trials.nominal = filter.getComponentValues();
+            trials.capacitorTolerance = settings.tolerance;
+            trials.inductorTolerance = settings.tolerance;
+            trials.numTrials = numToleranceTrials;
+            trials.sampleRate = settings.analogMatched ? 0.0 : settings.sampleRate;
+            
+            const float percentiles[] = {toleranceLowPercentile, toleranceHighPercentile};
+            toleranceAnalyser.run(trials, coarseFrequencies.data(), numCoarsePoints, percentiles, 2);
+            
+            std::copy(toleranceAnalyser.getEnvelope(0), toleranceAnalyser.getEnvelope(0) + numCoarsePoints, scratch.toleranceLow.begin());
+            std::copy(toleranceAnalyser.getEnvelope(1), toleranceAnalyser.getEnvelope(1) + numCoarsePoints, scratch.toleranceHigh.begin());
+        }
+        
+        static std::array<float, numCoarsePoints> makeCoarseFrequencies()
+        {
+            std::array<float, numCoarsePoints> freqs;
+            
+            for (int i = 0; i < numCoarsePoints; ++i)
+                freqs[i] = getCoarseFrequency(i);
+            
+            return freqs;
+        }
+
+        RCA_MK2_SEF filter;
+        double preparedSampleRate = 0.0;
+        
+        juce::dsp::FFT fft {fftOrder};
+        ToleranceAnalysis::Analyser toleranceAnalyser;
+        Result scratch;
+        
+        const std::array<float, numCoarsePoints> coarseFrequencies = makeCoarseFrequencies();
+        
+        /** Only held to change the list or say which analyser is being worked on, never across an analysis */
+        std::mutex listLock;
+        std::vector<ResponseAnalyser*> analysers;
+        ResponseAnalyser* current = nullptr;
+        std::condition_variable finishedCurrent;
+        
+        /** This thread's copy of the list, to go round without holding listLock */
+        std::vector<ResponseAnalyser*> round;
+        
+        std::mutex wakeLock;
+        std::condition_variable wakeUp;
+        bool hasWork = false;
+        bool shouldExit = false;
+        
+        // last, so everything above is there before it starts
+        std::thread thread;
+    };
+
+    juce::SharedResourcePointer<Worker> worker;
+
+    FilterSettings analysedSettings;
+
+    juce::CriticalSection settingsLock;
+    FilterSettings pendingSettings;
+    Resolution pendingResolution = Resolution::full;
+
+    juce::CriticalSection resultLock;
+    Result latest;
+
+    std::atomic<int> requested {0};
+    std::atomic<int> completed {0};
+    std::atomic<int> version {0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseAnalyser)
+};
@@ -18,6 +18,7 @@
 
 class ResponseCurveComponent : public LabeledComponent,
                                       juce::AudioProcessorParameter::Listener,
+                                      juce::AsyncUpdater,
                                       juce::Timer
 
 {
@@ -28,106 +29,321 @@ public:
         const auto& params = proc.getParameters();
 
         for (auto& param : params)
+        {
             param->addListener(this);
+            
+            if (auto* p = dynamic_cast<juce::AudioProcessorParameterWithID*>(param))
+                if (p->paramID == "OUTPUT_GAIN")
+                    gainParameterIndex = p->getParameterIndex();
+        }
         
-        updateMags();
-        updateResponseCurve();
+        // show whatever the processor analysed last, and refresh it in the background
+        gain = proc_.getCurrentGain();
+        fetchLatestResponse();
         
-        startTimerHz(30);
+        proc_.requestResponseUpdate();
+        wakeUp();
 
     }
     
-    void updateMags()
+    ~ResponseCurveComponent() override
     {
-        gain = proc_.getCurrentGain();
-        proc_.computeMagnitudeResponse(mags);
-
+        for (auto& param : proc_.getParameters())
+            param->removeListener(this);
+        
+        cancelPendingUpdate();
+    }
+    
+    /** Copies the processor's cached response, this never runs the analysis itself */
+    void fetchLatestResponse()
+    {
+        displayedVersion = proc_.getResponseAnalyser().getLatest(response);
+        decimateMags();
     }
     
     
+    /** Rebuilds the path from the per-column magnitudes, scaled by the current gain */
     void updateResponseCurve()
     {
-
-        juce::MessageManager::callAsync([&]()
+        auto bounds = getAnalysisArea();
+        
+        float bottom = bounds.getBottom();
+        float top = bounds.getY();
+        
+        auto toY = [&](float mag)
+        {
+            return juce::jmax(top, juce::jmap(mag * gain, 0.f, 2.f, bottom, top));
+        };
+        
+        responseCurve.clear();
+        toleranceBand.clear();
+        
+        if (columns.empty())
         {
             repaint();
-
-            auto bounds = getAnalysisArea();
-            auto left = bounds.getX();
-            auto width = bounds.getWidth();
-
-            const auto fs = proc_.getSampleRate();
+            return;
+        }
+        
+        // the tolerance band: along the top edge, then back along the bottom
+        if (response.hasTolerance)
+        {
+            toleranceBand.startNewSubPath(columns[0].x, toY(columnHigh[0]));
             
-            float bottom = bounds.getBottom();
-            float top = bounds.getY();
+            for (size_t c = 1; c < columns.size(); ++c)
+                toleranceBand.lineTo(columns[c].x, toY(columnHigh[c]));
             
-            responseCurve.clear();
-            responseCurve.startNewSubPath(left, juce::jmap(mags[0], 0.f, 2.f, bottom, top));
-
-            for (int i = 0; i < n2; ++i)
-            {
-                float freq = i == 0 ? 20 : (i * fs / n2);
-                
-                float logFreq = juce::jmap(std::log10(freq), log20, log20k, 0.f, 1.f);
-                
-                float xVal = left + width * logFreq;
-                xVal = std::clamp(xVal, float(left), float(left + width));
-
-                auto mag = jmap(mags[i] * gain, 0.f, 2.f, float(bottom), float(top));
-                if (mag < top)
-                    mag = top;
+            for (size_t c = columns.size(); c-- > 0;)
+                toleranceBand.lineTo(columns[c].x, toY(columnLow[c]));
+            
+            toleranceBand.closeSubPath();
+        }
+        
+        float lastY = toY(columnMax[0]);
+        responseCurve.startNewSubPath(columns[0].x, lastY);
 
-                responseCurve.lineTo(xVal, mag);
-                
-            }
-            needsUpdate = false;
-        });
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            const float x = columns[c].x;
+            const float yMin = toY(columnMin[c]);
+            const float yMax = toY(columnMax[c]);
+            
+            // visit the extreme nearest the previous point first to keep the line continuous
+            const bool maxFirst = std::abs(yMax - lastY) < std::abs(yMin - lastY);
+            
+            responseCurve.lineTo(x, maxFirst ? yMax : yMin);
+            
+            if (yMin != yMax)
+                responseCurve.lineTo(x, maxFirst ? yMin : yMax);
+            
+            lastY = maxFirst ? yMin : yMax;
+        }
         
+        repaint();
     }
     
     
-    
+    /** Marks the filter response as stale, e.g. after a MOD or CONTROLS toggle */
     void responseCurveChanged(bool b)
     {
-        needsUpdate = b;
+        if (b)
+        {
+            filterNeedsUpdate = true;
+            wakeUp();
+        }
     }
 
     void hide(bool b)
     {
         isHidden = b;
+        
+        if (isHidden)
+            stopTimer();
+        else
+            wakeUp();
     }
     
     
 private:
     
+    /** Runs at most one update per frame, and stops once there is nothing left to do */
     void timerCallback() override
     {
-        if (needsUpdate && ! isHidden)
+        if (isHidden)
         {
-
-            updateMags();
-            updateResponseCurve();
+            stopTimer();
+            return;
+        }
+        
+        auto& analyser = proc_.getResponseAnalyser();
+        const auto now = juce::Time::getMillisecondCounter();
+        
+        if (filterNeedsUpdate.exchange(false))
+        {
+            // while a knob is held, a cheap coarse curve keeps up with the mouse
+            if (activeGestures.load() > 0)
+            {
+                proc_.requestResponseUpdate(ResponseAnalyser::Resolution::coarse);
+                lastCoarseRequestTime = now;
+                needsRefinement = true;
+            }
+            else
+            {
+                proc_.requestResponseUpdate(ResponseAnalyser::Resolution::full);
+                needsRefinement = false;
+            }
+        }
+        else if (needsRefinement && now - lastCoarseRequestTime > settleTimeMs)
+        {
+            // the value has settled, even if the knob is still held
+            proc_.requestResponseUpdate(ResponseAnalyser::Resolution::full);
+            needsRefinement = false;
+        }
+        
+        bool curveChanged = false;
+        
+        if (analyser.getVersion() != displayedVersion)
+        {
+            fetchLatestResponse();
+            curveChanged = true;
         }
         
+        if (gainNeedsUpdate.exchange(false))
+        {
+            // the cached magnitudes are still valid, only the y scaling changes
+            gain = proc_.getCurrentGain();
+            curveChanged = true;
+        }
+        
+        if (curveChanged)
+            updateResponseCurve();
+        else if (! analyser.isUpdatePending() && ! needsRefinement)
+            stopTimer();
+    }
+    
+    void handleAsyncUpdate() override
+    {
+        wakeUp();
+    }
+    
+    void wakeUp()
+    {
+        if (! isHidden && ! isTimerRunning())
+            startTimerHz(frameRate);
     }
 
     void parameterGestureChanged (int parameterIndex, bool gestureIsStarting) override
     {
-        needsUpdate = true;
+        if (parameterIndex == gainParameterIndex)
+            return;
+        
+        if (gestureIsStarting)
+        {
+            ++activeGestures;
+        }
+        else
+        {
+            if (--activeGestures < 0)
+                activeGestures = 0;
+            
+            // refine to full resolution now the knob has been let go
+            filterNeedsUpdate = true;
+            triggerAsyncUpdate();
+        }
     }
 
+    /** May be called from any thread, so just flag what changed and let the timer coalesce it */
     void parameterValueChanged (int parameterIndex, float newValue) override
     {
-        needsUpdate = true;
+        if (parameterIndex == gainParameterIndex)
+            gainNeedsUpdate = true;
+        else
+            filterNeedsUpdate = true;
+        
+        triggerAsyncUpdate();
     }
 
     
     void resized() override
     {
+        backgroundImage = {};
+        updateColumnLookup();
+        decimateMags();
         updateResponseCurve();
     }
     
     
+    /** Maps every FFT bin between 20 Hz and 20 kHz onto the pixel column it is drawn in */
+    void updateColumnLookup()
+    {
+        columns.clear();
+        
+        auto bounds = getAnalysisArea();
+        const int left = bounds.getX();
+        const int width = bounds.getWidth();
+        const double fs = proc_.getSampleRate() > 0 ? proc_.getSampleRate() : 48000.0;
+        
+        lookupSampleRate = fs;
+        
+        if (width <= 0)
+            return;
+        
+        for (int i = 0; i <= n2 / 2; ++i)
+        {
+            const float freq = i == 0 ? 20.f : float(i * fs / n2);
+            
+            if (freq > 20000.f)
+                break;
+            
+            const float logFreq = juce::jmap(std::log10(freq), log20, log20k, 0.f, 1.f);
+            const int column = juce::jlimit(0, width, juce::roundToInt(width * logFreq));
+            
+            if (columns.empty() || columns.back().column != column)
+                columns.push_back({column, float(left + column), i, i + 1});
+            else
+                columns.back().endBin = i + 1;
+        }
+        
+        columnMin.resize(columns.size());
+        columnMax.resize(columns.size());
+        columnLow.resize(columns.size());
+        columnHigh.resize(columns.size());
+    }
+    
+    /** Reduces the cached magnitudes to one min/max pair per pixel column */
+    void decimateMags()
+    {
+        if (lookupSampleRate != proc_.getSampleRate() && proc_.getSampleRate() > 0)
+            updateColumnLookup();
+        
+        if (response.hasTolerance)
+        {
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                columnLow[c] = interpolateCoarse(response.toleranceLow, c);
+                columnHigh[c] = interpolateCoarse(response.toleranceHigh, c);
+            }
+        }
+        
+        if (response.isCoarse)
+        {
+            interpolateCoarseMags();
+            return;
+        }
+        
+        const auto& mags = response.mags;
+        
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            const auto range = std::minmax_element(mags.begin() + columns[c].startBin,
+                                                   mags.begin() + columns[c].endBin);
+            columnMin[c] = *range.first;
+            columnMax[c] = *range.second;
+        }
+    }
+    
+    void interpolateCoarseMags()
+    {
+        for (size_t c = 0; c < columns.size(); ++c)
+        {
+            const float mag = interpolateCoarse(response.coarseMags, c);
+            
+            columnMin[c] = mag;
+            columnMax[c] = mag;
+        }
+    }
+    
+    /** The coarse points are log-spaced over the same 20 Hz - 20 kHz span as the x axis */
+    float interpolateCoarse(const std::array<float, ResponseAnalyser::numCoarsePoints>& coarse, size_t c)
+    {
+        const int width = getAnalysisArea().getWidth();
+        const int lastPoint = ResponseAnalyser::numCoarsePoints - 1;
+        
+        const float pos = width > 0 ? lastPoint * float(columns[c].column) / float(width) : 0.f;
+        const int i = juce::jlimit(0, lastPoint - 1, int(pos));
+        return juce::jmap(pos - float(i), coarse[i], coarse[i + 1]);
+    }
+    
+    
     juce::Rectangle<int> getAnalysisArea()
     {
         auto bounds = getLocalBounds();
@@ -145,25 +361,35 @@ private:
 
     void paint(juce::Graphics& g) override
     {
-
-        g.setColour(Colours::white);
-        g.strokePath(responseCurve, PathStrokeType(2.f));
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
         
-        auto bounds = getAnalysisArea();
+        if (backgroundImage.isNull() || scale != backgroundScale)
+            renderBackground(scale);
         
-        g.setColour(juce::Colours::green);
+        g.drawImage(backgroundImage, getLocalBounds().toFloat());
 
-        int rectWidth = bounds.getWidth();
-        int rectHeight = bounds.getHeight();
+        g.setColour(Colours::white.withAlpha(0.15f));
+        g.fillPath(toleranceBand);
         
-        int x = bounds.getWidth() / 2 - rectWidth / 2;
-        int y = bounds.getHeight() / 2 - rectHeight / 2;
-
-        juce::Rectangle<int> centeredBounds(x, y, rectWidth, rectHeight);
+        g.setColour(Colours::white);
+        g.strokePath(responseCurve, PathStrokeType(2.f));
 
+    }
+    
+    /** Grid and labels only change with the component size, so they're drawn once into an image */
+    void renderBackground(float scale)
+    {
+        backgroundScale = scale;
+        backgroundImage = juce::Image(juce::Image::ARGB,
+                                      juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+                                      juce::jmax(1, juce::roundToInt(getHeight() * scale)),
+                                      true);
+        
+        juce::Graphics g(backgroundImage);
+        g.addTransform(juce::AffineTransform::scale(scale));
+        
         drawBackgroundGrid(g);
         drawTextLabels(g);
-
     }
     
     void drawTextLabels(juce::Graphics &g)
@@ -314,16 +540,46 @@ private:
     const float log20 = std::log10(20.f);
     const float log20k = std::log10(20000.f);
     
-    bool needsUpdate = true;
+    const int frameRate = 60;
+    
+    std::atomic<bool> filterNeedsUpdate {false};
+    std::atomic<bool> gainNeedsUpdate {false};
     bool isHidden = false;
     
+    int gainParameterIndex = -1;
+    int displayedVersion = 0;
+    
+    std::atomic<int> activeGestures {0};
+    bool needsRefinement = false;
+    juce::uint32 lastCoarseRequestTime = 0;
+    const juce::uint32 settleTimeMs = 150;
+    
     float gain;
     
     RCAMKIISoundEffectsFilterAudioProcessor& proc_;
     juce::Path responseCurve;
+    juce::Path toleranceBand;
+    
+    juce::Image backgroundImage;
+    float backgroundScale = 1.f;
+    
+    struct Column
+    {
+        int column;
+        float x;
+        int startBin;
+        int endBin;
+    };
+    
+    std::vector<Column> columns;
+    std::vector<float> columnMin;
+    std::vector<float> columnMax;
+    std::vector<float> columnLow;   // tolerance band edges
+    std::vector<float> columnHigh;
+    double lookupSampleRate = 0;
     
-    std::array<float, fftSize> mags;
-    const int n2 = (int) mags.size() / 2;
+    ResponseAnalyser::Result response;
+    const int n2 = (int) response.mags.size() / 2;
 
 };
 
@@ -32,6 +32,8 @@ public:
         
         responseCurveToggle.setLookAndFeel(&tlnf);
         addAndMakeVisible(responseCurveToggle);
+        
+        addAndMakeVisible(knobTableButton);
         resized();
     }
 
@@ -77,9 +79,14 @@ public:
         
         toggleLabel.setBounds(toggleWidth - labelToToggleMargin- responseCurveToggleWidth, margin, labelWidth, logoSize);
         
+        int knobTableButtonWidth = 100;
+        knobTableButton.setBounds(toggleWidth - labelToToggleMargin - responseCurveToggleWidth - margin - knobTableButtonWidth,
+                                  margin / 2, knobTableButtonWidth, getHeight() - margin);
+        
     }
     
     juce::ToggleButton responseCurveToggle;
+    juce::TextButton knobTableButton {"KNOB TABLE"};
 
 private:
     juce::String pluginName {"RCA MK II SOUND EFFECTS FILTER"};
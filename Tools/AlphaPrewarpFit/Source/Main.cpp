@@ -0,0 +1,281 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Fits the alpha-transform engine's per-section warp and writes it out as
+    Source/RCA_AlphaPrewarpTable.h. Run it again, and commit the result, after
+    anything that changes the ladder's topology or design equations:
+
+        "RCA MK II Alpha Prewarp Fit" ../../Source/RCA_AlphaPrewarpTable.h
+
+    For each section (HP, LP), mod setting and normalised cutoff fc / fs, it
+    looks for the alpha and the component scale that bring the digital section
+    closest to the analog one, over everything within 24 dB of the passband up
+    to 95% of Nyquist. The other section is left analog, so it drops out.
+    Past maxCutoff the LP passband is all that's left below Nyquist and the fit
+    stops meaning much, so the table ends there and lookups clamp.
+
+  ==============================================================================
+*/
+
+#include "../../../Source/RCA_MKII_SEF.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+
+namespace
+{
+    using Complex = std::complex<double>;
+
+    constexpr int numPoints = 48;
+    constexpr double minCutoff = 0.002;
+    constexpr double maxCutoff = 0.75;
+
+    constexpr int numFrequencies = 256;
+    constexpr double floorDb = -24.0;
+
+    double getNormalisedCutoff (int index)
+    {
+        return minCutoff * std::pow (maxCutoff / minCutoff, double (index) / double (numPoints - 1));
+    }
+
+    /** The alpha transform's s at w radians per sample, at fs = 1 */
+    Complex alphaTransform (double w, double alpha)
+    {
+        const auto zInv = std::exp (Complex (0.0, -w));
+        return (1.0 + alpha) * (1.0 - zInv) / (1.0 + alpha * zInv);
+    }
+
+    struct Section
+    {
+        bool isHighPass;
+        bool mod;
+        double cutoff;
+
+        std::vector<double> w;
+        std::vector<double> targetDb;
+
+        Section (bool isHighPassToUse, bool modToUse, double cutoffToUse)
+            : isHighPass (isHighPassToUse), mod (modToUse), cutoff (cutoffToUse)
+        {
+            // fs = 1, with the other section parked far outside the band
+            components.setHighPassCutoff (isHighPass ? cutoff : 1.0e-7, mod, 560.0);
+            components.setLowPassCutoff (isHighPass ? 1.0e4 : cutoff, mod, 560.0);
+
+            for (int i = 0; i < numFrequencies; ++i)
+            {
+                const double f = 1.0e-4 * std::pow (0.475 / 1.0e-4, double (i) / double (numFrequencies - 1));
+                const auto s = Complex (0.0, LadderComponentsT<double>::twoPi * f);
+                const double db = 20.0 * std::log10 (std::abs (ladderTransferFunction (components, s)));
+
+                if (db > floorDb)
+                {
+                    w.push_back (LadderComponentsT<double>::twoPi * f);
+                    targetDb.push_back (db);
+                }
+            }
+        }
+
+        double getDb (Complex sDigital, Complex sAnalog) const
+        {
+            const auto h = isHighPass ? ladderTransferFunction (components, sDigital, sAnalog)
+                                      : ladderTransferFunction (components, sAnalog, sDigital);
+
+            return 20.0 * std::log10 (std::abs (h));
+        }
+
+        /** An L8 norm of the dB error: close to the worst case, but smooth enough to descend */
+        double getError (double alpha, double logScale) const
+        {
+            if (alpha < 0.05 || alpha > 1.0)
+                return 1.0e9;
+
+            const double scale = std::exp (logScale);
+            double sum = 0.0;
+
+            for (size_t i = 0; i < w.size(); ++i)
+            {
+                const auto sDigital = scale * alphaTransform (w[i], alpha);
+                const auto sAnalog = Complex (0.0, w[i]);
+
+                const double db = getDb (sDigital, sAnalog);
+                sum += std::pow (db - targetDb[i], 8.0);
+            }
+
+            return std::pow (sum / double (w.size()), 1.0 / 8.0);
+        }
+
+        double getWorstError (double alpha, double logScale) const
+        {
+            double worst = 0.0;
+            const double scale = std::exp (logScale);
+
+            for (size_t i = 0; i < w.size(); ++i)
+            {
+                const auto sDigital = scale * alphaTransform (w[i], alpha);
+                const auto sAnalog = Complex (0.0, w[i]);
+
+                const double db = getDb (sDigital, sAnalog);
+                worst = std::max (worst, std::abs (db - targetDb[i]));
+            }
+
+            return worst;
+        }
+
+        LadderComponentsT<double> components;
+    };
+
+    /** Plain Nelder-Mead over (alpha, log scale) */
+    void minimise (const Section& section, double& alpha, double& logScale)
+    {
+        struct Vertex { double x[2]; double f; };
+
+        auto evaluate = [&] (Vertex& v) { v.f = section.getError (v.x[0], v.x[1]); };
+
+        Vertex simplex[3] = { { { alpha, logScale }, 0.0 },
+                              { { alpha - 0.05, logScale }, 0.0 },
+                              { { alpha, logScale - 0.05 }, 0.0 } };
+
+        for (auto& v : simplex)
+            evaluate (v);
+
+        for (int iteration = 0; iteration < 400; ++iteration)
+        {
+            std::sort (std::begin (simplex), std::end (simplex), [] (const Vertex& a, const Vertex& b) { return a.f < b.f; });
+
+            if (simplex[2].f - simplex[0].f < 1.0e-9)
+                break;
+
+            const double centre[2] = { 0.5 * (simplex[0].x[0] + simplex[1].x[0]), 0.5 * (simplex[0].x[1] + simplex[1].x[1]) };
+
+            auto along = [&] (double t)
+            {
+                Vertex v { { centre[0] + t * (simplex[2].x[0] - centre[0]), centre[1] + t * (simplex[2].x[1] - centre[1]) }, 0.0 };
+                evaluate (v);
+                return v;
+            };
+
+            const auto reflected = along (-1.0);
+
+            if (reflected.f < simplex[0].f)
+            {
+                const auto expanded = along (-2.0);
+                simplex[2] = expanded.f < reflected.f ? expanded : reflected;
+            }
+            else if (reflected.f < simplex[1].f)
+            {
+                simplex[2] = reflected;
+            }
+            else
+            {
+                const auto contracted = along (0.5);
+
+                if (contracted.f < simplex[2].f)
+                {
+                    simplex[2] = contracted;
+                }
+                else
+                {
+                    for (int i = 1; i < 3; ++i)
+                    {
+                        for (int d = 0; d < 2; ++d)
+                            simplex[i].x[d] = 0.5 * (simplex[0].x[d] + simplex[i].x[d]);
+
+                        evaluate (simplex[i]);
+                    }
+                }
+            }
+        }
+
+        std::sort (std::begin (simplex), std::end (simplex), [] (const Vertex& a, const Vertex& b) { return a.f < b.f; });
+        alpha = simplex[0].x[0];
+        logScale = simplex[0].x[1];
+    }
+
+    void writeTable (std::FILE* out, const char* name, bool isHighPass)
+    {
+        std::fprintf (out, "    constexpr float %s[2][numPoints][2] =\n    {\n", name);
+
+        for (int mod = 0; mod < 2; ++mod)
+        {
+            std::fprintf (out, "        {   // mod %s\n", mod ? "on" : "off");
+
+            // warm-start each point from the last, so the table comes out smooth
+            double alpha = 1.0;
+            double logScale = 0.0;
+
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const double cutoff = getNormalisedCutoff (i);
+                const Section section (isHighPass, mod != 0, cutoff);
+
+                if (! section.w.empty())
+                    minimise (section, alpha, logScale);
+
+                const double bilinearDb = section.w.empty() ? 0.0 : section.getWorstError (1.0, 0.0);
+                const double fittedDb = section.w.empty() ? 0.0 : section.getWorstError (alpha, logScale);
+
+                std::fprintf (out, "            { %.6ff, %.6ff },  // fc/fs %.4f: worst %.2f dB, bilinear %.2f dB\n",
+                              alpha, std::exp (logScale), cutoff, fittedDb, bilinearDb);
+            }
+
+            std::fprintf (out, "        },\n");
+        }
+
+        std::fprintf (out, "    };\n");
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    std::FILE* out = argc > 1 ? std::fopen (argv[1], "w") : stdout;
+
+    if (out == nullptr)
+    {
+        std::fprintf (stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::fprintf (out,
+        "/*\n"
+        "  ==============================================================================\n"
+        "\n"
+        "    RCA_AlphaPrewarpTable.h\n"
+        "\n"
+        "    Generated by Tools/AlphaPrewarpFit. Don't edit by hand, run it again.\n"
+        "\n"
+        "  ==============================================================================\n"
+        "*/\n"
+        "\n"
+        "#pragma once\n"
+        "\n"
+        "\n"
+        "namespace AlphaPrewarpTable\n"
+        "{\n"
+        "    constexpr int numPoints = %d;\n"
+        "\n"
+        "    /** Normalised cutoffs fc / fs of the first and last points, which are log-spaced */\n"
+        "    constexpr double minCutoff = %g;\n"
+        "    constexpr double maxCutoff = %g;\n"
+        "\n"
+        "    /** {alpha, component scale} per point, [mod off / on][point] */\n",
+        numPoints, minCutoff, maxCutoff);
+
+    writeTable (out, "highPass", true);
+    std::fprintf (out, "\n");
+    writeTable (out, "lowPass", false);
+
+    std::fprintf (out, "}\n");
+
+    if (out != stdout)
+        std::fclose (out);
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Fits every knob position's C and L to a unit's measured responses and
+    writes a knob table for the plugin's KNOB TABLE button:
+
+        "RCA MK II Component Fit" measurements/ fitted.txt [--mod] [--impedance 560]
+                                  [--range 60] [--threads N]
+
+    measurements/ holds hp1.csv ... hp11.csv and lp1.csv ... lp11.csv, one per
+    knob position, each line a frequency in Hz and a level in dB. The HP
+    positions are measured with the LP knob at 11 and the LP positions with
+    the HP knob at 1, both MOD switches off (or both on, with --mod), between
+    a source and load whose geometric mean is --impedance ohms (a response
+    can't tell the impedance level, see RCA_ComponentFit.h). Positions without
+    a file keep the built-in values.
+
+    All 22 fits run at once over the cores. Each also fits how Rin and Rt
+    split around --impedance, so that a source or load a little off doesn't
+    pull C and L with it; they go in the table's comments, as the plugin's
+    Z INPUT and Z OUTPUT stay the user's.
+
+  ==============================================================================
+*/
+
+#include "../../../Source/RCA_ComponentFit.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    using ComponentFit::Section;
+
+    constexpr int numKnobPositions = 11;
+
+    struct Options
+    {
+        std::string measurementDirectory;
+        std::string path;
+        bool mod = false;
+        double impedance = 560.0;
+        double rangeDb = 60.0;
+        int numThreads = 0;
+    };
+
+    bool parseOptions (int argc, char* argv[], Options& options)
+    {
+        std::vector<std::string> positional;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg (argv[i]);
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--mod")
+                options.mod = true;
+            else if (arg == "--impedance" && hasValue)
+                options.impedance = std::strtod (argv[++i], nullptr);
+            else if (arg == "--range" && hasValue)
+                options.rangeDb = std::strtod (argv[++i], nullptr);
+            else if (arg == "--threads" && hasValue)
+                options.numThreads = std::atoi (argv[++i]);
+            else if (arg.rfind ("--", 0) != 0)
+                positional.push_back (arg);
+            else
+                return false;
+        }
+
+        if (positional.size() != 2 || ! (options.impedance > 0.0) || ! (options.rangeDb > 0.0))
+            return false;
+
+        options.measurementDirectory = positional[0];
+        options.path = positional[1];
+        return true;
+    }
+
+    /** Frequency and dB per line, split by commas or whitespace; header and comment lines are skipped */
+    bool loadMeasurement (const std::string& path, ComponentFit::Measurement& measurement)
+    {
+        std::ifstream file (path);
+
+        if (! file)
+            return false;
+
+        for (std::string line; std::getline (file, line);)
+        {
+            for (auto& c : line)
+                if (c == ',' || c == ';')
+                    c = ' ';
+
+            std::istringstream fields (line);
+            double frequency = 0.0, db = 0.0;
+
+            if (fields >> frequency >> db)
+            {
+                measurement.frequencies.push_back (frequency);
+                measurement.magnitudesDb.push_back (db);
+            }
+        }
+
+        return ! measurement.frequencies.empty();
+    }
+
+    const char* getName (Section section)
+    {
+        return section == Section::highPass ? "hp" : "lp";
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    Options options;
+
+    if (! parseOptions (argc, argv, options))
+    {
+        std::fprintf (stderr, "usage: %s measurements/ fitted.txt [--mod] [--impedance 560] [--range 60] [--threads N]\n", argv[0]);
+        return 1;
+    }
+
+    RCA_MK2_SEF::KnobTable table;
+    std::vector<ComponentFit::Problem> problems;
+
+    for (auto section : { Section::highPass, Section::lowPass })
+    {
+        for (int pos = 1; pos <= numKnobPositions; ++pos)
+        {
+            const auto& nominal = (section == Section::highPass ? table.highPass : table.lowPass)[(size_t) pos - 1];
+            const auto path = options.measurementDirectory + "/" + getName (section) + std::to_string (pos) + ".csv";
+
+            ComponentFit::Problem problem;
+            problem.section = section;
+            problem.position = pos;
+            problem.C = nominal.C;
+            problem.L = nominal.L;
+            problem.impedance = options.impedance;
+            problem.mod = options.mod;
+            problem.fitValues = (section == Section::highPass ? pos != 1 : pos != numKnobPositions);
+            problem.rangeDb = options.rangeDb;
+
+            if (! loadMeasurement (path, problem.measurement))
+            {
+                std::printf ("%s %2d: no measurement, keeping the built-in values\n", getName (section), pos);
+                continue;
+            }
+
+            problems.push_back (std::move (problem));
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = ComponentFit::fitAll (problems, options.numThreads);
+    const auto end = std::chrono::steady_clock::now();
+
+    std::string comment = "Fitted by Tools/ComponentFit from " + options.measurementDirectory
+                        + (options.mod ? ", MOD on" : ", MOD off") + "\n"
+                        + "Rin and Rt are what each position was measured between, for reference only\n";
+
+    for (size_t i = 0; i < problems.size(); ++i)
+    {
+        const auto& problem = problems[i];
+        const auto& result = results[i];
+        auto& entry = (problem.section == Section::highPass ? table.highPass : table.lowPass)[(size_t) problem.position - 1];
+
+        if (problem.fitValues)
+        {
+            entry.C = (float) result.C;
+            entry.L = (float) result.L;
+            entry.cutoff = result.getCutoff (problem.section);
+        }
+
+        char line[256];
+        std::snprintf (line, sizeof (line), "%s %2d: C %.4g F, L %.4g H, Rin %.1f, Rt %.1f ohms, rms %.3f dB, max %.3f dB over %d points, %d iterations%s",
+                       getName (problem.section), problem.position, (double) entry.C, (double) entry.L, result.Rin, result.Rt,
+                       result.rmsErrorDb, result.maxErrorDb, result.numPoints, result.iterations,
+                       result.converged ? "" : " (not converged)");
+
+        std::printf ("%s\n", line);
+        comment += std::string (line) + "\n";
+    }
+
+    std::ofstream file (options.path);
+    file << RCA_MK2_SEF::writeKnobTable (table, comment);
+
+    if (! file.good())
+    {
+        std::fprintf (stderr, "can't write %s\n", options.path.c_str());
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double> (end - start).count();
+    std::printf ("%d fits in %.1f ms, written to %s\n", (int) problems.size(), seconds * 1000.0, options.path.c_str());
+
+    return 0;
+}
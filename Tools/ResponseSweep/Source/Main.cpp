@@ -0,0 +1,316 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Magnitude responses for every HP x LP knob combination (11 x 11), both MOD
+    switches and a grid of input and output impedances, spread over all cores,
+    written out as one .npy array for validation in Python:
+
+        "RCA MK II Response Sweep" sweep.npy [--rate 48000] [--impedances 560,1000]
+                                             [--threads N] [--analytic] [--analog-matched]
+
+    The array's shape is (HP knob, LP knob, HP mod, LP mod, Rin, Rt, bin), with
+    bins k * fs / 2^fftOrder up to Nyquist. sweep.json alongside it has every
+    axis: knob cutoffs, impedances, frequencies and how it was computed.
+
+    By default each response is the FFT of the ladder's impulse response, just
+    as ResponseAnalyser shows it. --analytic evaluates the transfer function at
+    the same frequencies instead. Each worker has its own filter and FFT and
+    takes the next setting as soon as it's done with the last, writing straight
+    into its own rows of the result.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/ResponseAnalyser.h"
+#include "../../../Source/RCA_OfflineRender.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    constexpr int fftOrder = ResponseAnalyser::fftOrder;
+    constexpr int fftLength = 1 << fftOrder;
+    constexpr int numBins = fftLength / 2 + 1;
+
+    constexpr int numKnobPositions = 11;
+
+    struct Options
+    {
+        std::string path;
+        float sampleRate = 48000.f;
+        std::vector<float> impedances { 560.f };
+        int numThreads = 0;
+        bool analytic = false;
+        bool analogMatched = false;
+    };
+
+    bool parseList (const char* text, std::vector<float>& values)
+    {
+        values.clear();
+
+        for (const char* p = text; *p != '\0';)
+        {
+            char* end = nullptr;
+            const float value = std::strtof (p, &end);
+
+            if (end == p || ! (value > 0.f))
+                return false;
+
+            values.push_back (value);
+            p = *end == ',' ? end + 1 : end;
+
+            if (*end != ',' && *end != '\0')
+                return false;
+        }
+
+        return ! values.empty();
+    }
+
+    bool parseOptions (int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg (argv[i]);
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--rate" && hasValue)
+                options.sampleRate = std::strtof (argv[++i], nullptr);
+            else if (arg == "--impedances" && hasValue)
+            {
+                if (! parseList (argv[++i], options.impedances))
+                    return false;
+            }
+            else if (arg == "--threads" && hasValue)
+                options.numThreads = std::atoi (argv[++i]);
+            else if (arg == "--analytic")
+                options.analytic = true;
+            else if (arg == "--analog-matched")
+                options.analogMatched = true;
+            else if (arg.rfind ("--", 0) != 0 && options.path.empty())
+                options.path = arg;
+            else
+                return false;
+        }
+
+        return ! options.path.empty() && options.sampleRate > 0.f;
+    }
+
+    /** Row-major over (HP knob, LP knob, HP mod, LP mod, Rin, Rt) */
+    struct Grid
+    {
+        explicit Grid (const Options& o) : options (o) {}
+
+        std::vector<int> getShape() const
+        {
+            const int numImpedances = (int) options.impedances.size();
+            return { numKnobPositions, numKnobPositions, 2, 2, numImpedances, numImpedances, numBins };
+        }
+
+        int getNumSettings() const
+        {
+            const int numImpedances = (int) options.impedances.size();
+            return numKnobPositions * numKnobPositions * 4 * numImpedances * numImpedances;
+        }
+
+        FilterSettings getSettings (int index) const
+        {
+            const int numImpedances = (int) options.impedances.size();
+
+            FilterSettings s;
+            s.sampleRate = options.sampleRate;
+            s.highPassContinuous = false;
+            s.lowPassContinuous = false;
+            s.analogMatched = options.analogMatched;
+
+            s.outputImpedance = options.impedances[(size_t) (index % numImpedances)];
+            index /= numImpedances;
+            s.inputImpedance = options.impedances[(size_t) (index % numImpedances)];
+            index /= numImpedances;
+            s.lowPassMod = index % 2;
+            index /= 2;
+            s.highPassMod = index % 2;
+            index /= 2;
+            s.lowPassKnobPos = index % numKnobPositions + 1;
+            index /= numKnobPositions;
+            s.highPassKnobPos = index + 1;
+
+            return s;
+        }
+
+        const Options& options;
+    };
+
+    float getBinFrequency (int bin, float sampleRate)
+    {
+        return float (bin) * sampleRate / float (fftLength);
+    }
+
+    //==============================================================================
+    /** Little-endian float32, which is what every platform this builds on writes */
+    bool writeNpy (const std::string& path, const std::vector<int>& shape, const std::vector<float>& data)
+    {
+        std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': (";
+
+        for (auto size : shape)
+            header += std::to_string (size) + ", ";
+
+        header += "), }";
+
+        // magic, version and length take 10 bytes; the whole header pads out to a multiple of 64
+        const size_t total = (10 + header.size() + 1 + 63) / 64 * 64;
+        header.append (total - 10 - header.size() - 1, ' ');
+        header += '\n';
+
+        std::FILE* file = std::fopen (path.c_str(), "wb");
+
+        if (file == nullptr)
+            return false;
+
+        const unsigned char preamble[] = { 0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0,
+                                           (unsigned char) (header.size() & 0xff), (unsigned char) (header.size() >> 8) };
+
+        bool ok = std::fwrite (preamble, 1, sizeof (preamble), file) == sizeof (preamble)
+               && std::fwrite (header.data(), 1, header.size(), file) == header.size()
+               && std::fwrite (data.data(), sizeof (float), data.size(), file) == data.size();
+
+        ok = std::fclose (file) == 0 && ok;
+        return ok;
+    }
+
+    bool writeJson (const std::string& path, const std::string& dataName, const Options& options, const Grid& grid)
+    {
+        std::FILE* file = std::fopen (path.c_str(), "w");
+
+        if (file == nullptr)
+            return false;
+
+        auto writeList = [&] (const char* name, int size, auto&& value, const char* after)
+        {
+            std::fprintf (file, "    \"%s\": [", name);
+
+            for (int i = 0; i < size; ++i)
+                std::fprintf (file, "%s%.9g", i > 0 ? ", " : "", (double) value (i));
+
+            std::fprintf (file, "]%s\n", after);
+        };
+
+        const auto shape = grid.getShape();
+
+        std::fprintf (file, "{\n");
+        std::fprintf (file, "    \"data\": \"%s\",\n", dataName.c_str());
+        writeList ("shape", (int) shape.size(), [&] (int i) { return shape[(size_t) i]; }, ",");
+        std::fprintf (file, "    \"axes\": [\"highPassKnob\", \"lowPassKnob\", \"highPassMod\", \"lowPassMod\", "
+                            "\"inputImpedance\", \"outputImpedance\", \"frequency\"],\n");
+        std::fprintf (file, "    \"sampleRate\": %.9g,\n", (double) options.sampleRate);
+        std::fprintf (file, "    \"method\": \"%s\",\n", options.analytic ? "analytic" : "impulse response FFT");
+        std::fprintf (file, "    \"engine\": \"%s\",\n", options.analogMatched ? "alpha" : "wdfTree");
+        writeList ("highPassKnob", numKnobPositions, [] (int i) { return i + 1; }, ",");
+        writeList ("highPassKnobCutoff", numKnobPositions, [] (int i) { return RCA_MK2_SEF::highPassKnobPositions[(size_t) i].cutoff; }, ",");
+        writeList ("lowPassKnob", numKnobPositions, [] (int i) { return i + 1; }, ",");
+        writeList ("lowPassKnobCutoff", numKnobPositions, [] (int i) { return RCA_MK2_SEF::lowPassKnobPositions[(size_t) i].cutoff; }, ",");
+        writeList ("highPassMod", 2, [] (int i) { return i; }, ",");
+        writeList ("lowPassMod", 2, [] (int i) { return i; }, ",");
+        writeList ("inputImpedance", (int) options.impedances.size(), [&] (int i) { return options.impedances[(size_t) i]; }, ",");
+        writeList ("outputImpedance", (int) options.impedances.size(), [&] (int i) { return options.impedances[(size_t) i]; }, ",");
+        writeList ("frequency", numBins, [&] (int i) { return getBinFrequency (i, options.sampleRate); }, "");
+        std::fprintf (file, "}\n");
+
+        return std::fclose (file) == 0;
+    }
+
+    //==============================================================================
+    void sweep (const Options& options, const Grid& grid, std::vector<float>& result)
+    {
+        const int numSettings = grid.getNumSettings();
+        const int numThreads = options.numThreads > 0 ? options.numThreads
+                                                      : (int) std::max (1u, std::thread::hardware_concurrency());
+
+        std::atomic<int> next { 0 };
+
+        OfflineRender::runOnThreads (std::min (numThreads, numSettings), [&] (int)
+        {
+            RCA_MK2_SEF filter;
+            filter.prepare (options.sampleRate);
+
+            juce::dsp::FFT fft { fftOrder };
+            std::vector<float> scratch ((size_t) fftLength * 2);
+
+            // bin 0 is left out of the analytic response: the series capacitors block DC, so it's 0
+            std::vector<float> frequencies ((size_t) numBins - 1);
+
+            for (int bin = 1; bin < numBins; ++bin)
+                frequencies[(size_t) bin - 1] = getBinFrequency (bin, options.sampleRate);
+
+            for (int index = next++; index < numSettings; index = next++)
+            {
+                grid.getSettings (index).applyTo (filter);
+                float* row = result.data() + (size_t) index * numBins;
+
+                if (options.analytic)
+                {
+                    row[0] = 0.f;
+                    filter.computeMagnitudeResponse (frequencies.data(), row + 1, numBins - 1);
+                    continue;
+                }
+
+                filter.computeImpulseResponse (scratch.data(), fftLength);
+                std::fill (scratch.begin() + fftLength, scratch.end(), 0.f);
+
+                fft.performFrequencyOnlyForwardTransform (scratch.data(), true);
+                std::copy (scratch.begin(), scratch.begin() + numBins, row);
+            }
+        });
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    Options options;
+
+    if (! parseOptions (argc, argv, options))
+    {
+        std::fprintf (stderr, "usage: %s sweep.npy [--rate 48000] [--impedances 560,1000] [--threads N] "
+                              "[--analytic] [--analog-matched]\n", argv[0]);
+        return 1;
+    }
+
+    const Grid grid (options);
+    std::vector<float> result ((size_t) grid.getNumSettings() * numBins);
+
+    const auto start = std::chrono::steady_clock::now();
+    sweep (options, grid, result);
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto dot = options.path.find_last_of ('.');
+    const auto slash = options.path.find_last_of ("/\\");
+    const bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    const auto jsonPath = (hasExtension ? options.path.substr (0, dot) : options.path) + ".json";
+    const auto dataName = slash == std::string::npos ? options.path : options.path.substr (slash + 1);
+
+    if (! writeNpy (options.path, grid.getShape(), result) || ! writeJson (jsonPath, dataName, options, grid))
+    {
+        std::fprintf (stderr, "can't write %s\n", options.path.c_str());
+        return 1;
+    }
+
+    const double seconds = std::chrono::duration<double> (end - start).count();
+
+    std::printf ("%d responses x %d bins in %.2f s (%.0f responses/s), written to %s and %s\n",
+                 grid.getNumSettings(), numBins, seconds, grid.getNumSettings() / seconds,
+                 options.path.c_str(), jsonPath.c_str());
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Runs a WAV file of any length through RCA_MK2_SEF, outside a plugin host:
+
+        "RCA MK II Stream Render" in.wav out.wav [--hp 300 | --hp-knob 4] [--lp 3000 | --lp-knob 8]
+                                  [--no-mod] [--impedance 560,560] [--block 65536] [--blocks 8]
+
+    The input is memory-mapped rather than read through a stream, so the
+    read stage only converts samples straight out of the mapped pages into
+    the pipeline's blocks (see RCA_StreamRender.h) while the OS pages the
+    file in. Each channel has its own filter on Engine::precise, as the
+    plugin uses for a bounce. The output has the input's rate, channels and
+    sample format.
+
+    The time each stage spent working is printed at the end: whichever has
+    the lowest throughput is what the render is waiting on.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/ResponseAnalyser.h"
+#include "../../../Source/RCA_StreamRender.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    struct Options
+    {
+        std::string inputPath, outputPath;
+        FilterSettings settings;
+        int blockSize = 1 << 16;
+        int numBlocks = 8;
+    };
+
+    bool parseImpedances (const char* text, FilterSettings& settings)
+    {
+        char* end = nullptr;
+        settings.inputImpedance = std::strtof (text, &end);
+        settings.outputImpedance = *end == ',' ? std::strtof (end + 1, &end) : settings.inputImpedance;
+
+        return *end == '\0' && settings.inputImpedance > 0.f && settings.outputImpedance > 0.f;
+    }
+
+    bool parseOptions (int argc, char* argv[], Options& options)
+    {
+        std::vector<std::string> positional;
+        auto& s = options.settings;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg (argv[i]);
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--hp" && hasValue)
+            {
+                s.highPassContinuous = true;
+                s.highPassCutoff = std::strtof (argv[++i], nullptr);
+            }
+            else if (arg == "--hp-knob" && hasValue)
+            {
+                s.highPassContinuous = false;
+                s.highPassKnobPos = std::atoi (argv[++i]);
+            }
+            else if (arg == "--lp" && hasValue)
+            {
+                s.lowPassContinuous = true;
+                s.lowPassCutoff = std::strtof (argv[++i], nullptr);
+            }
+            else if (arg == "--lp-knob" && hasValue)
+            {
+                s.lowPassContinuous = false;
+                s.lowPassKnobPos = std::atoi (argv[++i]);
+            }
+            else if (arg == "--no-mod")
+            {
+                s.highPassMod = 0;
+                s.lowPassMod = 0;
+            }
+            else if (arg == "--impedance" && hasValue)
+            {
+                if (! parseImpedances (argv[++i], s))
+                    return false;
+            }
+            else if (arg == "--block" && hasValue)
+                options.blockSize = std::atoi (argv[++i]);
+            else if (arg == "--blocks" && hasValue)
+                options.numBlocks = std::atoi (argv[++i]);
+            else if (arg.rfind ("--", 0) != 0)
+                positional.push_back (arg);
+            else
+                return false;
+        }
+
+        if (positional.size() != 2 || options.blockSize <= 0 || options.numBlocks < 3)
+            return false;
+
+        if (s.highPassKnobPos < 1 || s.highPassKnobPos > 11 || s.lowPassKnobPos < 1 || s.lowPassKnobPos > 11)
+            return false;
+
+        if (! (s.highPassCutoff > 0.f) || ! (s.lowPassCutoff > 0.f))
+            return false;
+
+        options.inputPath = positional[0];
+        options.outputPath = positional[1];
+        return true;
+    }
+
+    void printStage (const char* name, const StreamRender::StageStats& stage, double wallSeconds)
+    {
+        std::printf ("  %-8s %8.2f s working, %8.2f s waiting, %8.2f Mframes/s while working (%3.0f%% of the run)\n",
+                     name, stage.busySeconds, stage.waitSeconds, stage.getFramesPerSecond() / 1.0e6,
+                     wallSeconds > 0.0 ? 100.0 * stage.busySeconds / wallSeconds : 0.0);
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    Options options;
+
+    if (! parseOptions (argc, argv, options))
+    {
+        std::fprintf (stderr, "usage: %s in.wav out.wav [--hp 300 | --hp-knob 4] [--lp 3000 | --lp-knob 8] "
+                              "[--no-mod] [--impedance 560,560] [--block 65536] [--blocks 8]\n", argv[0]);
+        return 1;
+    }
+
+    const auto inputFile = juce::File::getCurrentWorkingDirectory().getChildFile (options.inputPath);
+    const auto outputFile = juce::File::getCurrentWorkingDirectory().getChildFile (options.outputPath);
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader (wav.createMemoryMappedReader (inputFile));
+
+    // address space is plentiful on a 64-bit machine; only the pages being read take memory
+    if (reader == nullptr || ! reader->mapEntireFile())
+    {
+        std::fprintf (stderr, "can't map %s as a WAV file\n", options.inputPath.c_str());
+        return 1;
+    }
+
+    const int numChannels = (int) reader->numChannels;
+    const int64_t length = reader->lengthInSamples;
+
+    if (inputFile == outputFile || ! outputFile.deleteFile())
+    {
+        std::fprintf (stderr, "can't replace %s\n", options.outputPath.c_str());
+        return 1;
+    }
+
+    auto stream = std::make_unique<juce::FileOutputStream> (outputFile, 1 << 20);
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    if (stream->openedOk())
+        writer.reset (wav.createWriterFor (stream.get(), reader->sampleRate, (unsigned int) numChannels,
+                                           (int) reader->bitsPerSample, reader->metadataValues, 0));
+
+    if (writer == nullptr)
+    {
+        std::fprintf (stderr, "can't write %s\n", options.outputPath.c_str());
+        return 1;
+    }
+
+    // the writer owns it now
+    stream.release();
+
+    std::vector<std::unique_ptr<RCA_MK2_SEF>> filters;
+    options.settings.sampleRate = reader->sampleRate;
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        filters.push_back (std::make_unique<RCA_MK2_SEF>());
+        filters.back()->prepare ((float) reader->sampleRate);
+        options.settings.applyTo (*filters.back());
+        filters.back()->setEngine (RCA_MK2_SEF::Engine::precise);
+    }
+
+    StreamRender::Pipeline pipeline (numChannels, options.blockSize, options.numBlocks);
+
+    const bool ok = pipeline.run (
+        [&] (int64_t start, float* const* channels, int maxFrames)
+        {
+            const int numFrames = (int) std::min<int64_t> (maxFrames, length - start);
+
+            if (numFrames <= 0)
+                return 0;
+
+            return reader->read (channels, numChannels, start, numFrames) ? numFrames : -1;
+        },
+        [&] (float* const* channels, int numFrames)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                auto& filter = *filters[(size_t) c];
+                float* data = channels[c];
+
+                for (int n = 0; n < numFrames; ++n)
+                    data[n] = filter.processSample (data[n]);
+            }
+        },
+        [&] (const float* const* channels, int numFrames)
+        {
+            return writer->writeFromFloatArrays (channels, numChannels, numFrames);
+        });
+
+    // flushes the rest out and fills in the header's sizes
+    writer.reset();
+
+    if (! ok)
+    {
+        std::fprintf (stderr, "render failed, %s is incomplete\n", options.outputPath.c_str());
+        return 1;
+    }
+
+    const auto& stats = pipeline.getStats();
+    const double seconds = stats.wallSeconds;
+
+    std::printf ("%lld frames x %d channels in %.2f s (%.1fx realtime), written to %s\n",
+                 (long long) length, numChannels, seconds,
+                 seconds > 0.0 ? (double) length / reader->sampleRate / seconds : 0.0,
+                 options.outputPath.c_str());
+
+    printStage ("read", stats.read, seconds);
+    printStage ("filter", stats.process, seconds);
+    printStage ("write", stats.write, seconds);
+
+    return 0;
+}
@@ -0,0 +1,445 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026
+    Author:  Gus Anthon
+
+    Turns a WdfNetlist circuit into straight-line C++: one function for the
+    adaptor coefficients and one for a sample, with every wave a local and
+    every element a named member. With no netlist it writes the RCA ladder,
+    which is Source/RCA_GeneratedLadder.h; run it again, and commit the result,
+    after changing WdfNetlist::rcaLadder:
+
+        "RCA MK II WDF Codegen" ../../Source/RCA_GeneratedLadder.h [netlist.txt] [namespace]
+
+    With --check in front it writes nothing, and fails if the header isn't
+    exactly what it would write. check_generated.sh builds the tool and runs
+    that against the header; the plugin's Xcode build runs it first.
+
+    Like the rest of the tree, the header has CRLF line endings.
+
+    The arithmetic is chowdsp's, in the same order, so the kernel gives the
+    same samples as the wdft tree the netlist describes. The coefficients only
+    work out the port resistances and conductances something actually uses,
+    with 2 fs taken out once (a factor of 2 never changes the rounding).
+
+  ==============================================================================
+*/
+
+#include "../../../Source/RCA_WdfNetlist.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    using Circuit = WdfNetlist::Circuit;
+    using Kind = Circuit::Kind;
+
+    bool isLeaf (Kind kind)     { return kind == Kind::resistor || kind == Kind::capacitor || kind == Kind::inductor; }
+    bool isReactive (Kind kind) { return kind == Kind::capacitor || kind == Kind::inductor; }
+
+    /** Shortest text that reads back as exactly value, as a float literal */
+    std::string floatLiteral (float value)
+    {
+        char text[32];
+
+        for (int digits = 6; digits <= 9; ++digits)
+        {
+            std::snprintf (text, sizeof (text), "%.*g", digits, (double) value);
+
+            if (std::strtof (text, nullptr) == value)
+                break;
+        }
+
+        std::string literal (text);
+
+        if (literal.find_first_of (".e") == std::string::npos)
+            literal += ".0";
+
+        return literal + "f";
+    }
+
+    struct Generator
+    {
+        explicit Generator (const Circuit& c) : circuit (c)
+        {
+            for (int i = 0; i < circuit.getNumNodes(); ++i)
+                nodes.push_back (circuit.getNodeInfo (i));
+
+            haveR.resize (nodes.size());
+            haveG.resize (nodes.size());
+            haveReflected.resize (nodes.size());
+        }
+
+        const std::string& name (int index) const { return nodes[(size_t) index].name; }
+
+        //==============================================================================
+        /** A port resistance or conductance, written out the first time it's asked for */
+        std::string resistance (int index)
+        {
+            const auto& node = nodes[(size_t) index];
+
+            if (! haveR[(size_t) index])
+            {
+                if (node.kind == Kind::resistor)
+                    line ("const float R_" + node.name + " = v." + node.name + ";");
+                else if (node.kind == Kind::capacitor)
+                    line ("const float R_" + node.name + " = 1.f / (v." + node.name + " * twoFs);");
+                else if (node.kind == Kind::inductor)
+                    line ("const float R_" + node.name + " = v." + node.name + " * twoFs;");
+                else
+                    line ("const float R_" + node.name + " = 1.f / G_" + node.name + ";");
+
+                haveR[(size_t) index] = true;
+            }
+
+            return "R_" + node.name;
+        }
+
+        std::string conductance (int index)
+        {
+            if (! haveG[(size_t) index])
+            {
+                const auto R = resistance (index);
+                line ("const float G_" + name (index) + " = 1.f / " + R + ";");
+                haveG[(size_t) index] = true;
+            }
+
+            return "G_" + name (index);
+        }
+
+        void writeCoefficients()
+        {
+            bool anyReactive = false;
+
+            for (const auto& node : nodes)
+                anyReactive = anyReactive || isReactive (node.kind);
+
+            if (anyReactive)
+                line ("const float twoFs = 2.f * sampleRate;");
+
+            line ("");
+            line ("Coefficients k;");
+
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                const auto& node = nodes[i];
+
+                if (isLeaf (node.kind))
+                    continue;
+
+                line ("");
+
+                if (node.kind == Kind::series)
+                {
+                    const auto R1 = resistance (node.port1);
+                    const auto R2 = resistance (node.port2);
+                    line ("const float R_" + node.name + " = " + R1 + " + " + R2 + ";");
+                    line ("k." + node.name + " = " + R1 + " / R_" + node.name + ";");
+                    haveR[i] = true;
+                }
+                else
+                {
+                    const auto G1 = conductance (node.port1);
+                    const auto G2 = conductance (node.port2);
+                    line ("const float G_" + node.name + " = " + G1 + " + " + G2 + ";");
+                    line ("k." + node.name + " = " + G1 + " / G_" + node.name + ";");
+                    haveG[i] = true;
+                }
+            }
+
+            if (! anyReactive)
+                line ("(void) sampleRate;");
+
+            line ("");
+            line ("return k;");
+        }
+
+        //==============================================================================
+        /** A reflected wave, with a leaf's written out just before its adaptor needs it */
+        std::string reflected (int index)
+        {
+            const auto& node = nodes[(size_t) index];
+
+            if (! haveReflected[(size_t) index])
+            {
+                if (node.kind == Kind::capacitor)
+                    line ("const float b_" + node.name + " = z." + node.name + ";");
+                else if (node.kind == Kind::inductor)
+                    line ("const float b_" + node.name + " = -z." + node.name + ";");
+                else
+                    line ("const float b_" + node.name + " = 0.f;");
+
+                haveReflected[(size_t) index] = true;
+            }
+
+            return "b_" + node.name;
+        }
+
+        /** Incident waves nobody reads are left out: a resistor's, unless it's the output */
+        bool needsIncident (int index) const
+        {
+            return nodes[(size_t) index].kind != Kind::resistor || index == circuit.getOutputIndex();
+        }
+
+        void writeProcessSample()
+        {
+            line ("// reflected, from the leaves up");
+
+            for (size_t i = 0; i < nodes.size(); ++i)
+            {
+                const auto& node = nodes[i];
+
+                if (isLeaf (node.kind))
+                    continue;
+
+                const auto b1 = reflected (node.port1);
+                const auto b2 = reflected (node.port2);
+
+                if (node.kind == Kind::series)
+                {
+                    line ("const float b_" + node.name + " = -(" + b1 + " + " + b2 + ");");
+                }
+                else
+                {
+                    line ("const float d_" + node.name + " = " + b2 + " - " + b1 + ";");
+                    line ("const float b_" + node.name + " = " + b2 + " - k." + node.name + " * d_" + node.name + ";");
+                }
+
+                haveReflected[i] = true;
+            }
+
+            const int root = circuit.getRootIndex();
+            const auto bRoot = reflected (root);
+
+            line ("");
+            line ("// the ideal source, then incident from the root down");
+            line ("const float a_" + name (root) + " = -" + bRoot + " + 2.f * x;");
+
+            for (auto i = (int) nodes.size() - 1; i >= 0; --i)
+            {
+                const auto& node = nodes[(size_t) i];
+
+                if (isLeaf (node.kind))
+                    continue;
+
+                const auto& p1 = name (node.port1);
+                const auto& p2 = name (node.port2);
+                const auto a = "a_" + node.name;
+
+                line ("");
+
+                if (node.kind == Kind::series)
+                {
+                    // port 2's wave is worked out from port 1's, so port 1's is always needed
+                    line ("const float a_" + p1 + " = b_" + p1 + " - k." + node.name + " * (" + a + " + b_" + p1 + " + b_" + p2 + ");");
+
+                    if (needsIncident (node.port2))
+                        line ("const float a_" + p2 + " = -(" + a + " + a_" + p1 + ");");
+                }
+                else
+                {
+                    line ("const float a_" + p2 + " = b_" + node.name + " - b_" + p2 + " + " + a + ";");
+
+                    if (needsIncident (node.port1))
+                        line ("const float a_" + p1 + " = a_" + p2 + " + d_" + node.name + ";");
+                }
+            }
+
+            line ("");
+            line ("// each reactive element keeps its incident wave for next time");
+
+            for (const auto& node : nodes)
+                if (isReactive (node.kind))
+                    line ("z." + node.name + " = a_" + node.name + ";");
+
+            const auto& output = name (circuit.getOutputIndex());
+
+            line ("");
+            line ("return (a_" + output + " + b_" + output + ") * 0.5f;");
+        }
+
+        //==============================================================================
+        void writeMembers (bool leaves, bool reactiveOnly, bool withValues)
+        {
+            for (const auto& node : nodes)
+            {
+                if (isLeaf (node.kind) != leaves || (reactiveOnly && ! isReactive (node.kind)))
+                    continue;
+
+                line ("float " + node.name + " = " + (withValues ? floatLiteral (node.value) : std::string ("0.f")) + ";");
+            }
+        }
+
+        void line (const std::string& text)
+        {
+            code += text.empty() ? "\n" : indent + text + "\n";
+        }
+
+        const Circuit& circuit;
+        std::vector<Circuit::NodeInfo> nodes;
+        std::vector<bool> haveR, haveG, haveReflected;
+
+        std::string code, indent;
+    };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const bool isCheck = argc > 1 && std::string (argv[1]) == "--check";
+
+    if (isCheck)
+    {
+        --argc;
+        ++argv;
+
+        if (argc < 2)
+        {
+            std::fprintf (stderr, "--check needs the header to compare with\n");
+            return 1;
+        }
+    }
+
+    std::string netlist = WdfNetlist::rcaLadder;
+    std::string source = "WdfNetlist::rcaLadder";
+    const std::string nameSpace = argc > 3 ? argv[3] : "GeneratedLadder";
+
+    if (argc > 2)
+    {
+        std::ifstream file (argv[2]);
+
+        if (! file)
+        {
+            std::fprintf (stderr, "can't read %s\n", argv[2]);
+            return 1;
+        }
+
+        std::stringstream text;
+        text << file.rdbuf();
+        netlist = text.str();
+        source = argv[2];
+    }
+
+    Circuit circuit;
+    std::string error;
+
+    if (! circuit.compile (netlist, error))
+    {
+        std::fprintf (stderr, "%s: %s\n", source.c_str(), error.c_str());
+        return 1;
+    }
+
+    Generator g (circuit);
+    auto& code = g.code;
+    g.indent = "    ";
+
+    code += "/*\n"
+            "  ==============================================================================\n"
+            "\n"
+            "    RCA_GeneratedLadder.h\n"
+            "\n"
+            "    Generated by Tools/WdfCodegen from " + source + ".\n"
+            "    Don't edit by hand, run it again.\n"
+            "\n"
+            "  ==============================================================================\n"
+            "*/\n"
+            "\n"
+            "#pragma once\n"
+            "\n"
+            "\n"
+            "namespace " + nameSpace + "\n"
+            "{\n";
+
+    g.line ("/** Resistances, capacitances and inductances, starting at the netlist's */");
+    g.line ("struct Values");
+    g.line ("{");
+    g.indent = "        ";
+    g.writeMembers (true, false, true);
+    g.indent = "    ";
+    g.line ("};");
+    g.line ("");
+    g.line ("/** Port 1's reflection coefficient, per adaptor */");
+    g.line ("struct Coefficients");
+    g.line ("{");
+    g.indent = "        ";
+    g.writeMembers (false, false, false);
+    g.indent = "    ";
+    g.line ("};");
+    g.line ("");
+    g.line ("/** Each reactive element's last incident wave */");
+    g.line ("struct State");
+    g.line ("{");
+    g.indent = "        ";
+    g.writeMembers (true, true, false);
+    g.indent = "    ";
+    g.line ("};");
+    g.line ("");
+    g.line ("inline Coefficients computeCoefficients (const Values& v, float sampleRate) noexcept");
+    g.line ("{");
+    g.indent = "        ";
+    g.writeCoefficients();
+    g.indent = "    ";
+    g.line ("}");
+    g.line ("");
+    g.line ("inline float processSample (State& z, const Coefficients& k, float x) noexcept");
+    g.line ("{");
+    g.indent = "        ";
+    g.writeProcessSample();
+    g.indent = "    ";
+    g.line ("}");
+
+    code += "}\n";
+
+    if (argc < 2)
+    {
+        std::fputs (code.c_str(), stdout);
+        return 0;
+    }
+
+    std::string crlf;
+
+    for (auto c : code)
+    {
+        if (c == '\n')
+            crlf += '\r';
+
+        crlf += c;
+    }
+
+    if (isCheck)
+    {
+        std::ifstream file (argv[1], std::ios::binary);
+        std::stringstream existing;
+        existing << file.rdbuf();
+
+        if (! file.is_open() || existing.str() != crlf)
+        {
+            std::fprintf (stderr, "%s is out of date with %s: run Tools/WdfCodegen again and commit the result\n",
+                          argv[1], source.c_str());
+            return 1;
+        }
+
+        return 0;
+    }
+
+    std::FILE* out = std::fopen (argv[1], "wb");
+
+    if (out == nullptr)
+    {
+        std::fprintf (stderr, "can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    std::fputs (crlf.c_str(), out);
+    std::fclose (out);
+
+    return 0;
+}
@@ -0,0 +1,18 @@
+#!/bin/sh
+#
+#   check_generated.sh
+#   Created: 19 Oct 2026
+#   Author:  Gus Anthon
+#
+#   Builds the codegen tool (it only needs the standard library) and fails
+#   if Source/RCA_GeneratedLadder.h isn't what it writes for the netlist in
+#   Source/RCA_WdfNetlist.h. The plugin's Xcode build runs this first.
+
+set -e
+
+here="$(cd "$(dirname "$0")" && pwd)"
+build="${TMPDIR:-/tmp}/rca-wdf-codegen-check"
+
+mkdir -p "$build"
+"${CXX:-c++}" -std=c++17 -O1 -o "$build/codegen" "$here/Source/Main.cpp"
+"$build/codegen" --check "$here/../../Source/RCA_GeneratedLadder.h"